@@ -0,0 +1,45 @@
+#pragma once
+
+#include <pebble.h>
+
+//! @internal
+//! Pixel access shared by the modules that draw into 1-bit and 8-bit bitmaps directly.
+
+//! @internal
+//! Alpha occupies the top two bits of an 8-bit pixel
+#define PIXEL_8BIT_ALPHA_MASK 0xc0
+
+//! @internal
+//! Converts a color to the value stored for it in a bitmap of the given format: opaque for
+//! 8-bit, and its lowest bit for 1-bit.
+static __inline__ uint8_t gbitmap_pixel_color(GBitmapFormat format, uint8_t color) {
+  return (format == GBitmapFormat8Bit) ? (color | PIXEL_8BIT_ALPHA_MASK) : (color & 1);
+}
+
+//! @internal
+//! Reads pixel x of a row of a 1-bit bitmap.
+static __inline__ uint8_t gbitmap_pixel_get_1bit(const uint8_t *row, int32_t x) {
+  return (row[x >> 3] >> (x & 7)) & 1;
+}
+
+//! @internal
+//! Sets pixel x of a row of a 1-bit bitmap if value is not 0, and clears it otherwise.
+static __inline__ void gbitmap_pixel_set_1bit(uint8_t *row, int32_t x, uint8_t value) {
+  if (value) {
+    row[x >> 3] |= (1 << (x & 7));
+  } else {
+    row[x >> 3] &= ~(1 << (x & 7));
+  }
+}
+
+//! @internal
+//! Writes pixel x of a row of a 1-bit or 8-bit bitmap.
+//! @param value Value from gbitmap_pixel_color for the format of the bitmap
+static __inline__ void gbitmap_pixel_plot(uint8_t *row, GBitmapFormat format, int32_t x,
+                                          uint8_t value) {
+  if (format == GBitmapFormat8Bit) {
+    row[x] = value;
+  } else {
+    gbitmap_pixel_set_1bit(row, x, value);
+  }
+}
@@ -0,0 +1,162 @@
+#include <pebble.h>
+
+#include "gbitmap_transform.h"
+#include "gbitmap_pixel.h"
+
+// Source coordinates are tracked in 16.16 format, the same as GTransformNumber
+#define SAMPLE_PRECISION FIXED_S32_16_PRECISION
+
+typedef struct BlitBitmap {
+  uint8_t *data;
+  uint16_t bytes_per_row;
+  GRect bounds;
+} BlitBitmap;
+
+static BlitBitmap prv_blit_bitmap(const GBitmap *bitmap) {
+  return (BlitBitmap) {
+    .data = gbitmap_get_data(bitmap),
+    .bytes_per_row = gbitmap_get_bytes_per_row(bitmap),
+    .bounds = gbitmap_get_bounds(bitmap),
+  };
+}
+
+// No rotation or shear: the source row only depends on the destination row and the source
+// column only depends on the destination column.
+static void prv_blit_axis_aligned(const BlitBitmap *dest, const BlitBitmap *src,
+                                  GBitmapFormat format, GRect area,
+                                  const GTransformIterator *start) {
+  const int32_t u_start = start->x.raw_value;
+  const int32_t v_start = start->y.raw_value;
+  const int32_t du = start->dx.raw_value;
+  const int32_t dv_row = start->row_dy.raw_value;
+  const uint32_t src_w = src->bounds.size.w;
+  const uint32_t src_h = src->bounds.size.h;
+
+  int32_t v = v_start;
+  for (int32_t y = area.origin.y; y < area.origin.y + area.size.h; y++, v += dv_row) {
+    const int32_t sv = v >> SAMPLE_PRECISION;
+    if ((uint32_t)sv >= src_h) {
+      continue;
+    }
+
+    const uint8_t *src_row = src->data + (src->bounds.origin.y + sv) * src->bytes_per_row;
+    uint8_t *dest_row = dest->data + y * dest->bytes_per_row;
+    int32_t u = u_start;
+
+    if (format == GBitmapFormat8Bit) {
+      for (int32_t x = area.origin.x; x < area.origin.x + area.size.w; x++, u += du) {
+        const uint32_t su = u >> SAMPLE_PRECISION;
+        if (su < src_w) {
+          const uint8_t pixel = src_row[src->bounds.origin.x + su];
+          if (pixel & PIXEL_8BIT_ALPHA_MASK) {
+            dest_row[x] = pixel;
+          }
+        }
+      }
+    } else {
+      for (int32_t x = area.origin.x; x < area.origin.x + area.size.w; x++, u += du) {
+        const uint32_t su = u >> SAMPLE_PRECISION;
+        if (su < src_w) {
+          gbitmap_pixel_set_1bit(dest_row, x,
+                                 gbitmap_pixel_get_1bit(src_row, src->bounds.origin.x + su));
+        }
+      }
+    }
+  }
+}
+
+static void prv_blit_general(const BlitBitmap *dest, const BlitBitmap *src, GBitmapFormat format,
+                             GRect area, const GTransformIterator *start) {
+  const uint32_t src_w = src->bounds.size.w;
+  const uint32_t src_h = src->bounds.size.h;
+
+  GTransformIterator iter = *start;
+
+  for (int32_t y = area.origin.y; y < area.origin.y + area.size.h;
+       y++, gtransform_iter_next_row(&iter)) {
+    uint8_t *dest_row = dest->data + y * dest->bytes_per_row;
+
+    for (int32_t x = area.origin.x; x < area.origin.x + area.size.w;
+         x++, gtransform_iter_next(&iter)) {
+      const uint32_t su = iter.x.raw_value >> SAMPLE_PRECISION;
+      const uint32_t sv = iter.y.raw_value >> SAMPLE_PRECISION;
+      if ((su >= src_w) || (sv >= src_h)) {
+        continue;
+      }
+
+      const uint8_t *src_row = src->data + (src->bounds.origin.y + sv) * src->bytes_per_row;
+      if (format == GBitmapFormat8Bit) {
+        const uint8_t pixel = src_row[src->bounds.origin.x + su];
+        if (pixel & PIXEL_8BIT_ALPHA_MASK) {
+          dest_row[x] = pixel;
+        }
+      } else {
+        gbitmap_pixel_set_1bit(dest_row, x,
+                               gbitmap_pixel_get_1bit(src_row, src->bounds.origin.x + su));
+      }
+    }
+  }
+}
+
+bool gbitmap_draw_transformed(GBitmap *dest, GRect clip, const GBitmap *src,
+                              const GTransform *t) {
+  if ((!dest) || (!src)) {
+    return false;
+  }
+
+  const GBitmapFormat format = gbitmap_get_format(src);
+  if ((format != gbitmap_get_format(dest)) ||
+      ((format != GBitmapFormat1Bit) && (format != GBitmapFormat8Bit))) {
+    return false;
+  }
+
+  GTransform t_inv = t ? *t : GTransformIdentity();
+  if (!gtransform_invert(&t_inv, &t_inv)) {
+    return false;
+  }
+
+  const BlitBitmap dest_bitmap = prv_blit_bitmap(dest);
+  const BlitBitmap src_bitmap = prv_blit_bitmap(src);
+
+  // Only destination pixels inside the transformed bounds of the source can be covered
+  GRect area = grect_transform_bounds(GRect(0, 0, src_bitmap.bounds.size.w,
+                                            src_bitmap.bounds.size.h), t);
+  area = grect_intersection(area, clip);
+  area = grect_intersection(area, dest_bitmap.bounds);
+  if ((area.size.w == 0) || (area.size.h == 0)) {
+    return true;
+  }
+
+  // Source coordinates of the center of the first destination pixel; every other pixel is
+  // reached by adding the per-pixel and per-row deltas of the iterator
+  GTransformIterator iter;
+  const int32_t half = 1 << (GPOINT_PRECISE_PRECISION - 1);
+  gtransform_iter_begin_precise(&iter, &t_inv, GPointPrecise(
+      (area.origin.x << GPOINT_PRECISE_PRECISION) + half,
+      (area.origin.y << GPOINT_PRECISE_PRECISION) + half));
+
+  if (gtransform_is_only_scale_or_translation(&t_inv)) {
+    prv_blit_axis_aligned(&dest_bitmap, &src_bitmap, format, area, &iter);
+  } else {
+    prv_blit_general(&dest_bitmap, &src_bitmap, format, area, &iter);
+  }
+
+  return true;
+}
+
+bool framebuffer_draw_bitmap_transformed(GContext *ctx, const GBitmap *bitmap,
+                                         const GTransform *t) {
+  if ((!ctx) || (!bitmap)) {
+    return false;
+  }
+
+  GBitmap *framebuffer = graphics_capture_frame_buffer(ctx);
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_draw_transformed(framebuffer, gbitmap_get_bounds(framebuffer),
+                                              bitmap, t);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+
+//////////////////////////////////////
+/// Drawing Transformed Bitmaps
+//////////////////////////////////////
+//! Draws a bitmap into another bitmap after rotating, scaling, shearing and/or translating it.
+//! Each destination pixel inside the transformed bounds of the source is mapped back through
+//! the inverse matrix and takes the value of the source pixel under its center (nearest
+//! neighbour). Source coordinates are stepped incrementally along each row so no multiplies are
+//! done per pixel, and matrices without rotation or shear take a faster path where every row
+//! reads from a single source row.
+//! Both bitmaps must have the same format; GBitmapFormat1Bit and GBitmapFormat8Bit are
+//! supported. In GBitmapFormat8Bit, source pixels with an alpha of 0 are not drawn.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified, in the coordinates of dest's data
+//! @param src Pointer to the bitmap to draw. Its top-left corner is at (0, 0) before
+//! transformation.
+//! @param t Pointer to transformation matrix that maps source coordinates to destination
+//! coordinates; if NULL the bitmap is drawn untransformed.
+//! @return True if the bitmap was drawn (or was entirely clipped); False if the formats are not
+//! supported, t cannot be inverted or any bitmap is NULL.
+bool gbitmap_draw_transformed(GBitmap *dest, GRect clip, const GBitmap *src,
+                              const GTransform *t);
+
+//! Draws a bitmap straight into the framebuffer of a graphics context after transforming it, in
+//! screen coordinates as framebuffer_draw_line_precise.
+//! See gbitmap_draw_transformed for details.
+//! @param ctx The destination graphics context
+//! @param bitmap Pointer to the bitmap to draw; must have the same format as the framebuffer.
+//! @param t Pointer to transformation matrix to apply to the bitmap
+//! @return True if the bitmap was drawn; False otherwise.
+bool framebuffer_draw_bitmap_transformed(GContext *ctx, const GBitmap *bitmap,
+                                         const GTransform *t);
+
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,244 @@
+#include <pebble.h>
+
+#include "gdamage_tracker.h"
+
+//////////////////////////////////////
+/// Rectangles
+//////////////////////////////////////
+static bool prv_is_empty(GRect rect) {
+  return (rect.size.w <= 0) || (rect.size.h <= 0);
+}
+
+static int32_t prv_area(GRect rect) {
+  return prv_is_empty(rect) ? 0 : ((int32_t)rect.size.w * rect.size.h);
+}
+
+static GRect prv_union(GRect r1, GRect r2) {
+  const int32_t x0 = (r1.origin.x < r2.origin.x) ? r1.origin.x : r2.origin.x;
+  const int32_t y0 = (r1.origin.y < r2.origin.y) ? r1.origin.y : r2.origin.y;
+  const int32_t x1 = ((r1.origin.x + r1.size.w) > (r2.origin.x + r2.size.w)) ?
+                     (r1.origin.x + r1.size.w) : (r2.origin.x + r2.size.w);
+  const int32_t y1 = ((r1.origin.y + r1.size.h) > (r2.origin.y + r2.size.h)) ?
+                     (r1.origin.y + r1.size.h) : (r2.origin.y + r2.size.h);
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+static bool prv_grect_equal(GRect r1, GRect r2) {
+  return (r1.origin.x == r2.origin.x) && (r1.origin.y == r2.origin.y) &&
+         (r1.size.w == r2.size.w) && (r1.size.h == r2.size.h);
+}
+
+// Pixels that merging two rectangles adds on top of their own; overlapping rectangles and
+// neighbours that line up cost nothing or less than nothing
+static int32_t prv_merge_cost(GRect r1, GRect r2) {
+  return prv_area(prv_union(r1, r2)) - prv_area(r1) - prv_area(r2) +
+         prv_area(grect_intersection(r1, r2));
+}
+
+//////////////////////////////////////
+/// Damage
+//////////////////////////////////////
+static void prv_remove_rect(GDamageTracker *tracker, uint8_t index) {
+  tracker->rects[index] = tracker->rects[--tracker->num_rects];
+}
+
+// Rectangles that overlap the new one or line up with it are merged into it first, which may
+// make it overlap others, so the search restarts after every merge. The damage then never
+// covers a pixel twice.
+static void prv_add_damage(GDamageTracker *tracker, GRect rect) {
+  rect = grect_intersection(rect, tracker->screen);
+  if (prv_is_empty(rect)) {
+    return;
+  }
+
+  for (;;) {
+    int32_t best_cost = INT32_MAX;
+    uint8_t best = 0;
+    bool merged = false;
+    for (uint8_t i = 0; i < tracker->num_rects; i++) {
+      const GRect *other = &tracker->rects[i];
+      const int32_t cost = prv_merge_cost(rect, *other);
+      if (!prv_is_empty(grect_intersection(rect, *other)) || (cost <= 0)) {
+        rect = prv_union(rect, *other);
+        prv_remove_rect(tracker, i);
+        merged = true;
+        break;
+      }
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = i;
+      }
+    }
+
+    if (merged) {
+      continue;
+    } else if (tracker->num_rects < GDAMAGE_TRACKER_MAX_RECTS) {
+      tracker->rects[tracker->num_rects++] = rect;
+      return;
+    }
+
+    // No room left, so the rectangle joins the one it grows the least
+    rect = prv_union(rect, tracker->rects[best]);
+    prv_remove_rect(tracker, best);
+  }
+}
+
+static bool prv_is_valid_object(const GDamageTracker *tracker, uint16_t object) {
+  return tracker && (object < tracker->num_objects);
+}
+
+void gdamage_tracker_init(GDamageTracker *tracker, GDamageObject *objects, uint16_t num_objects,
+                          GRect screen) {
+  if ((!tracker) || (!objects && num_objects)) {
+    return;
+  }
+
+  *tracker = (GDamageTracker) {
+    .objects = objects,
+    .num_objects = num_objects,
+    .screen = screen,
+  };
+  for (uint16_t i = 0; i < num_objects; i++) {
+    objects[i] = (GDamageObject) { .visible = false };
+  }
+  gdamage_tracker_invalidate(tracker);
+}
+
+void gdamage_tracker_begin_frame(GDamageTracker *tracker) {
+  if (!tracker) {
+    return;
+  }
+
+  tracker->num_rects = 0;
+}
+
+void gdamage_tracker_invalidate(GDamageTracker *tracker) {
+  if (!tracker) {
+    return;
+  }
+
+  tracker->num_rects = 0;
+  prv_add_damage(tracker, tracker->screen);
+}
+
+void gdamage_tracker_add_rect(GDamageTracker *tracker, GRect rect) {
+  if (!tracker) {
+    return;
+  }
+
+  prv_add_damage(tracker, rect);
+}
+
+bool gdamage_tracker_set_bounds(GDamageTracker *tracker, uint16_t object, GRect bounds) {
+  if (!prv_is_valid_object(tracker, object)) {
+    return false;
+  }
+
+  GDamageObject *state = &tracker->objects[object];
+  if (state->visible && prv_grect_equal(state->bounds, bounds)) {
+    return false;
+  }
+
+  if (state->visible) {
+    prv_add_damage(tracker, state->bounds);
+  }
+  prv_add_damage(tracker, bounds);
+  *state = (GDamageObject) {
+    .bounds = bounds,
+    .visible = true,
+  };
+  return true;
+}
+
+// The corners are the outermost pixels of the object rather than the edges of its rectangle.
+// Any pixel of the object lands between their transformed positions, so its position rounded
+// down is at least the rounded down minimum, and rounded to nearest at most the rounded maximum.
+bool gdamage_tracker_update(GDamageTracker *tracker, uint16_t object, GRect local_bounds,
+                            const GTransform *t) {
+  if (prv_is_empty(local_bounds)) {
+    return gdamage_tracker_set_bounds(tracker, object, GRect(0, 0, 0, 0));
+  }
+
+  const int16_t x0 = local_bounds.origin.x;
+  const int16_t y0 = local_bounds.origin.y;
+  const int16_t x1 = local_bounds.origin.x + local_bounds.size.w - 1;
+  const int16_t y1 = local_bounds.origin.y + local_bounds.size.h - 1;
+  const GPoint corners[] = { GPoint(x0, y0), GPoint(x1, y0), GPoint(x0, y1), GPoint(x1, y1) };
+  GPointPrecise transformed[ARRAY_LENGTH(corners)];
+  gpoint_transform_array(corners, transformed, ARRAY_LENGTH(corners), t);
+
+  int32_t min_x = INT32_MAX;
+  int32_t min_y = INT32_MAX;
+  int32_t max_x = INT32_MIN;
+  int32_t max_y = INT32_MIN;
+  for (size_t i = 0; i < ARRAY_LENGTH(corners); i++) {
+    const int32_t x = transformed[i].x.raw_value;
+    const int32_t y = transformed[i].y.raw_value;
+    min_x = (x < min_x) ? x : min_x;
+    min_y = (y < min_y) ? y : min_y;
+    max_x = (x > max_x) ? x : max_x;
+    max_y = (y > max_y) ? y : max_y;
+  }
+
+  const int32_t half = 1 << (GPOINT_PRECISE_PRECISION - 1);
+  const int32_t left = min_x >> GPOINT_PRECISE_PRECISION;
+  const int32_t top = min_y >> GPOINT_PRECISE_PRECISION;
+  const int32_t right = ((max_x + half) >> GPOINT_PRECISE_PRECISION) + 1;
+  const int32_t bottom = ((max_y + half) >> GPOINT_PRECISE_PRECISION) + 1;
+  return gdamage_tracker_set_bounds(tracker, object,
+                                    GRect(left, top, right - left, bottom - top));
+}
+
+void gdamage_tracker_hide(GDamageTracker *tracker, uint16_t object) {
+  if (!prv_is_valid_object(tracker, object) || !tracker->objects[object].visible) {
+    return;
+  }
+
+  prv_add_damage(tracker, tracker->objects[object].bounds);
+  tracker->objects[object].visible = false;
+}
+
+//////////////////////////////////////
+/// Querying Damage
+//////////////////////////////////////
+uint8_t gdamage_tracker_get_rects(const GDamageTracker *tracker, const GRect **rects) {
+  if ((!tracker) || (!rects)) {
+    return 0;
+  }
+
+  *rects = tracker->rects;
+  return tracker->num_rects;
+}
+
+uint32_t gdamage_tracker_get_area(const GDamageTracker *tracker) {
+  if (!tracker) {
+    return 0;
+  }
+
+  uint32_t area = 0;
+  for (uint8_t i = 0; i < tracker->num_rects; i++) {
+    area += prv_area(tracker->rects[i]);
+  }
+  return area;
+}
+
+bool gdamage_tracker_intersects(const GDamageTracker *tracker, GRect rect) {
+  if (!tracker) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < tracker->num_rects; i++) {
+    if (!prv_is_empty(grect_intersection(tracker->rects[i], rect))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool gdamage_tracker_object_is_damaged(const GDamageTracker *tracker, uint16_t object) {
+  if (!prv_is_valid_object(tracker, object) || !tracker->objects[object].visible) {
+    return false;
+  }
+
+  return gdamage_tracker_intersects(tracker, tracker->objects[object].bounds);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsDamageTracker Damage Tracking
+//! \brief Finds the parts of the screen that changed between two frames from the transformed
+//! bounds of the objects on it, so only those parts need to be cleared and redrawn.
+//!
+//! Every object has a slot in a caller provided array that keeps its bounds on screen from the
+//! last frame. When an object is updated with bounds that differ, both its old and new bounds
+//! become damaged. Damaged rectangles that overlap are merged, so the damage never covers a
+//! pixel twice, and once GDAMAGE_TRACKER_MAX_RECTS rectangles are in use a new one is merged
+//! with the rectangle it grows the least. A frame is drawn by clearing every damaged rectangle
+//! and redrawing every object that gdamage_tracker_object_is_damaged reports, in the usual
+//! order; objects that are opaque in the same color where they overlap may be redrawn whole.
+//!     @{
+
+//! Most damaged rectangles kept per frame
+#define GDAMAGE_TRACKER_MAX_RECTS 8
+
+//! Bounds of a tracked object as of the last frame
+typedef struct GDamageObject {
+  //! Pixels covered by the object on screen
+  GRect bounds;
+  //! Set while the object is shown
+  bool visible;
+} GDamageObject;
+
+//! Damage of the current frame and the objects it is computed from
+typedef struct GDamageTracker {
+  //! Storage for the objects
+  GDamageObject *objects;
+  //! Number of objects the storage holds
+  uint16_t num_objects;
+  //! Rectangle of the screen; damage outside it is dropped
+  GRect screen;
+  //! Damaged rectangles of the current frame, which do not overlap
+  GRect rects[GDAMAGE_TRACKER_MAX_RECTS];
+  //! Number of damaged rectangles
+  uint8_t num_rects;
+} GDamageTracker;
+
+//! Initializes a damage tracker with all objects hidden and the whole screen damaged, since
+//! nothing has been drawn yet.
+//! @param tracker Pointer to the tracker to initialize
+//! @param objects Pointer to the storage for the objects
+//! @param num_objects Number of objects the storage holds
+//! @param screen Rectangle of the screen
+void gdamage_tracker_init(GDamageTracker *tracker, GDamageObject *objects, uint16_t num_objects,
+                          GRect screen);
+
+//! Starts a new frame by forgetting the damage of the previous one. Object bounds are kept.
+//! @param tracker Pointer to the tracker
+void gdamage_tracker_begin_frame(GDamageTracker *tracker);
+
+//! Damages the whole screen, e.g. when the background changes.
+//! @param tracker Pointer to the tracker
+void gdamage_tracker_invalidate(GDamageTracker *tracker);
+
+//! Damages a rectangle of the screen, e.g. for an object that changed within the same bounds.
+//! @param tracker Pointer to the tracker
+//! @param rect Rectangle to damage
+void gdamage_tracker_add_rect(GDamageTracker *tracker, GRect rect);
+
+//! Sets the bounds of an object on screen. If the object was hidden or its bounds changed, its
+//! old and new bounds are damaged.
+//! @param tracker Pointer to the tracker
+//! @param object Index of the object
+//! @param bounds Pixels covered by the object on screen
+//! @return True if the object moved, appeared or changed size; False otherwise or if the
+//! object does not exist.
+bool gdamage_tracker_set_bounds(GDamageTracker *tracker, uint16_t object, GRect bounds);
+
+//! Sets the bounds of an object from its bounds in its own coordinates and the matrix that
+//! draws it. The transformed positions of its corner pixels are rounded outwards, so the result
+//! covers every pixel that the matrix moves the object's pixels to, whether the drawing rounds
+//! their positions down or to the nearest pixel.
+//! @param tracker Pointer to the tracker
+//! @param object Index of the object
+//! @param local_bounds Pixels covered by the object in its own coordinates
+//! @param t Pointer to the matrix from the object's coordinates to the screen; if NULL the
+//! identity is used.
+//! @return Same as gdamage_tracker_set_bounds.
+bool gdamage_tracker_update(GDamageTracker *tracker, uint16_t object, GRect local_bounds,
+                            const GTransform *t);
+
+//! Hides an object, which damages its last bounds.
+//! @param tracker Pointer to the tracker
+//! @param object Index of the object
+void gdamage_tracker_hide(GDamageTracker *tracker, uint16_t object);
+
+//! Returns the damaged rectangles of the current frame.
+//! @param tracker Pointer to the tracker
+//! @param rects Set to point at the damaged rectangles
+//! @return Number of damaged rectangles; 0 if an argument is NULL.
+uint8_t gdamage_tracker_get_rects(const GDamageTracker *tracker, const GRect **rects);
+
+//! Returns the number of pixels that the damaged rectangles of the current frame cover, i.e.
+//! that are redrawn.
+//! @param tracker Pointer to the tracker
+//! @return Number of damaged pixels.
+uint32_t gdamage_tracker_get_area(const GDamageTracker *tracker);
+
+//! Tells whether a rectangle overlaps the damage of the current frame.
+//! @param tracker Pointer to the tracker
+//! @param rect Rectangle to check
+//! @return True if any pixel of rect is damaged.
+bool gdamage_tracker_intersects(const GDamageTracker *tracker, GRect rect);
+
+//! Tells whether an object has to be redrawn because it overlaps the damage of the current
+//! frame.
+//! @param tracker Pointer to the tracker
+//! @param object Index of the object
+//! @return True if the object is shown and overlaps the damage.
+bool gdamage_tracker_object_is_damaged(const GDamageTracker *tracker, uint16_t object);
+
+//!     @} // end addtogroup GraphicsDamageTracker
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
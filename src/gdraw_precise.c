@@ -0,0 +1,478 @@
+#include <pebble.h>
+
+#include "gdraw_precise.h"
+#include "gbitmap_pixel.h"
+
+// Edges are placed in 1/256 px internally, which keeps the square roots of the circle code
+// accurate without overflowing 64 bits
+#define FINE_PRECISION 8
+#define FINE_ONE (1 << FINE_PRECISION)
+#define PRECISE_TO_FINE_SHIFT (FINE_PRECISION - GPOINT_PRECISE_PRECISION)
+
+// Share of a pixel that is covered, from 0 to COVERAGE_FULL
+#define COVERAGE_FULL FINE_ONE
+#define COVERAGE_HALF (COVERAGE_FULL / 2)
+
+typedef struct Canvas {
+  uint8_t *data;
+  uint16_t bytes_per_row;
+  GBitmapFormat format;
+  GRect clip;
+  uint8_t color;
+} Canvas;
+
+//////////////////////////////////////
+/// Pixels
+//////////////////////////////////////
+static bool prv_canvas_init(Canvas *canvas, GBitmap *dest, GRect clip, uint8_t color) {
+  if (!dest) {
+    return false;
+  }
+
+  const GBitmapFormat format = gbitmap_get_format(dest);
+  if ((format != GBitmapFormat1Bit) && (format != GBitmapFormat8Bit)) {
+    return false;
+  }
+
+  *canvas = (Canvas) {
+    .data = gbitmap_get_data(dest),
+    .bytes_per_row = gbitmap_get_bytes_per_row(dest),
+    .format = format,
+    .clip = grect_intersection(clip, gbitmap_get_bounds(dest)),
+    .color = gbitmap_pixel_color(format, color),
+  };
+  return true;
+}
+
+// Each of the three color channels has two bits, so it is blended on its own
+static uint8_t prv_blend_8bit(uint8_t dest, uint8_t color, int32_t coverage) {
+  uint8_t result = PIXEL_8BIT_ALPHA_MASK;
+  for (int shift = 0; shift < 6; shift += 2) {
+    const int32_t src_channel = (color >> shift) & 3;
+    const int32_t dest_channel = (dest >> shift) & 3;
+    const int32_t channel = (src_channel * coverage + dest_channel * (COVERAGE_FULL - coverage) +
+                             COVERAGE_HALF) >> FINE_PRECISION;
+    result |= channel << shift;
+  }
+  return result;
+}
+
+static void prv_plot(const Canvas *canvas, int32_t x, int32_t y, int32_t coverage) {
+  if ((coverage <= 0) || (x < canvas->clip.origin.x) || (y < canvas->clip.origin.y) ||
+      (x >= canvas->clip.origin.x + canvas->clip.size.w) ||
+      (y >= canvas->clip.origin.y + canvas->clip.size.h)) {
+    return;
+  }
+
+  uint8_t *row = canvas->data + y * canvas->bytes_per_row;
+  if (canvas->format == GBitmapFormat8Bit) {
+    row[x] = (coverage >= COVERAGE_FULL) ? canvas->color :
+                                           prv_blend_8bit(row[x], canvas->color, coverage);
+  } else if (coverage >= COVERAGE_HALF) {
+    gbitmap_pixel_set_1bit(row, x, canvas->color);
+  }
+}
+
+// Draws the pixels from x0 to x1 inclusive of a row fully
+static void prv_fill_span(const Canvas *canvas, int32_t y, int32_t x0, int32_t x1) {
+  if ((y < canvas->clip.origin.y) || (y >= canvas->clip.origin.y + canvas->clip.size.h)) {
+    return;
+  }
+
+  if (x0 < canvas->clip.origin.x) {
+    x0 = canvas->clip.origin.x;
+  }
+  if (x1 >= canvas->clip.origin.x + canvas->clip.size.w) {
+    x1 = canvas->clip.origin.x + canvas->clip.size.w - 1;
+  }
+
+  uint8_t *row = canvas->data + y * canvas->bytes_per_row;
+  if (canvas->format == GBitmapFormat8Bit) {
+    for (int32_t x = x0; x <= x1; x++) {
+      row[x] = canvas->color;
+    }
+  } else {
+    for (int32_t x = x0; x <= x1; x++) {
+      gbitmap_pixel_set_1bit(row, x, canvas->color);
+    }
+  }
+}
+
+//////////////////////////////////////
+/// Helpers
+//////////////////////////////////////
+static int32_t prv_abs(int32_t value) {
+  return (value < 0) ? -value : value;
+}
+
+// Pixel centers are at whole fine units, so these find the pixels on either side of an edge
+static int32_t prv_fine_floor(int64_t fine) {
+  return (int32_t)(fine >> FINE_PRECISION);
+}
+
+static int32_t prv_fine_ceil(int64_t fine) {
+  return (int32_t)-((-fine) >> FINE_PRECISION);
+}
+
+static int32_t prv_precise_to_fine(Fixed_S16_3 value) {
+  return value.raw_value * (1 << PRECISE_TO_FINE_SHIFT);
+}
+
+// Distance in fine units of a pixel center from the center of a circle
+static int32_t prv_distance(int64_t dx, int64_t dy) {
+  return (int32_t)fixed_isqrt((uint64_t)(dx * dx + dy * dy));
+}
+
+//////////////////////////////////////
+/// Lines
+//////////////////////////////////////
+// Walks the major axis one pixel at a time and keeps the minor coordinate in 16.16 format,
+// which only takes one add per pixel. Pixels are drawn from the one nearest to the first end
+// to the one nearest to the second end.
+static void prv_draw_line(const Canvas *canvas, GPointPrecise p0, GPointPrecise p1,
+                          bool antialiased) {
+  const int32_t dx = p1.x.raw_value - p0.x.raw_value;
+  const int32_t dy = p1.y.raw_value - p0.y.raw_value;
+  const bool steep = prv_abs(dy) > prv_abs(dx);
+
+  int32_t u0 = steep ? p0.y.raw_value : p0.x.raw_value;
+  int32_t v0 = steep ? p0.x.raw_value : p0.y.raw_value;
+  int32_t u1 = steep ? p1.y.raw_value : p1.x.raw_value;
+  int32_t v1 = steep ? p1.x.raw_value : p1.y.raw_value;
+  if (u0 > u1) {
+    int32_t swap = u0;
+    u0 = u1;
+    u1 = swap;
+    swap = v0;
+    v0 = v1;
+    v1 = swap;
+  }
+
+  const int32_t half = 1 << (GPOINT_PRECISE_PRECISION - 1);
+  const int64_t slope = (u1 != u0) ?
+      (((int64_t)(v1 - v0) << FIXED_S32_16_PRECISION) / (u1 - u0)) : 0;
+  int32_t i_start = (u0 + half) >> GPOINT_PRECISE_PRECISION;
+  int32_t i_end = (u1 + half) >> GPOINT_PRECISE_PRECISION;
+
+  // Pixels outside of the clip rectangle along the major axis are skipped without walking them
+  const int32_t clip_start = steep ? canvas->clip.origin.y : canvas->clip.origin.x;
+  const int32_t clip_end = clip_start + (steep ? canvas->clip.size.h : canvas->clip.size.w) - 1;
+  if (i_end > clip_end) {
+    i_end = clip_end;
+  }
+  if (i_start < clip_start) {
+    i_start = clip_start;
+  }
+
+  const int64_t offset = ((int64_t)i_start << GPOINT_PRECISE_PRECISION) - u0;
+  int64_t v = ((int64_t)v0 << (FIXED_S32_16_PRECISION - GPOINT_PRECISE_PRECISION)) +
+              ((offset * slope) >> GPOINT_PRECISE_PRECISION);
+  const int32_t v_half = 1 << (FIXED_S32_16_PRECISION - 1);
+  const int32_t coverage_shift = FIXED_S32_16_PRECISION - FINE_PRECISION;
+
+  for (int32_t i = i_start; i <= i_end; i++, v += slope) {
+    if (antialiased) {
+      const int32_t vi = (int32_t)(v >> FIXED_S32_16_PRECISION);
+      const int32_t fraction = (int32_t)(v >> coverage_shift) & (COVERAGE_FULL - 1);
+      if (steep) {
+        prv_plot(canvas, vi, i, COVERAGE_FULL - fraction);
+        prv_plot(canvas, vi + 1, i, fraction);
+      } else {
+        prv_plot(canvas, i, vi, COVERAGE_FULL - fraction);
+        prv_plot(canvas, i, vi + 1, fraction);
+      }
+    } else {
+      const int32_t vi = (int32_t)((v + v_half) >> FIXED_S32_16_PRECISION);
+      if (steep) {
+        prv_plot(canvas, vi, i, COVERAGE_FULL);
+      } else {
+        prv_plot(canvas, i, vi, COVERAGE_FULL);
+      }
+    }
+  }
+}
+
+bool gbitmap_draw_line_precise(GBitmap *dest, GRect clip, GPointPrecise p0, GPointPrecise p1,
+                               uint8_t color, bool antialiased) {
+  Canvas canvas;
+  if (!prv_canvas_init(&canvas, dest, clip, color)) {
+    return false;
+  }
+
+  prv_draw_line(&canvas, p0, p1, antialiased);
+  return true;
+}
+
+//////////////////////////////////////
+/// Polygons
+//////////////////////////////////////
+bool gbitmap_draw_polygon_precise(GBitmap *dest, GRect clip, const GPointPrecise *points,
+                                  size_t num_points, uint8_t color, bool antialiased) {
+  Canvas canvas;
+  if ((!points) || !prv_canvas_init(&canvas, dest, clip, color)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < num_points; i++) {
+    prv_draw_line(&canvas, points[i], points[(i + 1) % num_points], antialiased);
+  }
+  return true;
+}
+
+// Each row is sampled through the centers of its pixels: the edges that span the row are
+// intersected with it in fine units, sorted, and the pixels between each pair are drawn
+bool gbitmap_fill_polygon_precise(GBitmap *dest, GRect clip, const GPointPrecise *points,
+                                  size_t num_points, uint8_t color) {
+  Canvas canvas;
+  if ((!points) || (num_points > GDRAW_PRECISE_MAX_POLYGON_POINTS) ||
+      !prv_canvas_init(&canvas, dest, clip, color)) {
+    return false;
+  }
+
+  if (num_points < 3) {
+    return true;
+  }
+
+  int32_t min_y = points[0].y.raw_value;
+  int32_t max_y = min_y;
+  for (size_t i = 1; i < num_points; i++) {
+    if (points[i].y.raw_value < min_y) {
+      min_y = points[i].y.raw_value;
+    }
+    if (points[i].y.raw_value > max_y) {
+      max_y = points[i].y.raw_value;
+    }
+  }
+
+  // Rows whose centers are in [min_y, max_y), as each edge includes its upper end only
+  const int32_t precise_one = 1 << GPOINT_PRECISE_PRECISION;
+  int32_t y_start = -((-min_y) >> GPOINT_PRECISE_PRECISION);
+  int32_t y_end = -((-max_y) >> GPOINT_PRECISE_PRECISION) - 1;
+  if (y_start < canvas.clip.origin.y) {
+    y_start = canvas.clip.origin.y;
+  }
+  if (y_end >= canvas.clip.origin.y + canvas.clip.size.h) {
+    y_end = canvas.clip.origin.y + canvas.clip.size.h - 1;
+  }
+
+  int32_t crossings[GDRAW_PRECISE_MAX_POLYGON_POINTS];
+  for (int32_t y = y_start; y <= y_end; y++) {
+    const int32_t row = y * precise_one;
+    size_t num_crossings = 0;
+
+    for (size_t i = 0; i < num_points; i++) {
+      const GPointPrecise *pa = &points[i];
+      const GPointPrecise *pb = &points[(i + 1) % num_points];
+      const int32_t ya = pa->y.raw_value;
+      const int32_t yb = pb->y.raw_value;
+      if (!(((ya <= row) && (row < yb)) || ((yb <= row) && (row < ya)))) {
+        continue;
+      }
+
+      const int64_t dx = (int64_t)(pb->x.raw_value - pa->x.raw_value) << PRECISE_TO_FINE_SHIFT;
+      const int32_t x = prv_precise_to_fine(pa->x) + (int32_t)(((row - ya) * dx) / (yb - ya));
+
+      // Insertion sort, as a row rarely crosses more than a few edges
+      size_t j = num_crossings++;
+      while ((j > 0) && (crossings[j - 1] > x)) {
+        crossings[j] = crossings[j - 1];
+        j--;
+      }
+      crossings[j] = x;
+    }
+
+    for (size_t i = 0; i + 1 < num_crossings; i += 2) {
+      prv_fill_span(&canvas, y, prv_fine_ceil(crossings[i]), prv_fine_ceil(crossings[i + 1]) - 1);
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////
+/// Circles
+//////////////////////////////////////
+// Decides the coverage of a pixel from the distance of its center to the center of the circle
+typedef void (*CircleEdgeFunc)(const Canvas *canvas, int32_t x, int32_t y, int32_t distance,
+                               int32_t radius, bool antialiased);
+
+// Passes each pixel whose center is less than outer_radius from the center to edge_func,
+// except for those within inner_radius, which are drawn fully if fill_inner is set
+static void prv_walk_circle(const Canvas *canvas, GPointPrecise center, int32_t radius,
+                            int32_t outer_radius, int32_t inner_radius, bool fill_inner,
+                            CircleEdgeFunc edge_func, bool antialiased) {
+  const int64_t cx = prv_precise_to_fine(center.x);
+  const int64_t cy = prv_precise_to_fine(center.y);
+  const int64_t outer_squared = (int64_t)outer_radius * outer_radius;
+  const int64_t inner_squared = (int64_t)inner_radius * inner_radius;
+
+  int32_t y_start = prv_fine_ceil(cy - outer_radius);
+  int32_t y_end = prv_fine_floor(cy + outer_radius);
+  if (y_start < canvas->clip.origin.y) {
+    y_start = canvas->clip.origin.y;
+  }
+  if (y_end >= canvas->clip.origin.y + canvas->clip.size.h) {
+    y_end = canvas->clip.origin.y + canvas->clip.size.h - 1;
+  }
+
+  for (int32_t y = y_start; y <= y_end; y++) {
+    const int64_t dy = ((int64_t)y << FINE_PRECISION) - cy;
+    const int64_t dy_squared = dy * dy;
+    if (dy_squared >= outer_squared) {
+      continue;
+    }
+
+    const int32_t outer_width = (int32_t)fixed_isqrt((uint64_t)(outer_squared - dy_squared));
+    int32_t x_start = prv_fine_ceil(cx - outer_width);
+    int32_t x_end = prv_fine_floor(cx + outer_width);
+    if (x_start < canvas->clip.origin.x) {
+      x_start = canvas->clip.origin.x;
+    }
+    if (x_end >= canvas->clip.origin.x + canvas->clip.size.w) {
+      x_end = canvas->clip.origin.x + canvas->clip.size.w - 1;
+    }
+
+    // Pixels whose centers are within inner_radius need no distance
+    int32_t inner_start = x_end + 1;
+    int32_t inner_end = x_end;
+    if ((inner_radius > 0) && (dy_squared < inner_squared)) {
+      const int32_t inner_width = (int32_t)fixed_isqrt((uint64_t)(inner_squared - dy_squared));
+      inner_start = prv_fine_ceil(cx - inner_width);
+      inner_end = prv_fine_floor(cx + inner_width);
+      if (fill_inner) {
+        prv_fill_span(canvas, y, inner_start, inner_end);
+      }
+    }
+
+    for (int32_t x = x_start; x <= x_end; x++) {
+      if ((x >= inner_start) && (x <= inner_end)) {
+        x = inner_end;
+        continue;
+      }
+      const int32_t distance = prv_distance(((int64_t)x << FINE_PRECISION) - cx, dy);
+      edge_func(canvas, x, y, distance, radius, antialiased);
+    }
+  }
+}
+
+// Coverage of a pixel on the edge of a filled circle, from the distance of its center
+static void prv_fill_edge(const Canvas *canvas, int32_t x, int32_t y, int32_t distance,
+                          int32_t radius, bool antialiased) {
+  if (antialiased) {
+    prv_plot(canvas, x, y, radius + COVERAGE_HALF - distance);
+  } else if (distance <= radius) {
+    prv_plot(canvas, x, y, COVERAGE_FULL);
+  }
+}
+
+// Coverage of a pixel by a one pixel wide outline, from the distance of its center
+static void prv_outline_edge(const Canvas *canvas, int32_t x, int32_t y, int32_t distance,
+                             int32_t radius, bool antialiased) {
+  const int32_t offset = prv_abs(distance - radius);
+  if (antialiased) {
+    prv_plot(canvas, x, y, COVERAGE_FULL - offset);
+  } else if (offset < COVERAGE_HALF) {
+    prv_plot(canvas, x, y, COVERAGE_FULL);
+  }
+}
+
+bool gbitmap_draw_circle_precise(GBitmap *dest, GRect clip, GPointPrecise center,
+                                 Fixed_S16_3 radius, uint8_t color, bool antialiased) {
+  Canvas canvas;
+  if (!prv_canvas_init(&canvas, dest, clip, color)) {
+    return false;
+  }
+
+  // Anti-aliased, the outline reaches one pixel to either side; otherwise half a pixel
+  const int32_t r = prv_precise_to_fine(radius);
+  const int32_t reach = antialiased ? COVERAGE_FULL : COVERAGE_HALF;
+  if (r >= 0) {
+    prv_walk_circle(&canvas, center, r, r + reach, r - reach, false, prv_outline_edge,
+                    antialiased);
+  }
+  return true;
+}
+
+bool gbitmap_fill_circle_precise(GBitmap *dest, GRect clip, GPointPrecise center,
+                                 Fixed_S16_3 radius, uint8_t color, bool antialiased) {
+  Canvas canvas;
+  if (!prv_canvas_init(&canvas, dest, clip, color)) {
+    return false;
+  }
+
+  // Anti-aliased, pixels within half a pixel of the edge are partly covered
+  const int32_t r = prv_precise_to_fine(radius);
+  const int32_t reach = antialiased ? COVERAGE_HALF : 0;
+  if (r > 0) {
+    prv_walk_circle(&canvas, center, r, r + reach + 1, r - reach, true, prv_fill_edge,
+                    antialiased);
+  }
+  return true;
+}
+
+//////////////////////////////////////
+/// Framebuffer
+//////////////////////////////////////
+bool framebuffer_draw_line_precise(GContext *ctx, GPointPrecise p0, GPointPrecise p1,
+                                   uint8_t color, bool antialiased) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_draw_line_precise(framebuffer, gbitmap_get_bounds(framebuffer),
+                                               p0, p1, color, antialiased);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
+
+bool framebuffer_draw_polygon_precise(GContext *ctx, const GPointPrecise *points,
+                                      size_t num_points, uint8_t color, bool antialiased) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_draw_polygon_precise(framebuffer, gbitmap_get_bounds(framebuffer),
+                                                  points, num_points, color, antialiased);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
+
+bool framebuffer_fill_polygon_precise(GContext *ctx, const GPointPrecise *points,
+                                      size_t num_points, uint8_t color) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_fill_polygon_precise(framebuffer, gbitmap_get_bounds(framebuffer),
+                                                  points, num_points, color);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
+
+bool framebuffer_draw_circle_precise(GContext *ctx, GPointPrecise center, Fixed_S16_3 radius,
+                                     uint8_t color, bool antialiased) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_draw_circle_precise(framebuffer, gbitmap_get_bounds(framebuffer),
+                                                 center, radius, color, antialiased);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
+
+bool framebuffer_fill_circle_precise(GContext *ctx, GPointPrecise center, Fixed_S16_3 radius,
+                                     uint8_t color, bool antialiased) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return false;
+  }
+
+  const bool drawn = gbitmap_fill_circle_precise(framebuffer, gbitmap_get_bounds(framebuffer),
+                                                 center, radius, color, antialiased);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return drawn;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtypes.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsPreciseDrawing Precise Drawing
+//! \brief Lines, polygons and circles rasterized straight from GPointPrecise coordinates, so
+//! the 1/8 px that transforms compute are not thrown away before drawing.
+//!
+//! A precise coordinate of n.0 is the center of pixel n, which matches
+//! GPointFromGPointPreciseRounded. Fills cover the pixels whose centers are inside the shape,
+//! so a shape that moves by 1/8 px changes its pixels as soon as an edge crosses a center.
+//! Anti-aliased lines and circle edges blend the color into the destination by the share of
+//! each pixel they cover; that needs GBitmapFormat8Bit, where the coverage is quantized to the
+//! four levels of each color channel. In GBitmapFormat1Bit, pixels that are at least half
+//! covered are drawn instead.
+//!
+//! The color is a raw pixel value of the destination format: an 8-bit ARGB value (drawn
+//! opaque) or 0 and 1 in GBitmapFormat1Bit. Coordinates of the destination are those of its
+//! data, as in gbitmap_draw_transformed.
+//!     @{
+
+//! Most points of a polygon that the precise polygon functions accept
+#define GDRAW_PRECISE_MAX_POLYGON_POINTS 64
+
+//! Draws a line between two precise points, both ends included.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified
+//! @param p0 First end of the line
+//! @param p1 Second end of the line
+//! @param color Raw pixel value to draw
+//! @param antialiased Whether to blend the line into the two pixels nearest to it in each row
+//! or column (Xiaolin Wu's algorithm) instead of drawing the single nearest one
+//! @return True if the line was drawn (or was entirely clipped); False if the format is not
+//! supported or dest is NULL.
+bool gbitmap_draw_line_precise(GBitmap *dest, GRect clip, GPointPrecise p0, GPointPrecise p1,
+                               uint8_t color, bool antialiased);
+
+//! Draws the outline of a closed polygon as lines between its precise points.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified
+//! @param points Pointer to the points of the polygon
+//! @param num_points Number of points
+//! @param color Raw pixel value to draw
+//! @param antialiased Whether the edges are anti-aliased, as gbitmap_draw_line_precise
+//! @return True if the outline was drawn; False if the format is not supported or an argument
+//! is NULL.
+bool gbitmap_draw_polygon_precise(GBitmap *dest, GRect clip, const GPointPrecise *points,
+                                  size_t num_points, uint8_t color, bool antialiased);
+
+//! Fills a polygon whose pixel centers are inside it by the even-odd rule, with its edges at
+//! their exact precise positions.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified
+//! @param points Pointer to the points of the polygon
+//! @param num_points Number of points, at most GDRAW_PRECISE_MAX_POLYGON_POINTS
+//! @param color Raw pixel value to draw
+//! @return True if the polygon was filled; False if the format is not supported, it has too
+//! many points or an argument is NULL.
+bool gbitmap_fill_polygon_precise(GBitmap *dest, GRect clip, const GPointPrecise *points,
+                                  size_t num_points, uint8_t color);
+
+//! Draws a one pixel wide circle outline centered on a precise point.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified
+//! @param center Center of the circle
+//! @param radius Radius of the circle in precise pixels
+//! @param color Raw pixel value to draw
+//! @param antialiased Whether to blend the outline into the pixels by the share of them that it
+//! covers instead of drawing the pixels whose centers are within half a pixel of it
+//! @return True if the circle was drawn; False if the format is not supported or dest is NULL.
+bool gbitmap_draw_circle_precise(GBitmap *dest, GRect clip, GPointPrecise center,
+                                 Fixed_S16_3 radius, uint8_t color, bool antialiased);
+
+//! Fills a circle centered on a precise point.
+//! @param dest Pointer to the bitmap to draw into
+//! @param clip Rectangle of dest that may be modified
+//! @param center Center of the circle
+//! @param radius Radius of the circle in precise pixels
+//! @param color Raw pixel value to draw
+//! @param antialiased Whether to blend the pixels along the edge by the share of them inside
+//! the circle instead of drawing those whose centers are inside it
+//! @return True if the circle was filled; False if the format is not supported or dest is NULL.
+bool gbitmap_fill_circle_precise(GBitmap *dest, GRect clip, GPointPrecise center,
+                                 Fixed_S16_3 radius, uint8_t color, bool antialiased);
+
+//! Draws a precise line straight into the framebuffer of a graphics context.
+//! Unlike the graphics_draw functions of the SDK, this does not use the state of the context:
+//! coordinates are those of the screen rather than of the layer being drawn, nothing is clipped
+//! to that layer and the color is a raw pixel value. See gbitmap_draw_line_precise for details.
+//! @return True if the line was drawn; False otherwise.
+bool framebuffer_draw_line_precise(GContext *ctx, GPointPrecise p0, GPointPrecise p1,
+                                   uint8_t color, bool antialiased);
+
+//! Draws a precise polygon outline straight into the framebuffer of a graphics context, in
+//! screen coordinates as framebuffer_draw_line_precise.
+//! See gbitmap_draw_polygon_precise for details.
+//! @return True if the outline was drawn; False otherwise.
+bool framebuffer_draw_polygon_precise(GContext *ctx, const GPointPrecise *points,
+                                      size_t num_points, uint8_t color, bool antialiased);
+
+//! Fills a precise polygon straight in the framebuffer of a graphics context, in screen
+//! coordinates as framebuffer_draw_line_precise.
+//! See gbitmap_fill_polygon_precise for details.
+//! @return True if the polygon was filled; False otherwise.
+bool framebuffer_fill_polygon_precise(GContext *ctx, const GPointPrecise *points,
+                                      size_t num_points, uint8_t color);
+
+//! Draws a precise circle outline straight into the framebuffer of a graphics context, in
+//! screen coordinates as framebuffer_draw_line_precise.
+//! See gbitmap_draw_circle_precise for details.
+//! @return True if the circle was drawn; False otherwise.
+bool framebuffer_draw_circle_precise(GContext *ctx, GPointPrecise center, Fixed_S16_3 radius,
+                                     uint8_t color, bool antialiased);
+
+//! Fills a precise circle straight in the framebuffer of a graphics context, in screen
+//! coordinates as framebuffer_draw_line_precise.
+//! See gbitmap_fill_circle_precise for details.
+//! @return True if the circle was filled; False otherwise.
+bool framebuffer_fill_circle_precise(GContext *ctx, GPointPrecise center, Fixed_S16_3 radius,
+                                     uint8_t color, bool antialiased);
+
+//!     @} // end addtogroup GraphicsPreciseDrawing
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
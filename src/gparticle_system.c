@@ -0,0 +1,164 @@
+#include <pebble.h>
+
+#include "gparticle_system.h"
+#include "gbitmap_pixel.h"
+
+// Random numbers for the spread are 16 bits, centered on 0
+#define RANDOM_BITS 16
+
+//////////////////////////////////////
+/// Helpers
+//////////////////////////////////////
+// Returns a number in [-2^15, 2^15) from a linear congruential generator
+static int32_t prv_random(GParticleSystem *system) {
+  system->seed = system->seed * 1664525 + 1013904223;
+  return (int32_t)(system->seed >> (32 - RANDOM_BITS)) - (1 << (RANDOM_BITS - 1));
+}
+
+static Fixed_S32_16 prv_spread(GParticleSystem *system, Fixed_S32_16 velocity,
+                               Fixed_S32_16 spread) {
+  const int64_t offset = ((int64_t)spread.raw_value * prv_random(system)) >> (RANDOM_BITS - 1);
+  return Fixed_S32_16(velocity.raw_value + (int32_t)offset);
+}
+
+// The last particle takes the place of the removed one, so the live particles stay at the start
+// of the arrays
+static void prv_remove(GParticleSystem *system, uint16_t index) {
+  const uint16_t last = --system->num_particles;
+  system->x[index] = system->x[last];
+  system->y[index] = system->y[last];
+  system->dx[index] = system->dx[last];
+  system->dy[index] = system->dy[last];
+  system->life[index] = system->life[last];
+}
+
+//////////////////////////////////////
+/// Particle Systems
+//////////////////////////////////////
+void gparticle_system_init(GParticleSystem *system, uint32_t *storage, uint16_t capacity) {
+  if ((!system) || (!storage)) {
+    return;
+  }
+
+  *system = (GParticleSystem) {
+    .x = (Fixed_S32_16 *)storage,
+    .y = (Fixed_S32_16 *)storage + capacity,
+    .dx = (Fixed_S32_16 *)storage + 2 * capacity,
+    .dy = (Fixed_S32_16 *)storage + 3 * capacity,
+    .life = (uint16_t *)(storage + 4 * capacity),
+    .capacity = capacity,
+    .seed = 0x2545f491,
+  };
+}
+
+void gparticle_system_clear(GParticleSystem *system) {
+  if (!system) {
+    return;
+  }
+
+  system->num_particles = 0;
+}
+
+uint16_t gparticle_system_emit(GParticleSystem *system, const GParticleEmitter *emitter,
+                               uint16_t count) {
+  if ((!system) || (!emitter) || (emitter->life == 0)) {
+    return 0;
+  }
+
+  const uint16_t room = system->capacity - system->num_particles;
+  if (count > room) {
+    count = room;
+  }
+
+  for (uint16_t i = system->num_particles; i < system->num_particles + count; i++) {
+    system->x[i] = emitter->x;
+    system->y[i] = emitter->y;
+    system->dx[i] = prv_spread(system, emitter->dx, emitter->spread);
+    system->dy[i] = prv_spread(system, emitter->dy, emitter->spread);
+    system->life[i] = emitter->life;
+  }
+  system->num_particles += count;
+  return count;
+}
+
+// The camera is applied in 16.16 rather than through GPointPrecise, so particles far outside
+// the ±4096 px of GPointPrecise are culled instead of wrapping around onto the screen, and slow
+// particles keep their sub-pixel motion
+uint16_t gparticle_system_step(GParticleSystem *system, const GParticleEmitter *emitter,
+                               const GTransform *camera, GBitmap *dest, GRect clip,
+                               uint8_t color) {
+  if (!system) {
+    return 0;
+  }
+
+  if (emitter) {
+    gparticle_system_emit(system, emitter, emitter->rate);
+  }
+
+  const GTransform t = camera ? *camera : GTransformIdentity();
+
+  uint8_t *data = NULL;
+  uint16_t bytes_per_row = 0;
+  GBitmapFormat format = GBitmapFormat1Bit;
+  if (dest) {
+    format = gbitmap_get_format(dest);
+    if ((format == GBitmapFormat1Bit) || (format == GBitmapFormat8Bit)) {
+      data = gbitmap_get_data(dest);
+      bytes_per_row = gbitmap_get_bytes_per_row(dest);
+      clip = grect_intersection(clip, gbitmap_get_bounds(dest));
+    }
+  }
+  color = gbitmap_pixel_color(format, color);
+  const int32_t clip_x0 = clip.origin.x;
+  const int32_t clip_y0 = clip.origin.y;
+  const int32_t clip_x1 = clip.origin.x + clip.size.w;
+  const int32_t clip_y1 = clip.origin.y + clip.size.h;
+
+  uint16_t num_visible = 0;
+  uint16_t i = 0;
+  while (i < system->num_particles) {
+    system->dx[i].raw_value += system->ax.raw_value;
+    system->dy[i].raw_value += system->ay.raw_value;
+    system->x[i].raw_value += system->dx[i].raw_value;
+    system->y[i].raw_value += system->dy[i].raw_value;
+
+    const int64_t x = system->x[i].raw_value;
+    const int64_t y = system->y[i].raw_value;
+    const int64_t screen_x = ((x * t.a.raw_value + y * t.c.raw_value) >> FIXED_S32_16_PRECISION) +
+                             t.tx.raw_value;
+    const int64_t screen_y = ((x * t.b.raw_value + y * t.d.raw_value) >> FIXED_S32_16_PRECISION) +
+                             t.ty.raw_value;
+    const int64_t pixel_x = screen_x >> FIXED_S32_16_PRECISION;
+    const int64_t pixel_y = screen_y >> FIXED_S32_16_PRECISION;
+
+    if ((pixel_x >= clip_x0) && (pixel_y >= clip_y0) && (pixel_x < clip_x1) &&
+        (pixel_y < clip_y1)) {
+      num_visible++;
+      if (data) {
+        gbitmap_pixel_plot(data + pixel_y * bytes_per_row, format, pixel_x, color);
+      }
+    }
+
+    // Aged after drawing, so that a particle is drawn in each of the frames of its life
+    if (--system->life[i] == 0) {
+      prv_remove(system, i);
+    } else {
+      i++;
+    }
+  }
+  return num_visible;
+}
+
+uint16_t framebuffer_step_particle_system(GContext *ctx, GParticleSystem *system,
+                                          const GParticleEmitter *emitter, const GTransform *camera,
+                                          uint8_t color) {
+  GBitmap *framebuffer = ctx ? graphics_capture_frame_buffer(ctx) : NULL;
+  if (!framebuffer) {
+    return 0;
+  }
+
+  const uint16_t num_visible = gparticle_system_step(system, emitter, camera, framebuffer,
+                                                     gbitmap_get_bounds(framebuffer), color);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  return num_visible;
+}
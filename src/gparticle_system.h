@@ -0,0 +1,114 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsParticleSystem Particle Systems
+//! \brief Fixed capacity pools of moving points, such as sparks, snow or star fields, that are
+//! simulated and drawn in a single pass per frame.
+//!
+//! The particles live in caller provided storage in structure-of-arrays layout, one array per
+//! component, so nothing is allocated after initialization and a frame always costs the same
+//! for the same number of particles. Positions and velocities are Fixed_S32_16 and are
+//! integrated with integer adds only. Every frame, gparticle_system_step emits new particles,
+//! moves all of them, transforms them with one camera matrix, skips those outside the clip
+//! rectangle and draws the rest, visiting each particle once.
+//!     @{
+
+//! Number of uint32_t words of storage that a particle system of the given capacity needs
+#define GPARTICLE_SYSTEM_STORAGE_WORDS(capacity) \
+  ((4 * (size_t)(capacity)) + (((size_t)(capacity) + 1) / 2))
+
+//! Describes where new particles appear and how they move
+typedef struct GParticleEmitter {
+  //! Position of new particles, in world coordinates
+  Fixed_S32_16 x;
+  Fixed_S32_16 y;
+  //! Velocity of new particles, in pixels per frame
+  Fixed_S32_16 dx;
+  Fixed_S32_16 dy;
+  //! Largest random change of each velocity component, in pixels per frame
+  Fixed_S32_16 spread;
+  //! Number of frames new particles live; emitters with a life of 0 emit nothing
+  uint16_t life;
+  //! Number of particles emitted per frame
+  uint16_t rate;
+} GParticleEmitter;
+
+//! A particle system backed by caller provided storage
+typedef struct GParticleSystem {
+  //! Positions of the particles, in world coordinates
+  Fixed_S32_16 *x;
+  Fixed_S32_16 *y;
+  //! Velocities of the particles, in pixels per frame
+  Fixed_S32_16 *dx;
+  Fixed_S32_16 *dy;
+  //! Frames that each particle has left to live
+  uint16_t *life;
+  //! Added to every velocity each frame, e.g. gravity
+  Fixed_S32_16 ax;
+  Fixed_S32_16 ay;
+  //! Number of particles alive; they are always the first ones of the arrays
+  uint16_t num_particles;
+  //! Number of particles the storage can hold
+  uint16_t capacity;
+  //! @internal
+  //! State of the random generator that spreads the velocities of new particles
+  uint32_t seed;
+} GParticleSystem;
+
+//! Initializes an empty particle system without acceleration.
+//! @param system Pointer to the particle system to initialize
+//! @param storage Pointer to GPARTICLE_SYSTEM_STORAGE_WORDS(capacity) words of storage, which
+//! must stay valid as long as the system is used
+//! @param capacity Number of particles the storage can hold
+void gparticle_system_init(GParticleSystem *system, uint32_t *storage, uint16_t capacity);
+
+//! Removes all particles.
+//! @param system Pointer to the particle system
+void gparticle_system_clear(GParticleSystem *system);
+
+//! Adds particles without stepping the system, e.g. for a burst when something explodes.
+//! @param system Pointer to the particle system
+//! @param emitter Pointer to the emitter that describes the new particles
+//! @param count Number of particles to add
+//! @return Number of particles added, which is less than count once the system is full.
+uint16_t gparticle_system_emit(GParticleSystem *system, const GParticleEmitter *emitter,
+                               uint16_t count);
+
+//! Advances the particle system by one frame and draws it. First emitter->rate particles are
+//! emitted, as far as there is room. Then each particle is accelerated, moved by its velocity,
+//! transformed by the camera and drawn as a single pixel if it lands within the clip rectangle.
+//! Finally it ages by one frame and is removed once its life is over, so a particle emitted
+//! with a life of n is drawn in n frames, starting with the one it is emitted in. A transformed
+//! position of n.0 is in pixel n, as GPointFromGPointPrecise rounds it.
+//! @param system Pointer to the particle system
+//! @param emitter Pointer to the emitter; NULL to emit nothing
+//! @param camera Pointer to the matrix from world to screen coordinates; if NULL the identity
+//! is used.
+//! @param dest Pointer to the bitmap to draw into, in GBitmapFormat1Bit or GBitmapFormat8Bit;
+//! if NULL or in another format, the particles are only moved and counted.
+//! @param clip Rectangle of dest that may be modified
+//! @param color Raw pixel value to draw, as for the precise drawing functions
+//! @return Number of particles within the clip rectangle.
+uint16_t gparticle_system_step(GParticleSystem *system, const GParticleEmitter *emitter,
+                               const GTransform *camera, GBitmap *dest, GRect clip,
+                               uint8_t color);
+
+//! Advances a particle system by one frame and draws it straight into the framebuffer of a
+//! graphics context, in screen coordinates as framebuffer_draw_line_precise.
+//! See gparticle_system_step for details.
+//! @return Number of particles on screen; 0 if the framebuffer could not be captured, in which
+//! case the system is not stepped.
+uint16_t framebuffer_step_particle_system(GContext *ctx, GParticleSystem *system,
+                                          const GParticleEmitter *emitter, const GTransform *camera,
+                                          uint8_t color);
+
+//!     @} // end addtogroup GraphicsParticleSystem
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
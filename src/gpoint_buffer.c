@@ -0,0 +1,213 @@
+#include <pebble.h>
+
+#include "gpoint_buffer.h"
+#include "gtransform_checked.h"
+#include "gtransform_simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Rounds a number of points up so that an array of that many coordinates keeps the next array
+// aligned
+static size_t prv_aligned_count(size_t n) {
+  const size_t per_alignment = GPOINT_BUFFER_ALIGNMENT / sizeof(Fixed_S16_3);
+  return ((n + per_alignment - 1) / per_alignment) * per_alignment;
+}
+
+GPointBufferSoA *gpoint_buffer_create(size_t capacity) {
+  const size_t stride = prv_aligned_count(capacity);
+  if (stride > (SIZE_MAX - sizeof(GPointBufferSoA) - GPOINT_BUFFER_ALIGNMENT) /
+               (2 * sizeof(Fixed_S16_3))) {
+    return NULL;
+  }
+
+  // The buffer, padding up to the alignment, then the x and y arrays in a single allocation
+  const size_t size = sizeof(GPointBufferSoA) + GPOINT_BUFFER_ALIGNMENT +
+                      (2 * stride * sizeof(Fixed_S16_3));
+  GPointBufferSoA *buffer = malloc(size);
+  if (!buffer) {
+    return NULL;
+  }
+
+  uintptr_t data = (uintptr_t)(buffer + 1);
+  data = (data + GPOINT_BUFFER_ALIGNMENT - 1) & ~(uintptr_t)(GPOINT_BUFFER_ALIGNMENT - 1);
+
+  *buffer = (GPointBufferSoA) {
+    .x = (Fixed_S16_3 *)data,
+    .y = (Fixed_S16_3 *)data + stride,
+    .num_points = 0,
+    .capacity = capacity,
+  };
+  return buffer;
+}
+
+void gpoint_buffer_destroy(GPointBufferSoA *buffer) {
+  free(buffer);
+}
+
+bool gpoint_buffer_set_points(GPointBufferSoA *buffer, const GPoint *points, size_t n) {
+  if ((!buffer) || (!points && n) || (n > buffer->capacity)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    const GPointPrecise pointP = GPointPreciseFromGPoint(points[i]);
+    buffer->x[i] = pointP.x;
+    buffer->y[i] = pointP.y;
+  }
+  buffer->num_points = n;
+  return true;
+}
+
+bool gpoint_buffer_set_points_precise(GPointBufferSoA *buffer, const GPointPrecise *points,
+                                      size_t n) {
+  if ((!buffer) || (!points && n) || (n > buffer->capacity)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    buffer->x[i] = points[i].x;
+    buffer->y[i] = points[i].y;
+  }
+  buffer->num_points = n;
+  return true;
+}
+
+size_t gpoint_buffer_get_points(const GPointBufferSoA *buffer, GPoint *points_out, size_t n) {
+  if ((!buffer) || (!points_out)) {
+    return 0;
+  }
+
+  const size_t count = (n < buffer->num_points) ? n : buffer->num_points;
+  for (size_t i = 0; i < count; i++) {
+    points_out[i] = GPoint(buffer->x[i].raw_value >> GPOINT_PRECISE_PRECISION,
+                           buffer->y[i].raw_value >> GPOINT_PRECISE_PRECISION);
+  }
+  return count;
+}
+
+size_t gpoint_buffer_get_points_precise(const GPointBufferSoA *buffer, GPointPrecise *points_out,
+                                        size_t n) {
+  if ((!buffer) || (!points_out)) {
+    return 0;
+  }
+
+  const size_t count = (n < buffer->num_points) ? n : buffer->num_points;
+  for (size_t i = 0; i < count; i++) {
+    points_out[i] = GPointPrecise(buffer->x[i].raw_value, buffer->y[i].raw_value);
+  }
+  return count;
+}
+
+//////////////////////////////////////
+/// Axis Kernels
+//////////////////////////////////////
+#if !defined(GTRANSFORM_CHECKED)
+// Each kernel reads and writes a single contiguous coordinate array of raw 16-bit values. Whole
+// vectors go through the vectorized kernels and the remainder through the scalar loops. Checked
+// builds transform every point with gtransform_checked_point_transform instead.
+static void prv_axis_copy(int16_t *out, const int16_t *in, size_t n) {
+  if (out != in) {
+    memmove(out, in, n * sizeof(*out));
+  }
+}
+
+static void prv_axis_translate(int16_t *out, const int16_t *in, size_t n, int16_t offset) {
+  if (offset == 0) {
+    prv_axis_copy(out, in, n);
+    return;
+  }
+
+  // Scaling by one is exact, so the vectorized scale kernel also handles pure translations
+  const size_t num_vectorized = gtransform_simd_scale_translate_axis(GTransformNumberOne,
+                                                                     Fixed_S16_3(offset),
+                                                                     in, out, n);
+  for (size_t i = num_vectorized; i < n; i++) {
+    out[i] = in[i] + offset;
+  }
+}
+
+// Same arithmetic as Fixed_S16_3_S32_16_mul followed by Fixed_S16_3_add
+static void prv_axis_scale_translate(int16_t *out, const int16_t *in, size_t n,
+                                     GTransformNumber scale, int16_t offset) {
+  if (scale.raw_value == GTransformNumberOne.raw_value) {
+    prv_axis_translate(out, in, n, offset);
+    return;
+  }
+
+  const int32_t s = scale.raw_value;
+  const size_t num_vectorized = gtransform_simd_scale_translate_axis(scale, Fixed_S16_3(offset),
+                                                                     in, out, n);
+  for (size_t i = num_vectorized; i < n; i++) {
+    out[i] = (int16_t)(((int32_t)in[i] * s) >> FIXED_S32_16_PRECISION) + offset;
+  }
+}
+#endif
+
+bool gpoint_buffer_transform(GPointBufferSoA *dest, const GPointBufferSoA *src,
+                             const GTransform *t) {
+  if ((!dest) || (!src) || (dest->capacity < src->num_points)) {
+    return false;
+  }
+
+  const size_t n = src->num_points;
+  // Fixed_S16_3 is a plain 16-bit value, the arrays are aligned by gpoint_buffer_create
+  int16_t *out_x = (int16_t *)dest->x;
+  int16_t *out_y = (int16_t *)dest->y;
+  const int16_t *in_x = (const int16_t *)src->x;
+  const int16_t *in_y = (const int16_t *)src->y;
+  dest->num_points = n;
+
+  const GTransform identity = GTransformIdentity();
+  if (!t) {
+    t = &identity;
+  }
+
+#if defined(GTRANSFORM_CHECKED)
+  for (size_t i = 0; i < n; i++) {
+    const GPointPrecise pointP = gtransform_checked_point_transform(
+        GTransformCheckedFunctionPointBufferTransform, GPointPrecise(in_x[i], in_y[i]), t);
+    out_x[i] = pointP.x.raw_value;
+    out_y[i] = pointP.y.raw_value;
+  }
+  return true;
+#else
+  const int16_t one_tx = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, t->tx).raw_value;
+  const int16_t one_ty = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, t->ty).raw_value;
+
+  switch (gtransform_classify(t)) {
+    case GTransformClassIdentity:
+      prv_axis_copy(out_x, in_x, n);
+      prv_axis_copy(out_y, in_y, n);
+      return true;
+    case GTransformClassTranslation:
+      prv_axis_translate(out_x, in_x, n, one_tx);
+      prv_axis_translate(out_y, in_y, n, one_ty);
+      return true;
+    case GTransformClassScale:
+    case GTransformClassScaleTranslation:
+      prv_axis_scale_translate(out_x, in_x, n, t->a, one_tx);
+      prv_axis_scale_translate(out_y, in_y, n, t->d, one_ty);
+      return true;
+    default:
+      break;
+  }
+
+  const int32_t a = t->a.raw_value;
+  const int32_t b = t->b.raw_value;
+  const int32_t c = t->c.raw_value;
+  const int32_t d = t->d.raw_value;
+  const size_t num_vectorized = gtransform_simd_transform_axes(t, Fixed_S16_3(one_tx),
+                                                               Fixed_S16_3(one_ty), in_x, in_y,
+                                                               out_x, out_y, n);
+  for (size_t i = num_vectorized; i < n; i++) {
+    const int32_t x = in_x[i];
+    const int32_t y = in_y[i];
+    out_x[i] = (int16_t)((x * a) >> FIXED_S32_16_PRECISION) +
+               (int16_t)((y * c) >> FIXED_S32_16_PRECISION) + one_tx;
+    out_y[i] = (int16_t)((x * b) >> FIXED_S32_16_PRECISION) +
+               (int16_t)((y * d) >> FIXED_S32_16_PRECISION) + one_ty;
+  }
+  return true;
+#endif
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsPointBuffer Point Buffers
+//! \brief Large sets of precise points stored as separate x and y arrays.
+//!
+//! Keeping each axis contiguous lets a transform that only scales or translates touch one array
+//! at a time, skip an axis that it does not change, and lets the compiler vectorize the loops.
+//! Both arrays are aligned to GPOINT_BUFFER_ALIGNMENT bytes.
+//!     @{
+
+//! Alignment in bytes of the coordinate arrays of a point buffer
+#define GPOINT_BUFFER_ALIGNMENT 16
+
+//! A set of precise points in structure-of-arrays layout
+typedef struct GPointBufferSoA {
+  //! The x-coordinates of the points
+  Fixed_S16_3 *x;
+  //! The y-coordinates of the points
+  Fixed_S16_3 *y;
+  //! Number of points in use
+  size_t num_points;
+  //! Number of points the buffer can hold
+  size_t capacity;
+} GPointBufferSoA;
+
+//! Creates an empty point buffer. Both coordinate arrays are allocated together with the buffer.
+//! @param capacity Number of points the buffer can hold
+//! @return Pointer to the new buffer; NULL if it could not be allocated.
+GPointBufferSoA *gpoint_buffer_create(size_t capacity);
+
+//! Destroys a point buffer previously created with gpoint_buffer_create.
+//! @param buffer Pointer to the buffer to destroy
+void gpoint_buffer_destroy(GPointBufferSoA *buffer);
+
+//! Replaces the content of the buffer with the given points, converted to GPointPrecise.
+//! @param buffer Pointer to the buffer
+//! @param points Pointer to the points to store
+//! @param n Number of points
+//! @return `true` if the points were stored, `false` if they do not fit or an argument is NULL.
+bool gpoint_buffer_set_points(GPointBufferSoA *buffer, const GPoint *points, size_t n);
+
+//! Replaces the content of the buffer with the given precise points.
+//! @param buffer Pointer to the buffer
+//! @param points Pointer to the precise points to store
+//! @param n Number of points
+//! @return `true` if the points were stored, `false` if they do not fit or an argument is NULL.
+bool gpoint_buffer_set_points_precise(GPointBufferSoA *buffer, const GPointPrecise *points,
+                                      size_t n);
+
+//! Copies the points of the buffer to an array of GPoint, dropping the fractional bits.
+//! @param buffer Pointer to the buffer
+//! @param points_out Pointer to the destination array
+//! @param n Number of points the destination array can hold
+//! @return Number of points copied.
+size_t gpoint_buffer_get_points(const GPointBufferSoA *buffer, GPoint *points_out, size_t n);
+
+//! Copies the points of the buffer to an array of GPointPrecise.
+//! @param buffer Pointer to the buffer
+//! @param points_out Pointer to the destination array
+//! @param n Number of points the destination array can hold
+//! @return Number of points copied.
+size_t gpoint_buffer_get_points_precise(const GPointBufferSoA *buffer, GPointPrecise *points_out,
+                                        size_t n);
+
+//! Transforms every point of a buffer. Each point gives the same result as
+//! gpointprecise_transform, but matrices without rotation or shear are applied one axis at a
+//! time and an axis they leave unchanged is not touched when transforming in place. Checked
+//! builds (GTRANSFORM_CHECKED) transform and count every point one at a time instead.
+//! @param dest Pointer to the buffer receiving the transformed points; may be the same as src.
+//! @param src Pointer to the buffer with the points to transform
+//! @param t Pointer to the transformation matrix; if NULL the identity is used.
+//! @return `true` if the points were transformed, `false` if dest is too small or a buffer is
+//! NULL.
+bool gpoint_buffer_transform(GPointBufferSoA *dest, const GPointBufferSoA *src,
+                             const GTransform *t);
+
+//!     @} // end addtogroup GraphicsPointBuffer
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -1,6 +1,8 @@
 #include <pebble.h>
 
 #include "gtransform.h"
+#include "gtransform_checked.h"
+#include "gtransform_simd.h"
 
 #include <string.h>
 
@@ -27,6 +29,87 @@ GTransform gtransform_init_rotation(int32_t angle) {
   }
 }
 
+#define ROTATION_TABLE_SHIFT (16 - GTRANSFORM_ROTATION_TABLE_BITS)
+#define ROTATION_TABLE_QUARTER (TRIG_MAX_ANGLE / 4)
+#define ROTATION_TABLE_SIZE ((ROTATION_TABLE_QUARTER >> ROTATION_TABLE_SHIFT) + 1)
+
+// Quarter wave of sine values (0 to 90 degrees inclusive) in GTransformNumber format
+static int32_t s_rotation_table[ROTATION_TABLE_SIZE];
+static bool s_rotation_table_initialized;
+
+// The entries use the same conversion as gtransform_init_rotation so that angles which fall
+// exactly on a table entry produce identical matrices.
+static void prv_rotation_table_init(void) {
+  for (int i = 0; i < ROTATION_TABLE_SIZE; i++) {
+    int32_t sine = sin_lookup(i << ROTATION_TABLE_SHIFT);
+    s_rotation_table[i] = (sine * ((int64_t)GTransformNumberOne.raw_value)) / TRIG_MAX_RATIO;
+  }
+  s_rotation_table_initialized = true;
+}
+
+// Interpolates sine for an angle within the first quarter wave (0..ROTATION_TABLE_QUARTER)
+static int32_t prv_rotation_table_quarter_sin(int32_t angle) {
+  const int32_t index = angle >> ROTATION_TABLE_SHIFT;
+  const int32_t fraction = angle & ((1 << ROTATION_TABLE_SHIFT) - 1);
+  if (fraction == 0) {
+    return s_rotation_table[index];
+  }
+
+  const int32_t delta = s_rotation_table[index + 1] - s_rotation_table[index];
+  return s_rotation_table[index] +
+         ((delta * fraction + (1 << (ROTATION_TABLE_SHIFT - 1))) >> ROTATION_TABLE_SHIFT);
+}
+
+static int32_t prv_rotation_table_sin(int32_t angle) {
+  angle &= (TRIG_MAX_ANGLE - 1);
+  const int32_t quadrant = angle / ROTATION_TABLE_QUARTER;
+  const int32_t remainder = angle % ROTATION_TABLE_QUARTER;
+
+  switch (quadrant) {
+    case 0:
+      return prv_rotation_table_quarter_sin(remainder);
+    case 1:
+      return prv_rotation_table_quarter_sin(ROTATION_TABLE_QUARTER - remainder);
+    case 2:
+      return -prv_rotation_table_quarter_sin(remainder);
+    default:
+      return -prv_rotation_table_quarter_sin(ROTATION_TABLE_QUARTER - remainder);
+  }
+}
+
+GTransform gtransform_init_rotation_cached(int32_t angle) {
+  if (angle == 0) {
+    return GTransformIdentity();
+  }
+
+  if (!s_rotation_table_initialized) {
+    prv_rotation_table_init();
+  }
+
+  const int32_t sine_val = prv_rotation_table_sin(angle);
+  const int32_t cosine_val = prv_rotation_table_sin(angle + ROTATION_TABLE_QUARTER);
+  GTransformNumber a = (GTransformNumber) { .raw_value = cosine_val };
+  GTransformNumber b = (GTransformNumber) { .raw_value = -sine_val };
+  GTransformNumber c = (GTransformNumber) { .raw_value = sine_val };
+  GTransformNumber d = (GTransformNumber) { .raw_value = cosine_val };
+  return GTransform(a, b, c, d, GTransformNumberZero, GTransformNumberZero);
+}
+
+// With row vectors, scale then rotate then translate is S*R*T. S*R only scales the rows of R
+// so each coefficient is a single product, and T only replaces the last row.
+GTransform gtransform_init_trs(GTransformNumber sx, GTransformNumber sy, int32_t angle,
+                               GTransformNumber tx, GTransformNumber ty) {
+  GTransform t = gtransform_init_rotation_cached(angle);
+
+  t.a = Fixed_S32_16_mul(sx, t.a);
+  t.b = Fixed_S32_16_mul(sx, t.b);
+  t.c = Fixed_S32_16_mul(sy, t.c);
+  t.d = Fixed_S32_16_mul(sy, t.d);
+  t.tx = tx;
+  t.ty = ty;
+  return t;
+}
+
 //////////////////////////////////////
 /// Evaluating Transforms
 //////////////////////////////////////
@@ -79,8 +162,8 @@ bool gtransform_is_only_scale_or_translation(const GTransform * const t) {
     return false;
   }
 
-  if ((t->b.raw_value != GTransformNumberZero.raw_value) ||
-      (t->c.raw_value != GTransformNumberZero.raw_value)) {
+  if ((t->b.raw_value == GTransformNumberZero.raw_value) &&
+      (t->c.raw_value == GTransformNumberZero.raw_value)) {
     return true;
   }
 
@@ -105,6 +188,12 @@ void gtransform_concat(GTransform *t_new, const GTransform *t1, const GTransform
     return;
   }
 
+#if defined(GTRANSFORM_CHECKED)
+  gtransform_checked_concat(t_new, t1, t2);
+#else
+  // Always the full product: classifying the operands would cost more than the multiplies it
+  // saves for the rotated matrices this is mostly used with. Matrices that are applied many
+  // times are classified once by gtransform_prepare instead.
   Fixed_S32_16 a_a = Fixed_S32_16_mul(t1->a, t2->a);
   Fixed_S32_16 b_c = Fixed_S32_16_mul(t1->b, t2->c);
 
@@ -129,6 +218,36 @@ void gtransform_concat(GTransform *t_new, const GTransform *t1, const GTransform
   t_new->d = Fixed_S32_16_add(c_b, d_d);
   t_new->tx = Fixed_S32_16_add3(tx_a, ty_c, t2->tx);
   t_new->ty = Fixed_S32_16_add3(tx_b, ty_d, t2->ty);
+#endif
+}
+
+// Each coefficient is a sum of full 32.32 products that is rounded once at the end, so its
+// error is at most half a step no matter how the products would have truncated.
+static int32_t prv_dot_round(int64_t p1, int64_t q1, int64_t p2, int64_t q2, int64_t offset) {
+  const int64_t sum = (p1 * q1) + (p2 * q2) + (offset * GTransformNumberOne.raw_value);
+  return (int32_t)((sum + (1 << (FIXED_S32_16_PRECISION - 1))) >> FIXED_S32_16_PRECISION);
+}
+
+void gtransform_concat_rounded(GTransform *t_new, const GTransform *t1, const GTransform *t2) {
+  if ((!t_new) || (!t1) || (!t2)) {
+    return;
+  }
+
+  const GTransform t = {
+    .a = Fixed_S32_16(prv_dot_round(t1->a.raw_value, t2->a.raw_value,
+                                    t1->b.raw_value, t2->c.raw_value, 0)),
+    .b = Fixed_S32_16(prv_dot_round(t1->a.raw_value, t2->b.raw_value,
+                                    t1->b.raw_value, t2->d.raw_value, 0)),
+    .c = Fixed_S32_16(prv_dot_round(t1->c.raw_value, t2->a.raw_value,
+                                    t1->d.raw_value, t2->c.raw_value, 0)),
+    .d = Fixed_S32_16(prv_dot_round(t1->c.raw_value, t2->b.raw_value,
+                                    t1->d.raw_value, t2->d.raw_value, 0)),
+    .tx = Fixed_S32_16(prv_dot_round(t1->tx.raw_value, t2->a.raw_value,
+                                     t1->ty.raw_value, t2->c.raw_value, t2->tx.raw_value)),
+    .ty = Fixed_S32_16(prv_dot_round(t1->tx.raw_value, t2->b.raw_value,
+                                     t1->ty.raw_value, t2->d.raw_value, t2->ty.raw_value)),
+  };
+  *t_new = t;
 }
 
 void gtransform_scale(GTransform *t_new, GTransform *t, GTransformNumber sx, GTransformNumber sy) {
@@ -136,6 +255,9 @@ void gtransform_scale(GTransform *t_new, GTransform *t, GTransformNumber sx, GTr
     return;
   }
 
+#if defined(GTRANSFORM_CHECKED)
+  gtransform_checked_scale(t_new, t, sx, sy);
+#else
   // Copy over t to t_new and update as necessary
   if (t_new != t) {
     memcpy(t_new, t, sizeof(GTransform));
@@ -150,6 +272,7 @@ void gtransform_scale(GTransform *t_new, GTransform *t, GTransformNumber sx, GTr
   // Scale Y vector (c and d)
   t_new->c = Fixed_S32_16_mul(sy, t->c);
   t_new->d = Fixed_S32_16_mul(sy, t->d);
+#endif
 }
 
 void gtransform_translate(GTransform *t_new, GTransform *t,
@@ -158,6 +281,9 @@ void gtransform_translate(GTransform *t_new, GTransform *t,
     return;
   }
 
+#if defined(GTRANSFORM_CHECKED)
+  gtransform_checked_translate(t_new, t, tx, ty);
+#else
   // Copy over t to t_new and update as necessary
   if (t_new != t) {
     memcpy(t_new, t, sizeof(GTransform));
@@ -172,6 +298,7 @@ void gtransform_translate(GTransform *t_new, GTransform *t,
 
   t_new->tx = Fixed_S32_16_add3(tx_a, ty_c, t->tx);
   t_new->ty = Fixed_S32_16_add3(tx_b, ty_d, t->ty);
+#endif
 }
 
 void gtransform_rotate(GTransform *t_new, GTransform *t, int32_t angle) {
@@ -184,26 +311,309 @@ void gtransform_rotate(GTransform *t_new, GTransform *t, int32_t angle) {
   gtransform_concat(t_new, &tR, t);
 }
 
-bool gtransform_invert(GTransform *t_new, GTransform *t) {
+void gtransform_rotate_cached(GTransform *t_new, GTransform *t, int32_t angle) {
   if ((!t_new) || (!t)) {
+    return;
+  }
+
+  // t_new = tr*t
+  GTransform tR = gtransform_init_rotation_cached(angle);
+  gtransform_concat(t_new, &tR, t);
+}
+
+// gtransform_init_rotation truncates sine and cosine towards zero, which makes every rotation
+// shrink slightly; rounding them keeps the length of the rows within half a step of one. That
+// removes the bias of a single rotation, not the drift of a long chain of them, which only
+// gtransform_orthonormalize bounds.
+static int32_t prv_trig_round(int32_t ratio) {
+  const int64_t scaled = (int64_t)ratio * GTransformNumberOne.raw_value;
+  const int64_t half = (scaled < 0) ? -(TRIG_MAX_RATIO / 2) : (TRIG_MAX_RATIO / 2);
+  return (int32_t)((scaled + half) / TRIG_MAX_RATIO);
+}
+
+void gtransform_rotate_rounded(GTransform *t_new, GTransform *t, int32_t angle) {
+  if ((!t_new) || (!t)) {
+    return;
+  }
+
+  const int32_t cosine_val = prv_trig_round(cos_lookup(angle));
+  const int32_t sine_val = prv_trig_round(sin_lookup(angle));
+  const GTransform tR = GTransform(Fixed_S32_16(cosine_val), Fixed_S32_16(-sine_val),
+                                   Fixed_S32_16(sine_val), Fixed_S32_16(cosine_val),
+                                   GTransformNumberZero, GTransformNumberZero);
+
+  // t_new = tr*t
+  gtransform_concat_rounded(t_new, &tR, t);
+}
+
+// Rotating about a pivot is T(-p)*R*T(p). The linear part is just R and the translation
+// collapses to p - p*R, so the matrix is built without any full concatenation.
+void gtransform_rotate_about_point(GTransform *t_new, GTransform *t, int32_t angle,
+                                   GPoint pivot) {
+  if ((!t_new) || (!t)) {
+    return;
+  }
+
+  const GTransformNumber px = GTransformNumberFromNumber(pivot.x);
+  const GTransformNumber py = GTransformNumberFromNumber(pivot.y);
+
+  GTransform tR = gtransform_init_rotation_cached(angle);
+  Fixed_S32_16 px_a = Fixed_S32_16_mul(px, tR.a);
+  Fixed_S32_16 py_c = Fixed_S32_16_mul(py, tR.c);
+
+  Fixed_S32_16 px_b = Fixed_S32_16_mul(px, tR.b);
+  Fixed_S32_16 py_d = Fixed_S32_16_mul(py, tR.d);
+
+  tR.tx = Fixed_S32_16(px.raw_value - px_a.raw_value - py_c.raw_value);
+  tR.ty = Fixed_S32_16(py.raw_value - px_b.raw_value - py_d.raw_value);
+
+  // t_new = tr*t
+  gtransform_concat(t_new, &tR, t);
+}
+
+void gtransform_scale_about_point(GTransform *t_new, GTransform *t,
+                                  GTransformNumber sx, GTransformNumber sy, GPoint pivot) {
+  if ((!t_new) || (!t)) {
+    return;
+  }
+
+  const GTransformNumber px = GTransformNumberFromNumber(pivot.x);
+  const GTransformNumber py = GTransformNumberFromNumber(pivot.y);
+
+  GTransform tS = GTransformScale(sx, sy);
+  tS.tx = Fixed_S32_16(px.raw_value - Fixed_S32_16_mul(px, sx).raw_value);
+  tS.ty = Fixed_S32_16(py.raw_value - Fixed_S32_16_mul(py, sy).raw_value);
+
+  // t_new = t_scale*t
+  gtransform_concat(t_new, &tS, t);
+}
+
+// Computes round(num * 2^shift / den) using restoring division on the magnitudes so that the
+// intermediate never needs more than 64 bits. Returns false if the result does not fit in a
+// Fixed_S32_16.
+static bool prv_div_round(int64_t num, int64_t den, int shift, Fixed_S32_16 *result) {
+  const bool negative = ((num < 0) != (den < 0));
+  const uint64_t n = (num < 0) ? -(uint64_t)num : (uint64_t)num;
+  const uint64_t d = (den < 0) ? -(uint64_t)den : (uint64_t)den;
+  const uint64_t limit = (uint64_t)INT32_MAX + (negative ? 1 : 0);
+
+  uint64_t q = n / d;
+  uint64_t r = n % d;
+  for (int i = 0; i < shift; i++) {
+    if (q > limit) {
+      return false;
+    }
+    q <<= 1;
+    r <<= 1;
+    if (r >= d) {
+      r -= d;
+      q |= 1;
+    }
+  }
+
+  // Round half away from zero
+  if (r >= d - r) {
+    q++;
+  }
+
+  if (q > limit) {
     return false;
   }
 
-  memcpy(t_new, t, sizeof(GTransform));
-  // FIXME: NYI - copy original into t_new for now
-  return false;
+  result->raw_value = negative ? (int32_t)(-(int64_t)q) : (int32_t)q;
+  return true;
+}
+
+// Returns ceil(2^126 / divisor) for a divisor normalized to [2^63, 2^64), which lies in
+// [2^62, 2^63]. The long division runs once per inversion; every coefficient is then a multiply.
+static uint64_t prv_reciprocal_ceil(uint64_t divisor) {
+  // Divides 2^126 - 1, whose top 62 bits start the remainder and whose low 64 bits are all ones
+  uint64_t r = ((uint64_t)1 << 62) - 1;
+  uint64_t q = 0;
+  for (int i = 0; i < 64; i++) {
+    const bool carry = (r >> 63) != 0;
+    r = (r << 1) | 1;
+    q <<= 1;
+    if (carry || (r >= divisor)) {
+      r -= divisor;
+      q |= 1;
+    }
+  }
+  return q + 1;
+}
+
+// Computes round(num * reciprocal / 2^shift) from the full 128-bit product, built from 32-bit
+// halves so that no 128-bit type is needed. Returns false if the result does not fit in a
+// Fixed_S32_16.
+static bool prv_mul_shift_round(int64_t num, uint64_t reciprocal, int shift,
+                                Fixed_S32_16 *result) {
+  const bool negative = (num < 0);
+  const uint64_t n = negative ? -(uint64_t)num : (uint64_t)num;
+  const uint64_t limit = (uint64_t)INT32_MAX + (negative ? 1 : 0);
+
+  const uint64_t n_lo = (uint32_t)n;
+  const uint64_t n_hi = n >> 32;
+  const uint64_t r_lo = (uint32_t)reciprocal;
+  const uint64_t r_hi = reciprocal >> 32;
+  const uint64_t lo_lo = n_lo * r_lo;
+  const uint64_t lo_hi = n_lo * r_hi;
+  const uint64_t hi_lo = n_hi * r_lo;
+  const uint64_t mid = (lo_lo >> 32) + (uint32_t)lo_hi + (uint32_t)hi_lo;
+  uint64_t lo = (mid << 32) | (uint32_t)lo_lo;
+  uint64_t hi = (n_hi * r_hi) + (lo_hi >> 32) + (hi_lo >> 32) + (mid >> 32);
+
+  // Round half away from zero
+  const uint64_t half_lo = (shift <= 64) ? ((uint64_t)1 << (shift - 1)) : 0;
+  const uint64_t half_hi = (shift <= 64) ? 0 : ((uint64_t)1 << (shift - 65));
+  lo += half_lo;
+  hi += half_hi + ((lo < half_lo) ? 1 : 0);
+
+  uint64_t q;
+  if (shift >= 64) {
+    q = hi >> (shift - 64);
+  } else if ((hi >> shift) != 0) {
+    return false;
+  } else {
+    q = (hi << (64 - shift)) | (lo >> shift);
+  }
+
+  if (q > limit) {
+    return false;
+  }
+
+  result->raw_value = negative ? (int32_t)(-(int64_t)q) : (int32_t)q;
+  return true;
+}
+
+// For t = [ a b 0 ; c d 0 ; tx ty 1 ] the inverse is
+// [ d -b 0 ; -c a 0 ; (c*ty - d*tx) (b*tx - a*ty) det ] / det where det = a*d - b*c.
+// The determinant is kept in 32.32 format and its reciprocal is computed once, rounded up to 63
+// significant bits, so each coefficient costs a multiply instead of a division. The reciprocal
+// is off by less than 2^-62 of its value, which keeps every coefficient within 2^-30 of a step
+// of the correctly rounded one. A matrix is treated as singular if the determinant is zero or
+// so close to zero that any inverted coefficient would not fit in a GTransformNumber.
+bool gtransform_invert(GTransform *t_new, const GTransform *t) {
+  if ((!t_new) || (!t)) {
+    return false;
+  }
+
+  const int64_t a = t->a.raw_value;
+  const int64_t b = t->b.raw_value;
+  const int64_t c = t->c.raw_value;
+  const int64_t d = t->d.raw_value;
+  const int64_t tx = t->tx.raw_value;
+  const int64_t ty = t->ty.raw_value;
+
+  const int64_t det = (a * d) - (b * c);
+  const int64_t tx_num = (c * ty) - (d * tx);
+  const int64_t ty_num = (b * tx) - (a * ty);
+
+  GTransform t_inv;
+  bool invertible = (det != 0);
+  if (invertible) {
+    // num / det * 2^shift is num * (2^126 / (|det| << leading_zeros)) / 2^(126 - leading_zeros
+    // - shift), with the sign of det moved onto the numerators
+    const uint64_t det_abs = (det < 0) ? -(uint64_t)det : (uint64_t)det;
+    const int leading_zeros = __builtin_clzll(det_abs);
+    const uint64_t reciprocal = prv_reciprocal_ceil(det_abs << leading_zeros);
+    const int sign = (det < 0) ? -1 : 1;
+    const int linear_shift = 126 - leading_zeros - 2 * FIXED_S32_16_PRECISION;
+    const int translation_shift = 126 - leading_zeros - FIXED_S32_16_PRECISION;
+    invertible =
+        prv_mul_shift_round(sign * d, reciprocal, linear_shift, &t_inv.a) &&
+        prv_mul_shift_round(sign * -b, reciprocal, linear_shift, &t_inv.b) &&
+        prv_mul_shift_round(sign * -c, reciprocal, linear_shift, &t_inv.c) &&
+        prv_mul_shift_round(sign * a, reciprocal, linear_shift, &t_inv.d) &&
+        prv_mul_shift_round(sign * tx_num, reciprocal, translation_shift, &t_inv.tx) &&
+        prv_mul_shift_round(sign * ty_num, reciprocal, translation_shift, &t_inv.ty);
+  }
+
+  if (!invertible) {
+    if (t_new != t) {
+      memcpy(t_new, t, sizeof(GTransform));
+    }
+    return false;
+  }
+
+  memcpy(t_new, &t_inv, sizeof(GTransform));
+  return true;
+}
+
+static int64_t prv_abs64(int64_t value) {
+  return (value < 0) ? -value : value;
+}
+
+// The first row is divided by its length and the second row is rebuilt as its perpendicular,
+// so the result is exactly orthogonal and only the length carries rounding error. Which of the
+// two perpendiculars is used follows the sign of the determinant, which preserves mirroring.
+// The first row is shifted so that its larger coefficient has 30 bits before taking the root,
+// which keeps the length accurate even for short rows.
+bool gtransform_orthonormalize(GTransform *t_new, const GTransform *t) {
+  if ((!t_new) || (!t)) {
+    return false;
+  }
+
+  const int64_t a = t->a.raw_value;
+  const int64_t b = t->b.raw_value;
+  const int64_t c = t->c.raw_value;
+  const int64_t d = t->d.raw_value;
+
+  int64_t a_norm = a;
+  int64_t b_norm = b;
+  if ((a != 0) || (b != 0)) {
+    while (prv_abs64(a_norm) < (1 << 29) && prv_abs64(b_norm) < (1 << 29)) {
+      a_norm *= 2;
+      b_norm *= 2;
+    }
+    while (prv_abs64(a_norm) >= (1 << 30) || prv_abs64(b_norm) >= (1 << 30)) {
+      a_norm /= 2;
+      b_norm /= 2;
+    }
+  }
+
+  const int64_t length = fixed_isqrt((uint64_t)(a_norm * a_norm) + (uint64_t)(b_norm * b_norm));
+  Fixed_S32_16 a_unit;
+  Fixed_S32_16 b_unit;
+  if ((length == 0) ||
+      !prv_div_round(a_norm, length, FIXED_S32_16_PRECISION, &a_unit) ||
+      !prv_div_round(b_norm, length, FIXED_S32_16_PRECISION, &b_unit)) {
+    if (t_new != t) {
+      memcpy(t_new, t, sizeof(GTransform));
+    }
+    return false;
+  }
+
+  const bool mirrored = ((a * d) - (b * c)) < 0;
+  t_new->a = a_unit;
+  t_new->b = b_unit;
+  t_new->c = Fixed_S32_16(mirrored ? b_unit.raw_value : -b_unit.raw_value);
+  t_new->d = Fixed_S32_16(mirrored ? -a_unit.raw_value : a_unit.raw_value);
+  t_new->tx = t->tx;
+  t_new->ty = t->ty;
+  return true;
 }
 
 //////////////////////////////////////
 /// Applying Transformations
 //////////////////////////////////////
 GPointPrecise gpoint_transform(GPoint point, const GTransform * const t) {
-  GPointPrecise pointP = GPointPreciseFromGPoint(point);
+#if defined(GTRANSFORM_CHECKED)
+  const GTransformCheckedFunction function = GTransformCheckedFunctionPointTransform;
+  const GPointPrecise pointP = gtransform_checked_point_from_gpoint(function, point);
+  return t ? gtransform_checked_point_transform(function, pointP, t) : pointP;
+#else
+  return gpointprecise_transform(GPointPreciseFromGPoint(point), t);
+#endif
+}
 
+GPointPrecise gpointprecise_transform(GPointPrecise pointP, const GTransform * const t) {
   if (!t) {
     return pointP;
   }
 
+#if defined(GTRANSFORM_CHECKED)
+  return gtransform_checked_point_transform(GTransformCheckedFunctionPointTransform, pointP, t);
+#else
   Fixed_S16_3 x_a = Fixed_S16_3_S32_16_mul(pointP.x, t->a);
   Fixed_S16_3 y_c = Fixed_S16_3_S32_16_mul(pointP.y, t->c);
   Fixed_S16_3 one_tx = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, t->tx);
@@ -216,9 +626,32 @@ GPointPrecise gpoint_transform(GPoint point, const GTransform * const t) {
   Fixed_S16_3 sum_y = Fixed_S16_3_add3(x_b, y_d, one_ty);
 
   return GPointPrecise(sum_x.raw_value, sum_y.raw_value);
+#endif
+}
+
+bool gpointprecise_inverse_transform(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                     const GTransform * const t) {
+  if ((!pointP_new) || (!t)) {
+    return false;
+  }
+
+  GTransform t_inv;
+  if (!gtransform_invert(&t_inv, t)) {
+    return false;
+  }
+
+  *pointP_new = gpointprecise_transform(pointP, &t_inv);
+  return true;
 }
 
 GVectorPrecise gvector_transform(GVector vector, const GTransform * const t) {
+#if defined(GTRANSFORM_CHECKED)
+  const GTransformCheckedFunction function = GTransformCheckedFunctionVectorTransform;
+  const GPointPrecise pointP =
+      gtransform_checked_point_from_gpoint(function, GPoint(vector.dx, vector.dy));
+  const GPointPrecise result = t ? gtransform_checked_point_transform(function, pointP, t) : pointP;
+  return GVectorPrecise(result.x.raw_value, result.y.raw_value);
+#else
   GVectorPrecise vectorP = GVectorPreciseFromGVector(vector);
 
   if (!t) {
@@ -237,4 +670,523 @@ GVectorPrecise gvector_transform(GVector vector, const GTransform * const t) {
   Fixed_S16_3 sum_y = Fixed_S16_3_add3(x_b, y_d, one_ty);
 
   return GVectorPrecise(sum_x.raw_value, sum_y.raw_value);
+#endif
+}
+
+// The matrix is classified once and the whole array goes through the kernel for its class,
+// which also holds the translation terms computed up front.
+void gpoint_transform_array(const GPoint *in, GPointPrecise *out, size_t n,
+                            const GTransform *t) {
+  if ((!in) || (!out)) {
+    return;
+  }
+
+  GTransformPrepared prepared;
+  gtransform_prepare(&prepared, t);
+  prepared.kernel(&prepared, in, out, n);
+}
+
+void gvector_transform_array(const GVector *in, GVectorPrecise *out, size_t n,
+                             const GTransform *t) {
+  if ((!in) || (!out)) {
+    return;
+  }
+
+#if defined(GTRANSFORM_CHECKED)
+  const GTransformCheckedFunction function = GTransformCheckedFunctionVectorTransformArray;
+  for (size_t i = 0; i < n; i++) {
+    const GPointPrecise pointP =
+        gtransform_checked_point_from_gpoint(function, GPoint(in[i].dx, in[i].dy));
+    const GPointPrecise result =
+        t ? gtransform_checked_point_transform(function, pointP, t) : pointP;
+    out[i] = GVectorPrecise(result.x.raw_value, result.y.raw_value);
+  }
+#else
+  if ((!t) || gtransform_is_identity(t)) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = GVectorPreciseFromGVector(in[i]);
+    }
+    return;
+  }
+
+  const Fixed_S16_3 one_tx = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, t->tx);
+  const Fixed_S16_3 one_ty = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, t->ty);
+
+  for (size_t i = 0; i < n; i++) {
+    GVectorPrecise vectorP = GVectorPreciseFromGVector(in[i]);
+
+    Fixed_S16_3 x_a = Fixed_S16_3_S32_16_mul(vectorP.dx, t->a);
+    Fixed_S16_3 y_c = Fixed_S16_3_S32_16_mul(vectorP.dy, t->c);
+
+    Fixed_S16_3 x_b = Fixed_S16_3_S32_16_mul(vectorP.dx, t->b);
+    Fixed_S16_3 y_d = Fixed_S16_3_S32_16_mul(vectorP.dy, t->d);
+
+    out[i].dx = Fixed_S16_3_add3(x_a, y_c, one_tx);
+    out[i].dy = Fixed_S16_3_add3(x_b, y_d, one_ty);
+  }
+#endif
+}
+
+// Points are transformed in small chunks with the prepared kernel and the bounding box is
+// accumulated from each chunk while it is still in cache, so the path is only walked once.
+#define PATH_TRANSFORM_CHUNK_SIZE 16
+
+typedef struct PathBounds {
+  int16_t min_x;
+  int16_t min_y;
+  int16_t max_x;
+  int16_t max_y;
+} PathBounds;
+
+static void prv_path_bounds_add(PathBounds *bounds, const GPointPrecise *points, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    const int16_t x = points[i].x.raw_value >> GPOINT_PRECISE_PRECISION;
+    const int16_t y = points[i].y.raw_value >> GPOINT_PRECISE_PRECISION;
+    if (x < bounds->min_x) {
+      bounds->min_x = x;
+    }
+    if (x > bounds->max_x) {
+      bounds->max_x = x;
+    }
+    if (y < bounds->min_y) {
+      bounds->min_y = y;
+    }
+    if (y > bounds->max_y) {
+      bounds->max_y = y;
+    }
+  }
+}
+
+static void prv_path_bounds_to_rect(const PathBounds *bounds, size_t num_points,
+                                    GRect *bounds_out) {
+  if (!bounds_out) {
+    return;
+  }
+
+  if (num_points == 0) {
+    *bounds_out = GRect(0, 0, 0, 0);
+    return;
+  }
+
+  *bounds_out = GRect(bounds->min_x, bounds->min_y,
+                      bounds->max_x - bounds->min_x + 1, bounds->max_y - bounds->min_y + 1);
+}
+
+void gpath_info_transform(const GPathInfo *info, const GTransform *t, GPoint *points_out,
+                          GRect *bounds_out) {
+  if ((!info) || (!points_out)) {
+    return;
+  }
+
+  GTransformPrepared prepared;
+  gtransform_prepare(&prepared, t);
+
+  PathBounds bounds = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+  GPointPrecise chunk[PATH_TRANSFORM_CHUNK_SIZE];
+
+  for (size_t start = 0; start < info->num_points; start += PATH_TRANSFORM_CHUNK_SIZE) {
+    size_t n = info->num_points - start;
+    if (n > PATH_TRANSFORM_CHUNK_SIZE) {
+      n = PATH_TRANSFORM_CHUNK_SIZE;
+    }
+
+    prepared.kernel(&prepared, &info->points[start], chunk, n);
+    prv_path_bounds_add(&bounds, chunk, n);
+    for (size_t i = 0; i < n; i++) {
+      points_out[start + i] = GPointFromGPointPrecise(chunk[i]);
+    }
+  }
+
+  prv_path_bounds_to_rect(&bounds, info->num_points, bounds_out);
+}
+
+void gpath_info_transform_precise(const GPathInfo *info, const GTransform *t,
+                                  GPointPrecise *points_out, GRect *bounds_out) {
+  if ((!info) || (!points_out)) {
+    return;
+  }
+
+  GTransformPrepared prepared;
+  gtransform_prepare(&prepared, t);
+
+  PathBounds bounds = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+
+  for (size_t start = 0; start < info->num_points; start += PATH_TRANSFORM_CHUNK_SIZE) {
+    size_t n = info->num_points - start;
+    if (n > PATH_TRANSFORM_CHUNK_SIZE) {
+      n = PATH_TRANSFORM_CHUNK_SIZE;
+    }
+
+    prepared.kernel(&prepared, &info->points[start], &points_out[start], n);
+    prv_path_bounds_add(&bounds, &points_out[start], n);
+  }
+
+  prv_path_bounds_to_rect(&bounds, info->num_points, bounds_out);
+}
+
+// The bounds are computed in units of 2^-17 px: doubling the rectangle coordinates makes the
+// center and half extents integers, and the coefficients add another 16 fractional bits.
+#define BOUNDS_PRECISION (FIXED_S32_16_PRECISION + 1)
+
+// gpoint_transform truncates each of its three terms to 1/8 px, so a corner it produces can be
+// up to 1/8 px below the exact value for every term whose coefficient is not a multiple of
+// 1/8. The lower bound is widened by that much; terms that are exact need no slack, so the
+// identity and integer translations keep the rectangle as is.
+#define BOUNDS_TRUNCATION_SLACK (1 << (BOUNDS_PRECISION - GPOINT_PRECISE_PRECISION))
+#define BOUNDS_INEXACT_MASK ((1 << (FIXED_S32_16_PRECISION - GPOINT_PRECISE_PRECISION)) - 1)
+
+// Absolute values of the linear part and the truncation slack of each axis, shared by all
+// rectangles transformed with one matrix
+typedef struct BoundsTransform {
+  const GTransform *t;
+  int64_t abs_a;
+  int64_t abs_b;
+  int64_t abs_c;
+  int64_t abs_d;
+  int64_t slack_x;
+  int64_t slack_y;
+} BoundsTransform;
+
+static int64_t prv_bounds_slack(GTransformNumber n1, GTransformNumber n2, GTransformNumber n3) {
+  return BOUNDS_TRUNCATION_SLACK * (((n1.raw_value & BOUNDS_INEXACT_MASK) ? 1 : 0) +
+                                    ((n2.raw_value & BOUNDS_INEXACT_MASK) ? 1 : 0) +
+                                    ((n3.raw_value & BOUNDS_INEXACT_MASK) ? 1 : 0));
+}
+
+static BoundsTransform prv_bounds_transform(const GTransform *t) {
+  return (BoundsTransform) {
+    .t = t,
+    .abs_a = (t->a.raw_value < 0) ? -(int64_t)t->a.raw_value : t->a.raw_value,
+    .abs_b = (t->b.raw_value < 0) ? -(int64_t)t->b.raw_value : t->b.raw_value,
+    .abs_c = (t->c.raw_value < 0) ? -(int64_t)t->c.raw_value : t->c.raw_value,
+    .abs_d = (t->d.raw_value < 0) ? -(int64_t)t->d.raw_value : t->d.raw_value,
+    .slack_x = prv_bounds_slack(t->a, t->c, t->tx),
+    .slack_y = prv_bounds_slack(t->b, t->d, t->ty),
+  };
+}
+
+static GRect prv_grect_standardize(GRect rect) {
+  if (rect.size.w < 0) {
+    rect.origin.x += rect.size.w;
+    rect.size.w = -rect.size.w;
+  }
+  if (rect.size.h < 0) {
+    rect.origin.y += rect.size.h;
+    rect.size.h = -rect.size.h;
+  }
+  return rect;
+}
+
+static int16_t prv_clamp_int16(int64_t value) {
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  } else if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  return value;
+}
+
+// Expects a standardized, non-empty rectangle
+static GRect prv_grect_transform_bounds(GRect rect, const BoundsTransform *bt) {
+  const GTransform *t = bt->t;
+  const int64_t center_x = 2 * rect.origin.x + rect.size.w;
+  const int64_t center_y = 2 * rect.origin.y + rect.size.h;
+  const int64_t extent_x = rect.size.w;
+  const int64_t extent_y = rect.size.h;
+
+  const int64_t new_center_x = center_x * t->a.raw_value + center_y * t->c.raw_value +
+                               2 * (int64_t)t->tx.raw_value;
+  const int64_t new_center_y = center_x * t->b.raw_value + center_y * t->d.raw_value +
+                               2 * (int64_t)t->ty.raw_value;
+  const int64_t new_extent_x = bt->abs_a * extent_x + bt->abs_c * extent_y;
+  const int64_t new_extent_y = bt->abs_b * extent_x + bt->abs_d * extent_y;
+
+  // Floor of the lower bound and ceiling of the upper bound
+  const int64_t min_x = (new_center_x - new_extent_x - bt->slack_x) >> BOUNDS_PRECISION;
+  const int64_t min_y = (new_center_y - new_extent_y - bt->slack_y) >> BOUNDS_PRECISION;
+  const int64_t max_x = -((-(new_center_x + new_extent_x)) >> BOUNDS_PRECISION);
+  const int64_t max_y = -((-(new_center_y + new_extent_y)) >> BOUNDS_PRECISION);
+
+  const int16_t x = prv_clamp_int16(min_x);
+  const int16_t y = prv_clamp_int16(min_y);
+  return GRect(x, y, prv_clamp_int16(max_x - x), prv_clamp_int16(max_y - y));
+}
+
+GRect grect_transform_bounds(GRect rect, const GTransform * const t) {
+  rect = prv_grect_standardize(rect);
+
+  if ((rect.size.w == 0) || (rect.size.h == 0)) {
+    return GRect(0, 0, 0, 0);
+  }
+
+  if (!t) {
+    return rect;
+  }
+
+  const BoundsTransform bt = prv_bounds_transform(t);
+  return prv_grect_transform_bounds(rect, &bt);
+}
+
+size_t grect_cull_against(const GRect *rects, size_t n, const GTransform *t, GRect clip,
+                          uint8_t *visible_bitmap) {
+  if ((!rects) || (!visible_bitmap)) {
+    return 0;
+  }
+
+  memset(visible_bitmap, 0, (n + 7) / 8);
+  clip = prv_grect_standardize(clip);
+
+  const GTransform identity = GTransformIdentity();
+  const BoundsTransform bt = prv_bounds_transform(t ? t : &identity);
+  size_t num_visible = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    const GRect rect = prv_grect_standardize(rects[i]);
+    if ((rect.size.w == 0) || (rect.size.h == 0)) {
+      continue;
+    }
+
+    const GRect bounds = t ? prv_grect_transform_bounds(rect, &bt) : rect;
+    if (grect_intersection(bounds, clip).size.w > 0) {
+      visible_bitmap[i / 8] |= (1 << (i % 8));
+      num_visible++;
+    }
+  }
+
+  return num_visible;
+}
+
+//////////////////////////////////////
+/// Prepared Transforms
+//////////////////////////////////////
+#if !defined(GTRANSFORM_CHECKED)
+// Each kernel below produces exactly the same result as gpoint_transform for the class of
+// matrix it is selected for; they only skip the multiplies by one and zero. Checked builds use
+// gtransform_checked_points_kernel for every class instead.
+static void prv_kernel_identity(const GTransformPrepared *prepared, const GPoint *in,
+                                GPointPrecise *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = GPointPreciseFromGPoint(in[i]);
+  }
+}
+
+static void prv_kernel_translation(const GTransformPrepared *prepared, const GPoint *in,
+                                   GPointPrecise *out, size_t n) {
+  const Fixed_S16_3 one_tx = prepared->one_tx;
+  const Fixed_S16_3 one_ty = prepared->one_ty;
+
+  for (size_t i = 0; i < n; i++) {
+    GPointPrecise pointP = GPointPreciseFromGPoint(in[i]);
+    out[i].x = Fixed_S16_3_add(pointP.x, one_tx);
+    out[i].y = Fixed_S16_3_add(pointP.y, one_ty);
+  }
+}
+
+static void prv_kernel_scale(const GTransformPrepared *prepared, const GPoint *in,
+                             GPointPrecise *out, size_t n) {
+  const GTransformNumber a = prepared->t.a;
+  const GTransformNumber d = prepared->t.d;
+
+  for (size_t i = 0; i < n; i++) {
+    GPointPrecise pointP = GPointPreciseFromGPoint(in[i]);
+    out[i].x = Fixed_S16_3_S32_16_mul(pointP.x, a);
+    out[i].y = Fixed_S16_3_S32_16_mul(pointP.y, d);
+  }
+}
+
+static void prv_kernel_scale_translation(const GTransformPrepared *prepared, const GPoint *in,
+                                         GPointPrecise *out, size_t n) {
+  const GTransformNumber a = prepared->t.a;
+  const GTransformNumber d = prepared->t.d;
+  const Fixed_S16_3 one_tx = prepared->one_tx;
+  const Fixed_S16_3 one_ty = prepared->one_ty;
+
+  for (size_t i = 0; i < n; i++) {
+    GPointPrecise pointP = GPointPreciseFromGPoint(in[i]);
+    out[i].x = Fixed_S16_3_add(Fixed_S16_3_S32_16_mul(pointP.x, a), one_tx);
+    out[i].y = Fixed_S16_3_add(Fixed_S16_3_S32_16_mul(pointP.y, d), one_ty);
+  }
+}
+
+static void prv_kernel_general(const GTransformPrepared *prepared, const GPoint *in,
+                               GPointPrecise *out, size_t n) {
+  const GTransform *t = &prepared->t;
+  const Fixed_S16_3 one_tx = prepared->one_tx;
+  const Fixed_S16_3 one_ty = prepared->one_ty;
+
+  // The vector kernel handles whole vectors; the remaining points go through the scalar code
+  const size_t num_vectorized = gtransform_simd_transform_points(t, one_tx, one_ty, in, out, n);
+
+  for (size_t i = num_vectorized; i < n; i++) {
+    GPointPrecise pointP = GPointPreciseFromGPoint(in[i]);
+
+    Fixed_S16_3 x_a = Fixed_S16_3_S32_16_mul(pointP.x, t->a);
+    Fixed_S16_3 y_c = Fixed_S16_3_S32_16_mul(pointP.y, t->c);
+
+    Fixed_S16_3 x_b = Fixed_S16_3_S32_16_mul(pointP.x, t->b);
+    Fixed_S16_3 y_d = Fixed_S16_3_S32_16_mul(pointP.y, t->d);
+
+    out[i].x = Fixed_S16_3_add3(x_a, y_c, one_tx);
+    out[i].y = Fixed_S16_3_add3(x_b, y_d, one_ty);
+  }
+}
+#endif
+
+GTransformClass gtransform_classify(const GTransform * const t) {
+  if ((!t) || gtransform_is_identity(t)) {
+    return GTransformClassIdentity;
+  } else if (gtransform_is_only_translation(t)) {
+    return GTransformClassTranslation;
+  } else if (gtransform_is_only_scale(t)) {
+    return GTransformClassScale;
+  } else if (gtransform_is_only_scale_or_translation(t)) {
+    return GTransformClassScaleTranslation;
+  }
+
+  return GTransformClassGeneral;
+}
+
+void gtransform_prepare(GTransformPrepared *prepared, const GTransform *t) {
+  if (!prepared) {
+    return;
+  }
+
+  prepared->t = t ? *t : GTransformIdentity();
+  prepared->type = gtransform_classify(t);
+  prepared->one_tx = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, prepared->t.tx);
+  prepared->one_ty = Fixed_S16_3_S32_16_mul(FIXED_S16_3_ONE, prepared->t.ty);
+
+#if defined(GTRANSFORM_CHECKED)
+  // Every class goes through the same checked kernel, which also bypasses the vector units
+  prepared->kernel = gtransform_checked_points_kernel;
+#else
+  switch (prepared->type) {
+    case GTransformClassIdentity:
+      prepared->kernel = prv_kernel_identity;
+      break;
+    case GTransformClassTranslation:
+      prepared->kernel = prv_kernel_translation;
+      break;
+    case GTransformClassScale:
+      prepared->kernel = prv_kernel_scale;
+      break;
+    case GTransformClassScaleTranslation:
+      prepared->kernel = prv_kernel_scale_translation;
+      break;
+    default:
+      prepared->kernel = prv_kernel_general;
+      break;
+  }
+#endif
+}
+
+GPointPrecise gpoint_transform_prepared(GPoint point, const GTransformPrepared * const prepared) {
+  if (!prepared) {
+    return GPointPreciseFromGPoint(point);
+  }
+
+  GPointPrecise pointP;
+  prepared->kernel(prepared, &point, &pointP, 1);
+  return pointP;
+}
+
+void gpoint_transform_array_prepared(const GPoint *in, GPointPrecise *out, size_t n,
+                                     const GTransformPrepared *prepared) {
+  if ((!in) || (!out)) {
+    return;
+  }
+
+  if (!prepared) {
+#if defined(GTRANSFORM_CHECKED)
+    GTransformPrepared identity;
+    gtransform_prepare(&identity, NULL);
+    identity.kernel(&identity, in, out, n);
+#else
+    prv_kernel_identity(NULL, in, out, n);
+#endif
+    return;
+  }
+
+  prepared->kernel(prepared, in, out, n);
+}
+
+bool gtransform_prepare_inverse(GTransformInverse *inverse, const GTransform *t) {
+  if (!inverse) {
+    return false;
+  }
+
+  if (!t) {
+    inverse->t = GTransformIdentity();
+    inverse->invertible = true;
+    return true;
+  }
+
+  inverse->invertible = gtransform_invert(&inverse->t, t);
+  return inverse->invertible;
+}
+
+bool gpointprecise_inverse_transform_prepared(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                              const GTransformInverse * const inverse) {
+  if ((!pointP_new) || (!inverse) || (!inverse->invertible)) {
+    return false;
+  }
+
+  *pointP_new = gpointprecise_transform(pointP, &inverse->t);
+  return true;
+}
+
+//////////////////////////////////////
+/// Scanline Iteration
+//////////////////////////////////////
+// x and y have precision fraction bits, which their products with the coefficients shed
+static void prv_iter_init(GTransformIterator *iter, const GTransform *t, int64_t x, int64_t y,
+                          int32_t precision) {
+  const GTransform identity = GTransformIdentity();
+  if (!t) {
+    t = &identity;
+  }
+
+  const int64_t row_x = ((x * t->a.raw_value + y * t->c.raw_value) >> precision) +
+                        t->tx.raw_value;
+  const int64_t row_y = ((x * t->b.raw_value + y * t->d.raw_value) >> precision) +
+                        t->ty.raw_value;
+  *iter = (GTransformIterator) {
+    .x = Fixed_S32_16((int32_t)row_x),
+    .y = Fixed_S32_16((int32_t)row_y),
+    .row_x = Fixed_S32_16((int32_t)row_x),
+    .row_y = Fixed_S32_16((int32_t)row_y),
+    .dx = t->a,
+    .dy = t->b,
+    .row_dx = t->c,
+    .row_dy = t->d,
+  };
+}
+
+void gtransform_iter_begin(GTransformIterator *iter, const GTransform *t, int16_t x0, int16_t y) {
+  if (!iter) {
+    return;
+  }
+
+  prv_iter_init(iter, t, x0, y, 0);
+}
+
+void gtransform_iter_begin_precise(GTransformIterator *iter, const GTransform *t,
+                                   GPointPrecise pointP) {
+  if (!iter) {
+    return;
+  }
+
+  prv_iter_init(iter, t, pointP.x.raw_value, pointP.y.raw_value, GPOINT_PRECISE_PRECISION);
+}
+
+void gtransform_iter_skip(GTransformIterator *iter, int32_t n) {
+  if (!iter) {
+    return;
+  }
+
+  // Wrapped the same way n single steps would be
+  iter->x.raw_value = (int32_t)((uint32_t)iter->x.raw_value +
+                                (uint32_t)n * (uint32_t)iter->dx.raw_value);
+  iter->y.raw_value = (int32_t)((uint32_t)iter->y.raw_value +
+                                (uint32_t)n * (uint32_t)iter->dy.raw_value);
 }
@@ -17,10 +17,10 @@
 /// Creating Transforms
 //////////////////////////////////////
 //! Convenience macro for GTransformNumber equal to 0
-#define GTransformNumberZero ((GTransformNumber){ .integer = 0, .fraction = 0 })
+#define GTransformNumberZero ((GTransformNumber){ .fraction = 0, .integer = 0 })
 
 //! Convenience macro for GTransformNumber equal to 1
-#define GTransformNumberOne  ((GTransformNumber){ .integer = 1, .fraction = 0 })
+#define GTransformNumberOne  ((GTransformNumber){ .fraction = 0, .integer = 1 })
 
 //! Convenience macro to convert from a number (i.e. char, int, float, etc.) to GTransformNumber
 //! @param x The number to convert
@@ -119,6 +119,58 @@ GTransform gtransform_init_rotation(int32_t angle);
 //! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
 #define GTransformRotation(angle) gtransform_init_rotation(angle)
 
+//! Number of rotation table entries per full turn is 2^GTRANSFORM_ROTATION_TABLE_BITS.
+//! Only a quarter wave is stored, so the table uses (2^(bits - 2) + 1) * 4 bytes of RAM.
+//! With the default of 9 bits (516 bytes) the interpolated coefficients are within 2 units of
+//! the last place of gtransform_init_rotation. Must be between 2 and 15, so that every entry
+//! is interpolated over at least one bit of the angle.
+#ifndef GTRANSFORM_ROTATION_TABLE_BITS
+#define GTRANSFORM_ROTATION_TABLE_BITS 9
+#endif
+
+#if (GTRANSFORM_ROTATION_TABLE_BITS < 2) || (GTRANSFORM_ROTATION_TABLE_BITS > 15)
+#error "GTRANSFORM_ROTATION_TABLE_BITS must be between 2 and 15"
+#endif
+
+//! @internal
+//! Function that returns the rotation matrix as defined below by GTransformRotationCached
+GTransform gtransform_init_rotation_cached(int32_t angle);
+
+//! Same as GTransformRotation, but the sine and cosine are linearly interpolated from a table of
+//! GTransformNumber values instead of being looked up and divided on every call. The table is
+//! filled the first time it is used; after that building a rotation needs no trig lookups and
+//! no divisions.
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+#define GTransformRotationCached(angle) gtransform_init_rotation_cached(angle)
+
+//! @internal
+//! Function that returns the matrix as defined below by GTransformTRS
+GTransform gtransform_init_trs(GTransformNumber sx, GTransformNumber sy, int32_t angle,
+                               GTransformNumber tx, GTransformNumber ty);
+
+//! This macro returns the transformation matrix that scales, then rotates, then translates.
+//! It is equivalent to concatenating GTransformScale, GTransformRotationCached and
+//! GTransformTranslation in that order, but is built directly with four multiplies.
+//! Below is the equivalent resulting matrix:
+//! t = [ sx*cos(angle)   -sx*sin(angle)   0 ]
+//!     [ sy*sin(angle)   sy*cos(angle)    0 ]
+//!     [ tx              ty               1 ]
+//! @param sx X scaling factor (type is GTransformNumber)
+//! @param sy Y scaling factor (type is GTransformNumber)
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+//! @param tx X translation factor (type is GTransformNumber)
+//! @param ty Y translation factor (type is GTransformNumber)
+#define GTransformTRS(sx, sy, angle, tx, ty) gtransform_init_trs(sx, sy, angle, tx, ty)
+//! @param sx X scaling factor (type is char, int, float, etc)
+//! @param sy Y scaling factor (type is char, int, float, etc)
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+//! @param tx X translation factor (type is char, int, float, etc)
+//! @param ty Y translation factor (type is char, int, float, etc)
+#define GTransformTRSFromNumber(sx, sy, angle, tx, ty)                                 \
+        gtransform_init_trs(GTransformNumberFromNumber(sx), GTransformNumberFromNumber(sy), \
+                            angle,                                                     \
+                            GTransformNumberFromNumber(tx), GTransformNumberFromNumber(ty))
+
 //////////////////////////////////////
 /// Evaluating Transforms
 //////////////////////////////////////
@@ -164,6 +216,18 @@ bool gtransform_is_equal(const GTransform * const t1, const GTransform * const t
 //! @param t2 Pointer to transformation matrix to concatenate with t1 where t_new = t1*t2
 void gtransform_concat(GTransform *t_new, const GTransform *t1, const GTransform * t2);
 
+//! Same as gtransform_concat but every coefficient is rounded to the nearest GTransformNumber
+//! once, instead of truncating each of its products, so a single concatenation is off by at
+//! most half a step. Rounding does not stop a matrix that is updated incrementally every frame
+//! from drifting: the errors still add up, about as fast as with gtransform_concat. Only
+//! calling gtransform_orthonormalize every few dozen updates keeps such a matrix close to a
+//! rotation. Slightly slower, as it skips none of the multiplies.
+//! Note t_new can safely be be the same pointer as t1 or t2.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t1 Pointer to transformation matrix to concatenate with t2 where t_new = t1*t2
+//! @param t2 Pointer to transformation matrix to concatenate with t1 where t_new = t1*t2
+void gtransform_concat_rounded(GTransform *t_new, const GTransform *t1, const GTransform *t2);
+
 //! Updates the input transformation matrix by applying a translation.
 //! This results in applying the following matrix below (i.e. t_new = t_scale*t):
 //! t_scale = [ sx  0   0 ]
@@ -218,14 +282,75 @@ void gtransform_translate(GTransform *t_new, GTransform *t,
 //! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
 void gtransform_rotate(GTransform *t_new, GTransform *t, int32_t angle);
 
+//! Same as gtransform_rotate but builds the rotation with GTransformRotationCached.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t Pointer to transformation matrix that will be rotated
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+void gtransform_rotate_cached(GTransform *t_new, GTransform *t, int32_t angle);
+
+//! Same as gtransform_rotate but with sine and cosine rounded instead of truncated and the
+//! matrices multiplied with gtransform_concat_rounded. This removes the shrinking of each single
+//! rotation, but a matrix rotated by a small step every frame still drifts as far as one rotated
+//! with gtransform_rotate; call gtransform_orthonormalize every few dozen frames to bound it.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t Pointer to transformation matrix that will be rotated
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+void gtransform_rotate_rounded(GTransform *t_new, GTransform *t, int32_t angle);
+
+//! Updates the input transformation matrix by applying a rotation of angle degrees around a
+//! pivot point instead of the origin.
+//! This results in applying the following matrix below (i.e. t_new = tr*t):
+//! tr = [ cos(angle)                      -sin(angle)                     0 ]
+//!      [ sin(angle)                      cos(angle)                      0 ]
+//!      [ px-px*cos(angle)-py*sin(angle)  py+px*sin(angle)-py*cos(angle)  1 ]
+//! tr is built directly with four multiplies from the cached rotation table.
+//! Note t_new can safely be be the same pointer as t.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t Pointer to transformation matrix that will be rotated
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+//! @param pivot Point that stays in place during the rotation
+void gtransform_rotate_about_point(GTransform *t_new, GTransform *t, int32_t angle,
+                                   GPoint pivot);
+
+//! Updates the input transformation matrix by applying a scale around a pivot point instead of
+//! the origin.
+//! This results in applying the following matrix below (i.e. t_new = t_scale*t):
+//! t_scale = [ sx          0           0 ]
+//!           [ 0           sy          0 ]
+//!           [ px-px*sx    py-py*sy    1 ]
+//! Note t_new can safely be be the same pointer as t.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t Pointer to transformation matrix that will be scaled
+//! @param sx X scaling factor
+//! @param sy Y scaling factor
+//! @param pivot Point that stays in place during the scale
+void gtransform_scale_about_point(GTransform *t_new, GTransform *t,
+                                  GTransformNumber sx, GTransformNumber sy, GPoint pivot);
+
 //! Returns the inversion of a given transformation matrix t in t_new.
 //! Function returns true if operation is successful; false if the matrix cannot be inverted
 //! If the matrix cannot be inverted, then the contents of t will be copied to t_new.
+//! The reciprocal of the determinant is computed once and each coefficient of the inverse is
+//! rounded to the nearest GTransformNumber, apart from values within 2^-30 of a step of halfway
+//! between two, which may round either way. A matrix is considered non-invertible if its
+//! determinant is zero or so small that the inverse does not fit in GTransformNumber
+//! coefficients.
 //! Note t_new can safely be be the same pointer as t.
 //! @param t_new Pointer to destination transformation matrix
 //! @param t Pointer to transformation matrix that will be inverted
 //! @return True if inversion of input t matrix exists; False otherwise or if t is NULL.
-bool gtransform_invert(GTransform *t_new, GTransform *t);
+bool gtransform_invert(GTransform *t_new, const GTransform *t);
+
+//! Removes the scale and shear that rounding errors accumulate in a matrix which should be a
+//! pure rotation (and translation). The x-axis row keeps its direction and is scaled to unit
+//! length, the y-axis row is replaced by its exact perpendicular, mirroring is preserved and
+//! the translation is copied unchanged.
+//! If the x-axis row is zero, the contents of t are copied to t_new.
+//! Note t_new can safely be be the same pointer as t.
+//! @param t_new Pointer to destination transformation matrix
+//! @param t Pointer to transformation matrix that will be orthonormalized
+//! @return True if successful; False if the x-axis row of t is zero or an argument is NULL.
+bool gtransform_orthonormalize(GTransform *t_new, const GTransform *t);
 
 //////////////////////////////////////
 /// Applying Transformations
@@ -237,6 +362,26 @@ bool gtransform_invert(GTransform *t_new, GTransform *t);
 //! GPoint to a GPointPrecise.
 GPointPrecise gpoint_transform(GPoint point, const GTransform * const t);
 
+//! Transforms a single GPointPrecise (x,y) based on the transformation matrix
+//! @param pointP GPointPrecise to be transformed
+//! @param t Pointer to transformation matrix to apply to the GPointPrecise
+//! @return GPointPrecise after transforming the input; if t is NULL then the input is returned.
+GPointPrecise gpointprecise_transform(GPointPrecise pointP, const GTransform * const t);
+
+//! Maps a GPointPrecise back through the inverse of the transformation matrix, i.e. finds the
+//! point that t would transform to pointP. This is useful for hit-testing a few points against
+//! transformed shapes.
+//! This inverts t on every call, which costs several times more than applying a matrix, so it
+//! is not meant for loops over points or pixels. Those should invert t once with
+//! gtransform_prepare_inverse and map every point with gpointprecise_inverse_transform_prepared.
+//! @param pointP_new Pointer to the destination GPointPrecise
+//! @param pointP GPointPrecise in the transformed space
+//! @param t Pointer to transformation matrix whose inverse is applied
+//! @return True if t could be inverted; False otherwise or if any pointer is NULL, in which
+//! case pointP_new is left unchanged.
+bool gpointprecise_inverse_transform(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                     const GTransform * const t);
+
 //! Transforms a single GVector (dx,dy) based on the transformation matrix
 //! @param point GVector to be transformed
 //! @param t Pointer to transformation matrix to apply to the GVector
@@ -244,6 +389,257 @@ GPointPrecise gpoint_transform(GPoint point, const GTransform * const t);
 //! GVector to a GVectorPrecise.
 GVectorPrecise gvector_transform(GVector vector, const GTransform * const t);
 
+//! Transforms an array of GPoints based on the transformation matrix.
+//! The result is identical to calling gpoint_transform on each point, but the translation
+//! terms and the NULL/identity checks are evaluated once for the whole array.
+//! @param in Pointer to the array of GPoints to be transformed
+//! @param out Pointer to the destination array of GPointPrecise (must hold n elements)
+//! @param n Number of points to transform
+//! @param t Pointer to transformation matrix to apply to the GPoints; if NULL then the points
+//! are just converted to GPointPrecise.
+void gpoint_transform_array(const GPoint *in, GPointPrecise *out, size_t n,
+                            const GTransform *t);
+
+//! Transforms an array of GVectors based on the transformation matrix.
+//! The result is identical to calling gvector_transform on each vector, but the translation
+//! terms and the NULL/identity checks are evaluated once for the whole array.
+//! @param in Pointer to the array of GVectors to be transformed
+//! @param out Pointer to the destination array of GVectorPrecise (must hold n elements)
+//! @param n Number of vectors to transform
+//! @param t Pointer to transformation matrix to apply to the GVectors; if NULL then the vectors
+//! are just converted to GVectorPrecise.
+void gvector_transform_array(const GVector *in, GVectorPrecise *out, size_t n,
+                             const GTransform *t);
+
+//! Transforms the points of a path and computes the bounding box of the result in the same
+//! pass, so that a path that ends up fully off screen can be culled before it is drawn.
+//! No memory is allocated; the caller provides the destination array.
+//! @param info Pointer to the path whose points are transformed
+//! @param t Pointer to transformation matrix to apply; if NULL the points are only copied.
+//! @param points_out Pointer to the destination array (must hold info->num_points elements)
+//! @param bounds_out Pointer to the rectangle that receives the bounding box of the transformed
+//! points, covering every pixel that contains one; may be NULL. An empty path has a zero
+//! rectangle as its bounding box.
+void gpath_info_transform(const GPathInfo *info, const GTransform *t, GPoint *points_out,
+                          GRect *bounds_out);
+
+//! Same as gpath_info_transform but keeps the fractional part of the transformed points.
+//! @param info Pointer to the path whose points are transformed
+//! @param t Pointer to transformation matrix to apply; if NULL the points are only converted.
+//! @param points_out Pointer to the destination array (must hold info->num_points elements)
+//! @param bounds_out Pointer to the rectangle that receives the bounding box of the transformed
+//! points, covering every pixel that contains one; may be NULL.
+void gpath_info_transform_precise(const GPathInfo *info, const GTransform *t,
+                                  GPointPrecise *points_out, GRect *bounds_out);
+
+//! Returns the axis aligned bounding box of a rectangle after transformation.
+//! Instead of transforming the four corners, the center is transformed and the half extents
+//! are multiplied by the absolute values of the linear part of the matrix, which takes only
+//! four multiplies for the extents. The result is conservative: it contains the transformed
+//! rectangle as well as its corners as computed by gpoint_transform, which truncates. Matrices
+//! whose coefficients are multiples of 1/8, such as the identity and integer translations,
+//! give the exact bounds.
+//! @param rect Rectangle to transform; negative sizes are standardized first.
+//! @param t Pointer to transformation matrix to apply; if NULL the standardized rect is
+//! returned.
+//! @return Smallest GRect containing the transformed rectangle; a zero rectangle if rect is
+//! empty.
+GRect grect_transform_bounds(GRect rect, const GTransform * const t);
+
+//! Tests which of an array of rectangles are still visible inside a clip rectangle after they
+//! are transformed. The absolute values of the linear part of the matrix are computed once for
+//! the whole array.
+//! @param rects Pointer to the array of rectangles to test
+//! @param n Number of rectangles
+//! @param t Pointer to transformation matrix to apply; if NULL the rectangles are tested as is.
+//! @param clip Rectangle that the transformed bounds are tested against
+//! @param visible_bitmap Pointer to a bitmap of at least (n + 7) / 8 bytes. Bit (i % 8) of byte
+//! (i / 8) is set if rectangle i intersects clip after transformation and cleared otherwise.
+//! @return Number of visible rectangles.
+size_t grect_cull_against(const GRect *rects, size_t n, const GTransform *t, GRect clip,
+                          uint8_t *visible_bitmap);
+
+//////////////////////////////////////
+/// Prepared Transforms
+//////////////////////////////////////
+//! Classes of transformation matrices that have a specialized apply path
+typedef enum GTransformClass {
+  //! Matrix is the identity (points are only converted)
+  GTransformClassIdentity,
+  //! Matrix only translates (a = d = 1, b = c = 0)
+  GTransformClassTranslation,
+  //! Matrix only scales (b = c = tx = ty = 0)
+  GTransformClassScale,
+  //! Matrix scales and translates but has no rotation or shear (b = c = 0)
+  GTransformClassScaleTranslation,
+  //! Any other affine matrix
+  GTransformClassGeneral,
+} GTransformClass;
+
+struct GTransformPrepared;
+
+//! @internal
+//! Kernel that transforms n points using a prepared transformation matrix
+typedef void (*GTransformPointsKernel)(const struct GTransformPrepared *prepared,
+                                       const GPoint *in, GPointPrecise *out, size_t n);
+
+//! A transformation matrix that has been classified once so that applying it can skip the
+//! multiplies that a translation, scale or identity matrix does not need.
+//! Use gtransform_prepare to initialize it and prepare it again whenever the matrix changes.
+typedef struct GTransformPrepared {
+  //! Copy of the transformation matrix
+  GTransform t;
+  //! Class of the matrix
+  GTransformClass type;
+  //! Translation terms already converted to Fixed_S16_3
+  Fixed_S16_3 one_tx;
+  Fixed_S16_3 one_ty;
+  //! Kernel selected for the class of the matrix
+  GTransformPointsKernel kernel;
+} GTransformPrepared;
+
+//! Returns the most specific class that describes the input matrix
+//! @param t Pointer to transformation matrix to classify
+//! @return Class of the matrix; GTransformClassIdentity if t is NULL.
+GTransformClass gtransform_classify(const GTransform * const t);
+
+//! Classifies the transformation matrix and selects the kernel used to apply it.
+//! @param prepared Pointer to the prepared transform to initialize
+//! @param t Pointer to transformation matrix to prepare; if NULL the identity is used.
+void gtransform_prepare(GTransformPrepared *prepared, const GTransform *t);
+
+//! Transforms a single GPoint (x,y) based on a prepared transformation matrix.
+//! The result is identical to gpoint_transform with the matrix that was prepared.
+//! @param point GPoint to be transformed
+//! @param prepared Pointer to the prepared transform to apply to the GPoint
+//! @return GPointPrecise after transforming the GPoint; if prepared is NULL then just convert
+//! the GPoint to a GPointPrecise.
+GPointPrecise gpoint_transform_prepared(GPoint point, const GTransformPrepared * const prepared);
+
+//! Transforms an array of GPoints based on a prepared transformation matrix.
+//! The result is identical to gpoint_transform_array with the matrix that was prepared.
+//! @param in Pointer to the array of GPoints to be transformed
+//! @param out Pointer to the destination array of GPointPrecise (must hold n elements)
+//! @param n Number of points to transform
+//! @param prepared Pointer to the prepared transform to apply; if NULL then the points are just
+//! converted to GPointPrecise.
+void gpoint_transform_array_prepared(const GPoint *in, GPointPrecise *out, size_t n,
+                                     const GTransformPrepared *prepared);
+
+//! The inverse of a transformation matrix, computed once so that mapping points back through it,
+//! e.g. for per-pixel hit-testing, costs no more than applying a matrix.
+//! Use gtransform_prepare_inverse to initialize it and prepare it again whenever the matrix
+//! changes.
+typedef struct GTransformInverse {
+  //! Inverse of the prepared matrix; the prepared matrix itself if it cannot be inverted
+  GTransform t;
+  //! Whether the prepared matrix could be inverted
+  bool invertible;
+} GTransformInverse;
+
+//! Inverts the transformation matrix once with gtransform_invert.
+//! @param inverse Pointer to the prepared inverse to initialize
+//! @param t Pointer to transformation matrix to prepare; if NULL the identity is used.
+//! @return True if t could be inverted; False otherwise or if inverse is NULL.
+bool gtransform_prepare_inverse(GTransformInverse *inverse, const GTransform *t);
+
+//! Maps a GPointPrecise back through a prepared inverse. The result is identical to
+//! gpointprecise_inverse_transform with the matrix that was prepared.
+//! @param pointP_new Pointer to the destination GPointPrecise
+//! @param pointP GPointPrecise in the transformed space
+//! @param inverse Pointer to the prepared inverse to apply
+//! @return True if the prepared matrix could be inverted; False otherwise or if any pointer is
+//! NULL, in which case pointP_new is left unchanged.
+bool gpointprecise_inverse_transform_prepared(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                              const GTransformInverse * const inverse);
+
+//////////////////////////////////////
+/// Scanline Iteration
+//////////////////////////////////////
+//! Walks the transformed coordinates of consecutive pixels, for code that needs the transform
+//! of every pixel in a row, such as texture lookups or hit maps. Moving one pixel along a row
+//! adds (a, b) and moving down one row adds (c, d), so each pixel takes two adds instead of
+//! the six multiplies of gpoint_transform.
+//!
+//! Coordinates are kept in 16.16 format, the format of the coefficients, so every step adds an
+//! exact value and no error accumulates however many pixels are visited. Started from a GPoint,
+//! the coordinates are exactly x * a + y * c + tx and x * b + y * d + ty for every pixel
+//! reached. Started from a GPointPrecise, the start is rounded down to 1/65536 px once and every
+//! later pixel is off by that same amount. gtransform_iter_get_point rounds the exact value
+//! down to 1/8 px, while gpoint_transform rounds each of its products down separately, so it
+//! can return up to 2/8 px less per axis. Coordinates wrap beyond ±32768 px.
+typedef struct GTransformIterator {
+  //! Transformed x of the current pixel
+  GTransformNumber x;
+  //! Transformed y of the current pixel
+  GTransformNumber y;
+  //! Transformed x of the pixel the current row started at
+  GTransformNumber row_x;
+  //! Transformed y of the pixel the current row started at
+  GTransformNumber row_y;
+  //! Change of x and y per pixel along a row (a and b of the matrix)
+  GTransformNumber dx;
+  GTransformNumber dy;
+  //! Change of x and y per row (c and d of the matrix)
+  GTransformNumber row_dx;
+  GTransformNumber row_dy;
+} GTransformIterator;
+
+//! Starts iterating at a pixel.
+//! @param iter Pointer to the iterator to initialize
+//! @param t Pointer to transformation matrix to apply; if NULL the identity is used.
+//! @param x0 X of the first pixel
+//! @param y Y of the first row
+void gtransform_iter_begin(GTransformIterator *iter, const GTransform *t, int16_t x0, int16_t y);
+
+//! Starts iterating at a point with a fractional part, e.g. the center of a pixel
+//! (x * 8 + 4, y * 8 + 4) for sampling a texture under the inverse of a matrix.
+//! @param iter Pointer to the iterator to initialize
+//! @param t Pointer to transformation matrix to apply; if NULL the identity is used.
+//! @param pointP First point
+void gtransform_iter_begin_precise(GTransformIterator *iter, const GTransform *t,
+                                   GPointPrecise pointP);
+
+//! Moves to the next pixel along the row with two adds, which wrap as unsigned values.
+//! @param iter Pointer to the iterator
+static __inline__ void gtransform_iter_next(GTransformIterator *iter) {
+  iter->x.raw_value = (int32_t)((uint32_t)iter->x.raw_value + (uint32_t)iter->dx.raw_value);
+  iter->y.raw_value = (int32_t)((uint32_t)iter->y.raw_value + (uint32_t)iter->dy.raw_value);
+}
+
+//! Moves to the start of the next row, below the pixel that the current row started at.
+//! @param iter Pointer to the iterator
+static __inline__ void gtransform_iter_next_row(GTransformIterator *iter) {
+  iter->row_x.raw_value = (int32_t)((uint32_t)iter->row_x.raw_value +
+                                    (uint32_t)iter->row_dx.raw_value);
+  iter->row_y.raw_value = (int32_t)((uint32_t)iter->row_y.raw_value +
+                                    (uint32_t)iter->row_dy.raw_value);
+  iter->x = iter->row_x;
+  iter->y = iter->row_y;
+}
+
+//! Moves n pixels along the row at once, e.g. to the first pixel inside a clip rectangle.
+//! The result is the same as calling gtransform_iter_next n times.
+//! @param iter Pointer to the iterator
+//! @param n Number of pixels to move; may be negative.
+void gtransform_iter_skip(GTransformIterator *iter, int32_t n);
+
+//! Returns the transformed coordinates of the current pixel, rounded down to 1/8 px.
+//! @param iter Pointer to the iterator
+static __inline__ GPointPrecise gtransform_iter_get_point(const GTransformIterator *iter) {
+  const int32_t shift = FIXED_S32_16_PRECISION - GPOINT_PRECISE_PRECISION;
+  return GPointPrecise((int16_t)(iter->x.raw_value >> shift),
+                       (int16_t)(iter->y.raw_value >> shift));
+}
+
+//! Returns the pixel that contains the transformed coordinates of the current pixel, i.e. the
+//! coordinates rounded down to whole pixels.
+//! @param iter Pointer to the iterator
+static __inline__ GPoint gtransform_iter_get_gpoint(const GTransformIterator *iter) {
+  return GPoint((int16_t)(iter->x.raw_value >> FIXED_S32_16_PRECISION),
+                (int16_t)(iter->y.raw_value >> FIXED_S32_16_PRECISION));
+}
+
 //!   @} // end addtogroup GraphicsTransforms
 //! @} // end addtogroup Graphics
 
@@ -0,0 +1,227 @@
+#pragma once
+
+//! @file gtransform.hpp
+//! C++ layer over gtransform.h that builds transformation matrices at compile time.
+//!
+//! Every builder is `constexpr`, so matrices for static layouts can be declared as `constexpr`
+//! variables and cost nothing at runtime. The integer builders, the rotation and the concat only
+//! use integer arithmetic and produce the same bits as their C counterparts, so they may also be
+//! called at runtime. Floating point numbers go through GTRANSFORM_NUMBER, GTRANSFORM_SCALE and
+//! GTRANSFORM_TRANSLATION, which pass the converted value as a template argument so that it is
+//! always computed by the compiler. With C++20 the builders also take doubles directly as
+//! `consteval` overloads; before C++20 those overloads are deleted, as they could not be kept
+//! from running. Either way no float conversion can reach the runtime code on watches without
+//! an FPU.
+
+#if __cplusplus < 201402L
+#error "gtransform.hpp requires C++14 or later"
+#endif
+
+extern "C" {
+#include <pebble.h>
+
+#include "gtransform.h"
+}
+
+#include <type_traits>
+
+//! Forces an expression to be evaluated at compile time; it does not compile otherwise.
+//! @param expr Constant expression, e.g. `gtransform::rotation(TRIG_MAX_ANGLE / 8)`
+#define GTRANSFORM_CONSTANT(expr) \
+        ([]() { constexpr auto gtransform_constant_value = (expr); \
+                return gtransform_constant_value; }())
+
+//! Same as GTransformNumberFromNumber (truncating towards zero), converted by the compiler.
+//! Also usable in constexpr initializers.
+//! @param x Constant number of any type, e.g. `0.5`
+#define GTRANSFORM_NUMBER(x) \
+        gtransform::number_raw( \
+            std::integral_constant<int32_t, gtransform::internal::raw_from_double(x)>::value)
+
+//! Same as GTransformScaleFromNumber, converted by the compiler.
+#define GTRANSFORM_SCALE(sx, sy) gtransform::scale(GTRANSFORM_NUMBER(sx), GTRANSFORM_NUMBER(sy))
+
+//! Same as GTransformTranslationFromNumber, converted by the compiler.
+#define GTRANSFORM_TRANSLATION(tx, ty) \
+        gtransform::translation(GTRANSFORM_NUMBER(tx), GTRANSFORM_NUMBER(ty))
+
+namespace gtransform {
+
+namespace internal {
+
+constexpr int32_t kOne = (1 << FIXED_S32_16_PRECISION);
+
+// Integers take the exact overloads and floating point numbers the compile time only ones
+template <typename T>
+using EnableIfIntegral = typename std::enable_if<std::is_integral<T>::value, int>::type;
+
+// Only reached through GTRANSFORM_NUMBER, where the result is a template argument
+constexpr int32_t raw_from_double(double x) {
+  return (int32_t)(x * kOne);
+}
+
+// Same as Fixed_S32_16_mul
+constexpr int32_t mul(int32_t a, int32_t b) {
+  return (int32_t)(((int64_t)a * (int64_t)b) >> FIXED_S32_16_PRECISION);
+}
+
+// Angle in TRIG_MAX_ANGLE units converted to radians in 2.30 fixed point
+constexpr int64_t kPiQ30 = 3373259426LL;  // pi * 2^30, rounded
+
+// Sine of an angle in [0, TRIG_MAX_ANGLE / 4] in 2.30 fixed point, from its Taylor series.
+// Terms up to x^15 keep the error well below the 2^-16 resolution of the result.
+constexpr int64_t sin_q30_quarter(int32_t angle) {
+  const int64_t x = (angle * 2 * kPiQ30) / TRIG_MAX_ANGLE;
+  const int64_t x2 = (x * x) >> 30;
+  int64_t term = x;
+  int64_t sum = x;
+  for (int n = 2; n <= 15; n += 2) {
+    term = -((term * x2) >> 30) / (n * (n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+// Sine in TRIG_MAX_RATIO units for any angle, rounded like the host sin_lookup
+constexpr int32_t sin_ratio(int32_t angle) {
+  const int32_t quarter = TRIG_MAX_ANGLE / 4;
+  int32_t a = angle % TRIG_MAX_ANGLE;
+  if (a < 0) {
+    a += TRIG_MAX_ANGLE;
+  }
+  const bool negative = (a >= 2 * quarter);
+  if (negative) {
+    a -= 2 * quarter;
+  }
+  if (a > quarter) {
+    a = 2 * quarter - a;
+  }
+  const int64_t ratio = ((sin_q30_quarter(a) * TRIG_MAX_RATIO) + (1LL << 29)) >> 30;
+  return (int32_t)(negative ? -ratio : ratio);
+}
+
+}  // namespace internal
+
+//! Returns a GTransformNumber from its raw 16.16 value
+constexpr GTransformNumber number_raw(int32_t raw_value) {
+  return GTransformNumber{ raw_value };
+}
+
+//! Same as GTransformNumberFromNumber for integers; usable at runtime.
+template <typename T, internal::EnableIfIntegral<T> = 0>
+constexpr GTransformNumber number(T x) {
+  return number_raw((int32_t)(x * internal::kOne));
+}
+
+#if defined(__cpp_consteval)
+//! Same as GTRANSFORM_NUMBER; only usable at compile time.
+consteval GTransformNumber number(double x) {
+  return number_raw(internal::raw_from_double(x));
+}
+#else
+//! Floating point numbers need GTRANSFORM_NUMBER before C++20
+GTransformNumber number(double x) = delete;
+#endif
+
+//! Same as GTransform
+constexpr GTransform make(GTransformNumber a, GTransformNumber b, GTransformNumber c,
+                          GTransformNumber d, GTransformNumber tx, GTransformNumber ty) {
+  return GTransform{ a, b, c, d, tx, ty };
+}
+
+//! Same as GTransformIdentity
+constexpr GTransform identity() {
+  return make(number(1), number(0), number(0), number(1), number(0), number(0));
+}
+
+//! Same as GTransformScale
+constexpr GTransform scale(GTransformNumber sx, GTransformNumber sy) {
+  return make(sx, number(0), number(0), sy, number(0), number(0));
+}
+
+#if defined(__cpp_consteval)
+//! Same as GTRANSFORM_SCALE; only usable at compile time.
+consteval GTransform scale(double sx, double sy) {
+  return scale(number(sx), number(sy));
+}
+#else
+//! Floating point scales need GTRANSFORM_SCALE before C++20
+GTransform scale(double sx, double sy) = delete;
+#endif
+
+//! Same as GTransformTranslation
+constexpr GTransform translation(GTransformNumber tx, GTransformNumber ty) {
+  return make(number(1), number(0), number(0), number(1), tx, ty);
+}
+
+//! Same as GTransformTranslationFromNumber for integers; usable at runtime.
+template <typename T, internal::EnableIfIntegral<T> = 0>
+constexpr GTransform translation(T tx, T ty) {
+  return translation(number(tx), number(ty));
+}
+
+#if defined(__cpp_consteval)
+//! Same as GTRANSFORM_TRANSLATION; only usable at compile time.
+consteval GTransform translation(double tx, double ty) {
+  return translation(number(tx), number(ty));
+}
+#else
+//! Floating point translations need GTRANSFORM_TRANSLATION before C++20
+GTransform translation(double tx, double ty) = delete;
+#endif
+
+//! Same as GTransformRotation, with sine and cosine computed by the compiler instead of looked
+//! up. Matches the lookup tables to within one TRIG_MAX_RATIO step.
+//! @param angle Angle of rotation in TRIG_MAX_ANGLE units
+constexpr GTransform rotation(int32_t angle) {
+  if (angle == 0) {
+    return identity();
+  }
+  const int64_t one = internal::kOne;
+  const int32_t cosine = (int32_t)((internal::sin_ratio(angle + TRIG_MAX_ANGLE / 4) * one) /
+                                   TRIG_MAX_RATIO);
+  const int32_t sine = (int32_t)((internal::sin_ratio(angle) * one) / TRIG_MAX_RATIO);
+  return make(number_raw(cosine), number_raw(-sine), number_raw(sine), number_raw(cosine),
+              number(0), number(0));
+}
+
+//! Same as gtransform_concat: t1 is applied first, then t2.
+constexpr GTransform concat(const GTransform &t1, const GTransform &t2) {
+  using internal::mul;
+  return make(
+      number_raw(mul(t1.a.raw_value, t2.a.raw_value) + mul(t1.b.raw_value, t2.c.raw_value)),
+      number_raw(mul(t1.a.raw_value, t2.b.raw_value) + mul(t1.b.raw_value, t2.d.raw_value)),
+      number_raw(mul(t1.c.raw_value, t2.a.raw_value) + mul(t1.d.raw_value, t2.c.raw_value)),
+      number_raw(mul(t1.c.raw_value, t2.b.raw_value) + mul(t1.d.raw_value, t2.d.raw_value)),
+      number_raw(mul(t1.tx.raw_value, t2.a.raw_value) + mul(t1.ty.raw_value, t2.c.raw_value) +
+                 t2.tx.raw_value),
+      number_raw(mul(t1.tx.raw_value, t2.b.raw_value) + mul(t1.ty.raw_value, t2.d.raw_value) +
+                 t2.ty.raw_value));
+}
+
+//! Concatenates any number of matrices, applied from left to right
+template <typename... Rest>
+constexpr GTransform concat(const GTransform &t1, const GTransform &t2, const Rest &... rest) {
+  return concat(concat(t1, t2), rest...);
+}
+
+//! Scales by (sx, sy), then rotates by angle, then translates by (tx, ty). Computed like
+//! GTransformTRS but with the rotation of gtransform::rotation instead of the interpolated table.
+constexpr GTransform trs(GTransformNumber sx, GTransformNumber sy, int32_t angle,
+                         GTransformNumber tx, GTransformNumber ty) {
+  using internal::mul;
+  const GTransform r = rotation(angle);
+  return make(number_raw(mul(sx.raw_value, r.a.raw_value)),
+              number_raw(mul(sx.raw_value, r.b.raw_value)),
+              number_raw(mul(sy.raw_value, r.c.raw_value)),
+              number_raw(mul(sy.raw_value, r.d.raw_value)), tx, ty);
+}
+
+//! Compares two matrices coefficient by coefficient
+constexpr bool equal(const GTransform &t1, const GTransform &t2) {
+  return (t1.a.raw_value == t2.a.raw_value) && (t1.b.raw_value == t2.b.raw_value) &&
+         (t1.c.raw_value == t2.c.raw_value) && (t1.d.raw_value == t2.d.raw_value) &&
+         (t1.tx.raw_value == t2.tx.raw_value) && (t1.ty.raw_value == t2.ty.raw_value);
+}
+
+}  // namespace gtransform
@@ -0,0 +1,140 @@
+#include <pebble.h>
+
+#include "gtransform_checked.h"
+
+#if defined(GTRANSFORM_CHECKED)
+
+#include <string.h>
+
+static GTransformCheckedStats s_stats;
+
+const GTransformCheckedStats *gtransform_checked_get_stats(void) {
+  return &s_stats;
+}
+
+void gtransform_checked_reset_stats(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+//////////////////////////////////////
+/// Checked arithmetic
+//////////////////////////////////////
+static int64_t prv_clamp(GTransformCheckedFunction function, int64_t value, int64_t min,
+                         int64_t max) {
+  if ((value < min) || (value > max)) {
+    s_stats.functions[function].overflows++;
+    return (value < min) ? min : max;
+  }
+  return value;
+}
+
+// Product of a raw value and a 16.16 coefficient, rounded down like the fast path
+static int64_t prv_mul(GTransformCheckedFunction function, int64_t value, int32_t coefficient) {
+  const int64_t product = value * coefficient;
+  if (product & ((1 << FIXED_S32_16_PRECISION) - 1)) {
+    s_stats.functions[function].truncations++;
+  }
+  return product >> FIXED_S32_16_PRECISION;
+}
+
+static Fixed_S32_16 prv_number(GTransformCheckedFunction function, int64_t value) {
+  return Fixed_S32_16((int32_t)prv_clamp(function, value, INT32_MIN, INT32_MAX));
+}
+
+static Fixed_S16_3 prv_coordinate(GTransformCheckedFunction function, int64_t value) {
+  return Fixed_S16_3((int16_t)prv_clamp(function, value, INT16_MIN, INT16_MAX));
+}
+
+// Each product is clamped on its own before the sum, as the fast path truncates each one
+static Fixed_S32_16 prv_number_mul(GTransformCheckedFunction function, Fixed_S32_16 a,
+                                   Fixed_S32_16 b) {
+  return prv_number(function, prv_mul(function, a.raw_value, b.raw_value));
+}
+
+static Fixed_S16_3 prv_coordinate_mul(GTransformCheckedFunction function, Fixed_S16_3 a,
+                                      Fixed_S32_16 b) {
+  return prv_coordinate(function, prv_mul(function, a.raw_value, b.raw_value));
+}
+
+//////////////////////////////////////
+/// Checked transforms
+//////////////////////////////////////
+void gtransform_checked_concat(GTransform *t_new, const GTransform *t1, const GTransform *t2) {
+  const GTransformCheckedFunction f = GTransformCheckedFunctionConcat;
+  const GTransform t = {
+    .a = prv_number(f, (int64_t)prv_number_mul(f, t1->a, t2->a).raw_value +
+                       prv_number_mul(f, t1->b, t2->c).raw_value),
+    .b = prv_number(f, (int64_t)prv_number_mul(f, t1->a, t2->b).raw_value +
+                       prv_number_mul(f, t1->b, t2->d).raw_value),
+    .c = prv_number(f, (int64_t)prv_number_mul(f, t1->c, t2->a).raw_value +
+                       prv_number_mul(f, t1->d, t2->c).raw_value),
+    .d = prv_number(f, (int64_t)prv_number_mul(f, t1->c, t2->b).raw_value +
+                       prv_number_mul(f, t1->d, t2->d).raw_value),
+    .tx = prv_number(f, (int64_t)prv_number_mul(f, t1->tx, t2->a).raw_value +
+                        prv_number_mul(f, t1->ty, t2->c).raw_value + t2->tx.raw_value),
+    .ty = prv_number(f, (int64_t)prv_number_mul(f, t1->tx, t2->b).raw_value +
+                        prv_number_mul(f, t1->ty, t2->d).raw_value + t2->ty.raw_value),
+  };
+  *t_new = t;
+}
+
+void gtransform_checked_scale(GTransform *t_new, const GTransform *t, GTransformNumber sx,
+                              GTransformNumber sy) {
+  const GTransformCheckedFunction f = GTransformCheckedFunctionScale;
+  GTransform result = *t;
+  result.a = prv_number_mul(f, sx, t->a);
+  result.b = prv_number_mul(f, sx, t->b);
+  result.c = prv_number_mul(f, sy, t->c);
+  result.d = prv_number_mul(f, sy, t->d);
+  *t_new = result;
+}
+
+void gtransform_checked_translate(GTransform *t_new, const GTransform *t, GTransformNumber tx,
+                                  GTransformNumber ty) {
+  const GTransformCheckedFunction f = GTransformCheckedFunctionTranslate;
+  GTransform result = *t;
+  result.tx = prv_number(f, (int64_t)prv_number_mul(f, tx, t->a).raw_value +
+                            prv_number_mul(f, ty, t->c).raw_value + t->tx.raw_value);
+  result.ty = prv_number(f, (int64_t)prv_number_mul(f, tx, t->b).raw_value +
+                            prv_number_mul(f, ty, t->d).raw_value + t->ty.raw_value);
+  *t_new = result;
+}
+
+static Fixed_S16_3 prv_coordinate_from_int(GTransformCheckedFunction function, int16_t value) {
+  if ((value < -GPOINT_PRECISE_MAX / 2) || (value >= GPOINT_PRECISE_MAX / 2)) {
+    s_stats.functions[function].saturations++;
+    return Fixed_S16_3((value < 0) ? INT16_MIN : INT16_MAX);
+  }
+  return Fixed_S16_3(value * (1 << GPOINT_PRECISE_PRECISION));
+}
+
+GPointPrecise gtransform_checked_point_from_gpoint(GTransformCheckedFunction function,
+                                                   GPoint point) {
+  return GPointPrecise(prv_coordinate_from_int(function, point.x).raw_value,
+                       prv_coordinate_from_int(function, point.y).raw_value);
+}
+
+GPointPrecise gtransform_checked_point_transform(GTransformCheckedFunction function,
+                                                 GPointPrecise pointP, const GTransform *t) {
+  const GTransformCheckedFunction f = function;
+  const Fixed_S16_3 one_tx = prv_coordinate_mul(f, FIXED_S16_3_ONE, t->tx);
+  const Fixed_S16_3 one_ty = prv_coordinate_mul(f, FIXED_S16_3_ONE, t->ty);
+  const Fixed_S16_3 x = prv_coordinate(f, (int64_t)prv_coordinate_mul(f, pointP.x, t->a).raw_value +
+                                          prv_coordinate_mul(f, pointP.y, t->c).raw_value +
+                                          one_tx.raw_value);
+  const Fixed_S16_3 y = prv_coordinate(f, (int64_t)prv_coordinate_mul(f, pointP.x, t->b).raw_value +
+                                          prv_coordinate_mul(f, pointP.y, t->d).raw_value +
+                                          one_ty.raw_value);
+  return GPointPrecise(x.raw_value, y.raw_value);
+}
+
+void gtransform_checked_points_kernel(const GTransformPrepared *prepared, const GPoint *in,
+                                      GPointPrecise *out, size_t n) {
+  const GTransformCheckedFunction f = GTransformCheckedFunctionPointTransformArray;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = gtransform_checked_point_transform(f, gtransform_checked_point_from_gpoint(f, in[i]),
+                                                &prepared->t);
+  }
+}
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformChecked Checked Mode
+//! \brief Build mode in which the transform functions saturate instead of wrapping and count
+//! every event that the fast path would silently get wrong.
+//!
+//! Define GTRANSFORM_CHECKED when building the library to enable it. The instrumented functions
+//! then run a checked implementation that:
+//!   - clamps GPoint and GVector coordinates outside of ±4096 px instead of wrapping them
+//!   - clamps products and sums that do not fit their fixed point format instead of wrapping
+//!   - counts those events, and multiplies that discard non-zero fraction bits, per function
+//! Without GTRANSFORM_CHECKED none of this is compiled and the functions below do not exist.
+//! Results only differ from the fast path when an event other than a truncation was counted,
+//! so running test loads in checked mode with zero overflows and saturations shows the fast
+//! path is exact for them.
+//!     @{
+
+#if defined(GTRANSFORM_CHECKED)
+
+//! Functions that are instrumented in checked mode
+typedef enum GTransformCheckedFunction {
+  //! gtransform_concat
+  GTransformCheckedFunctionConcat,
+  //! gtransform_scale
+  GTransformCheckedFunctionScale,
+  //! gtransform_translate
+  GTransformCheckedFunctionTranslate,
+  //! gpoint_transform and gpointprecise_transform
+  GTransformCheckedFunctionPointTransform,
+  //! gvector_transform
+  GTransformCheckedFunctionVectorTransform,
+  //! Everything that goes through a prepared transform: gpoint_transform_array,
+  //! gpoint_transform_prepared, gpoint_transform_array_prepared and the path functions
+  GTransformCheckedFunctionPointTransformArray,
+  //! gvector_transform_array
+  GTransformCheckedFunctionVectorTransformArray,
+  //! gpoint_buffer_transform
+  GTransformCheckedFunctionPointBufferTransform,
+  GTransformCheckedFunctionCount,
+} GTransformCheckedFunction;
+
+//! Events counted for one function
+typedef struct GTransformCheckedCounters {
+  //! Products or sums that did not fit their format and were clamped
+  uint32_t overflows;
+  //! Input coordinates outside of the precise range that were clamped
+  uint32_t saturations;
+  //! Products whose discarded fraction bits were not zero
+  uint32_t truncations;
+} GTransformCheckedCounters;
+
+//! Events counted since the last reset, per function
+typedef struct GTransformCheckedStats {
+  GTransformCheckedCounters functions[GTransformCheckedFunctionCount];
+} GTransformCheckedStats;
+
+//! Returns the events counted since the last reset.
+const GTransformCheckedStats *gtransform_checked_get_stats(void);
+
+//! Resets all counters to zero.
+void gtransform_checked_reset_stats(void);
+
+//! @internal
+//! Checked implementations called by the instrumented functions
+void gtransform_checked_concat(GTransform *t_new, const GTransform *t1, const GTransform *t2);
+void gtransform_checked_scale(GTransform *t_new, const GTransform *t, GTransformNumber sx,
+                              GTransformNumber sy);
+void gtransform_checked_translate(GTransform *t_new, const GTransform *t, GTransformNumber tx,
+                                  GTransformNumber ty);
+GPointPrecise gtransform_checked_point_from_gpoint(GTransformCheckedFunction function,
+                                                   GPoint point);
+GPointPrecise gtransform_checked_point_transform(GTransformCheckedFunction function,
+                                                 GPointPrecise pointP, const GTransform *t);
+void gtransform_checked_points_kernel(const GTransformPrepared *prepared, const GPoint *in,
+                                      GPointPrecise *out, size_t n);
+
+#endif
+
+//!     @} // end addtogroup GraphicsTransformChecked
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,280 @@
+#include <pebble.h>
+
+#include "gtransform_context.h"
+
+// Coefficients that differ by this many steps still count as equal when deciding whether a
+// matrix scales uniformly, since a rotation concatenated with a scale rounds its sine terms
+// differently depending on their sign
+#define UNIFORM_TOLERANCE 2
+
+//////////////////////////////////////
+/// Helpers
+//////////////////////////////////////
+static int32_t prv_abs(int32_t value) {
+  return (value < 0) ? -value : value;
+}
+
+static const GTransform *prv_current(const GTransformContext *tctx) {
+  return &tctx->stack[tctx->depth];
+}
+
+// Runs whenever the current matrix changes so that the drawing calls only read the results
+static void prv_update_cache(GTransformContext *tctx) {
+  const GTransform *t = prv_current(tctx);
+  const int32_t a = t->a.raw_value;
+  const int32_t b = t->b.raw_value;
+  const int32_t c = t->c.raw_value;
+  const int32_t d = t->d.raw_value;
+
+  tctx->type = gtransform_classify(t);
+  tctx->uniform = ((prv_abs(a - d) <= UNIFORM_TOLERANCE) &&
+                   (prv_abs(b + c) <= UNIFORM_TOLERANCE)) ||
+                  ((prv_abs(a + d) <= UNIFORM_TOLERANCE) &&
+                   (prv_abs(b - c) <= UNIFORM_TOLERANCE));
+  // The square of a 16.16 length is in 32.32 format, so its root is in 16.16 format again
+  tctx->scale = Fixed_S32_16(
+      (int32_t)fixed_isqrt((uint64_t)((int64_t)a * a) + (uint64_t)((int64_t)b * b)));
+}
+
+static GPoint prv_transform(const GTransformContext *tctx, GPoint point) {
+  return GPointFromGPointPreciseRounded(gpoint_transform(point, prv_current(tctx)));
+}
+
+static bool prv_is_axis_aligned(const GTransformContext *tctx) {
+  return (tctx->type != GTransformClassGeneral);
+}
+
+static uint16_t prv_scale_radius(const GTransformContext *tctx, uint16_t radius) {
+  const int64_t scaled = ((int64_t)radius * tctx->scale.raw_value +
+                          (1 << (FIXED_S32_16_PRECISION - 1))) >> FIXED_S32_16_PRECISION;
+  return (scaled > UINT16_MAX) ? UINT16_MAX : (uint16_t)scaled;
+}
+
+// Only valid while the matrix keeps the rectangle axis aligned, where the transformed corners
+// may have swapped if the matrix mirrors
+static GRect prv_transform_rect(const GTransformContext *tctx, GRect rect) {
+  const GPoint p0 = prv_transform(tctx, rect.origin);
+  const GPoint p1 = prv_transform(tctx, GPoint(rect.origin.x + rect.size.w,
+                                               rect.origin.y + rect.size.h));
+  const int16_t min_x = (p0.x < p1.x) ? p0.x : p1.x;
+  const int16_t min_y = (p0.y < p1.y) ? p0.y : p1.y;
+  return GRect(min_x, min_y, prv_abs(p1.x - p0.x), prv_abs(p1.y - p0.y));
+}
+
+static void prv_draw_points(const GTransformContext *tctx, GPoint *points, uint32_t num_points,
+                            bool filled) {
+  GPath path = {
+    .num_points = num_points,
+    .points = points,
+    .rotation = 0,
+    .offset = GPoint(0, 0),
+  };
+  if (filled) {
+    gpath_draw_filled(tctx->ctx, &path);
+  } else {
+    gpath_draw_outline(tctx->ctx, &path);
+  }
+}
+
+static void prv_draw_rect_path(const GTransformContext *tctx, GRect rect, bool filled) {
+  const int16_t x1 = rect.origin.x + rect.size.w;
+  const int16_t y1 = rect.origin.y + rect.size.h;
+  GPoint points[] = {
+    prv_transform(tctx, rect.origin),
+    prv_transform(tctx, GPoint(x1, rect.origin.y)),
+    prv_transform(tctx, GPoint(x1, y1)),
+    prv_transform(tctx, GPoint(rect.origin.x, y1)),
+  };
+  prv_draw_points(tctx, points, ARRAY_LENGTH(points), filled);
+}
+
+// The points are placed on the circle before transformation, in GPointPrecise so that small
+// circles keep their shape
+static void prv_draw_ellipse_path(const GTransformContext *tctx, GPoint center, uint16_t radius,
+                                  bool filled) {
+  const GTransform *t = prv_current(tctx);
+  const int32_t radius_precise = radius << GPOINT_PRECISE_PRECISION;
+  const GPointPrecise centerP = GPointPreciseFromGPoint(center);
+
+  GPoint points[GTRANSFORM_CONTEXT_ELLIPSE_POINTS];
+  for (int i = 0; i < GTRANSFORM_CONTEXT_ELLIPSE_POINTS; i++) {
+    const int32_t angle = (i * TRIG_MAX_ANGLE) / GTRANSFORM_CONTEXT_ELLIPSE_POINTS;
+    const GPointPrecise pointP = GPointPrecise(
+        centerP.x.raw_value + (radius_precise * cos_lookup(angle)) / TRIG_MAX_RATIO,
+        centerP.y.raw_value + (radius_precise * sin_lookup(angle)) / TRIG_MAX_RATIO);
+    points[i] = GPointFromGPointPreciseRounded(gpointprecise_transform(pointP, t));
+  }
+  prv_draw_points(tctx, points, GTRANSFORM_CONTEXT_ELLIPSE_POINTS, filled);
+}
+
+static bool prv_draw_path(GTransformContext *tctx, const GPathInfo *info, bool filled) {
+  if ((!tctx) || (!info) || (info->num_points > GTRANSFORM_CONTEXT_MAX_PATH_POINTS)) {
+    return false;
+  }
+
+  GPointPrecise pointsP[GTRANSFORM_CONTEXT_MAX_PATH_POINTS];
+  GPoint points[GTRANSFORM_CONTEXT_MAX_PATH_POINTS];
+  gpath_info_transform_precise(info, prv_current(tctx), pointsP, NULL);
+  for (size_t i = 0; i < info->num_points; i++) {
+    points[i] = GPointFromGPointPreciseRounded(pointsP[i]);
+  }
+  prv_draw_points(tctx, points, info->num_points, filled);
+  return true;
+}
+
+//////////////////////////////////////
+/// Current Matrix
+//////////////////////////////////////
+void gtransform_context_init(GTransformContext *tctx, GContext *ctx) {
+  if (!tctx) {
+    return;
+  }
+
+  tctx->ctx = ctx;
+  tctx->depth = 0;
+  tctx->stack[0] = GTransformIdentity();
+  prv_update_cache(tctx);
+}
+
+void gtransform_context_set(GTransformContext *tctx, const GTransform *t) {
+  if (!tctx) {
+    return;
+  }
+
+  tctx->stack[tctx->depth] = t ? *t : GTransformIdentity();
+  prv_update_cache(tctx);
+}
+
+const GTransform *gtransform_context_get(const GTransformContext *tctx) {
+  return tctx ? prv_current(tctx) : NULL;
+}
+
+void gtransform_context_concat(GTransformContext *tctx, const GTransform *t) {
+  if ((!tctx) || (!t)) {
+    return;
+  }
+
+  GTransform *current = &tctx->stack[tctx->depth];
+  gtransform_concat(current, t, current);
+  prv_update_cache(tctx);
+}
+
+void gtransform_context_translate(GTransformContext *tctx, GTransformNumber tx,
+                                  GTransformNumber ty) {
+  if (!tctx) {
+    return;
+  }
+
+  GTransform *current = &tctx->stack[tctx->depth];
+  gtransform_translate(current, current, tx, ty);
+  prv_update_cache(tctx);
+}
+
+void gtransform_context_scale(GTransformContext *tctx, GTransformNumber sx, GTransformNumber sy) {
+  if (!tctx) {
+    return;
+  }
+
+  GTransform *current = &tctx->stack[tctx->depth];
+  gtransform_scale(current, current, sx, sy);
+  prv_update_cache(tctx);
+}
+
+void gtransform_context_rotate(GTransformContext *tctx, int32_t angle) {
+  if (!tctx) {
+    return;
+  }
+
+  GTransform *current = &tctx->stack[tctx->depth];
+  gtransform_rotate_cached(current, current, angle);
+  prv_update_cache(tctx);
+}
+
+// The cached class and scale belong to the current matrix, which the push copies unchanged, so
+// only a pop needs to recompute them
+bool gtransform_context_push(GTransformContext *tctx) {
+  if ((!tctx) || (tctx->depth + 1 >= GTRANSFORM_CONTEXT_STACK_SIZE)) {
+    return false;
+  }
+
+  tctx->stack[tctx->depth + 1] = tctx->stack[tctx->depth];
+  tctx->depth++;
+  return true;
+}
+
+bool gtransform_context_pop(GTransformContext *tctx) {
+  if ((!tctx) || (tctx->depth == 0)) {
+    return false;
+  }
+
+  tctx->depth--;
+  prv_update_cache(tctx);
+  return true;
+}
+
+//////////////////////////////////////
+/// Drawing
+//////////////////////////////////////
+void gtransform_context_draw_line(GTransformContext *tctx, GPoint p0, GPoint p1) {
+  if (!tctx) {
+    return;
+  }
+
+  graphics_draw_line(tctx->ctx, prv_transform(tctx, p0), prv_transform(tctx, p1));
+}
+
+void gtransform_context_draw_rect(GTransformContext *tctx, GRect rect) {
+  if (!tctx) {
+    return;
+  }
+
+  if (prv_is_axis_aligned(tctx)) {
+    graphics_draw_rect(tctx->ctx, prv_transform_rect(tctx, rect));
+  } else {
+    prv_draw_rect_path(tctx, rect, false);
+  }
+}
+
+void gtransform_context_fill_rect(GTransformContext *tctx, GRect rect) {
+  if (!tctx) {
+    return;
+  }
+
+  if (prv_is_axis_aligned(tctx)) {
+    graphics_fill_rect(tctx->ctx, prv_transform_rect(tctx, rect), 0, GCornerNone);
+  } else {
+    prv_draw_rect_path(tctx, rect, true);
+  }
+}
+
+void gtransform_context_draw_circle(GTransformContext *tctx, GPoint center, uint16_t radius) {
+  if (!tctx) {
+    return;
+  }
+
+  if (tctx->uniform) {
+    graphics_draw_circle(tctx->ctx, prv_transform(tctx, center), prv_scale_radius(tctx, radius));
+  } else {
+    prv_draw_ellipse_path(tctx, center, radius, false);
+  }
+}
+
+void gtransform_context_fill_circle(GTransformContext *tctx, GPoint center, uint16_t radius) {
+  if (!tctx) {
+    return;
+  }
+
+  if (tctx->uniform) {
+    graphics_fill_circle(tctx->ctx, prv_transform(tctx, center), prv_scale_radius(tctx, radius));
+  } else {
+    prv_draw_ellipse_path(tctx, center, radius, true);
+  }
+}
+
+bool gtransform_context_draw_path(GTransformContext *tctx, const GPathInfo *info) {
+  return prv_draw_path(tctx, info, false);
+}
+
+bool gtransform_context_fill_path(GTransformContext *tctx, const GPathInfo *info) {
+  return prv_draw_path(tctx, info, true);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformContext Transformed Drawing
+//! \brief A graphics context wrapper that applies a current transformation matrix to every
+//! drawing call.
+//!
+//! The current matrix is classified once whenever it changes, so each drawing call only
+//! transforms its points before it goes straight to the native primitive. Rectangles stay
+//! rectangles as long as the matrix keeps them axis aligned, and circles stay circles as long as
+//! it scales uniformly; only rotated rectangles and circles that are sheared or stretched into
+//! ellipses are drawn as paths. Stroke widths and colors are taken from the GContext unchanged.
+//! Transformed points are rounded to the nearest pixel, as the native primitives take GPoint;
+//! the functions of gdraw_precise.h draw from the 1/8 px points without rounding them.
+//!     @{
+
+//! Number of matrices the push/pop stack can hold, including the current one
+#define GTRANSFORM_CONTEXT_STACK_SIZE 8
+
+//! Most points of a path that can be drawn through the wrapper
+#define GTRANSFORM_CONTEXT_MAX_PATH_POINTS 32
+
+//! Number of points of the path that replaces a circle which is not drawn as a circle
+#define GTRANSFORM_CONTEXT_ELLIPSE_POINTS 24
+
+//! A graphics context with a current transformation matrix
+typedef struct GTransformContext {
+  //! Context that the transformed primitives are drawn into
+  GContext *ctx;
+  //! Saved matrices; the current matrix is stack[depth]
+  GTransform stack[GTRANSFORM_CONTEXT_STACK_SIZE];
+  //! Number of saved matrices below the current one
+  uint8_t depth;
+  //! @internal
+  //! Class of the current matrix
+  GTransformClass type;
+  //! @internal
+  //! Set if the current matrix only rotates, mirrors, scales uniformly and translates
+  bool uniform;
+  //! @internal
+  //! Scale factor of the current matrix, valid if uniform is set
+  GTransformNumber scale;
+} GTransformContext;
+
+//! Initializes a transformed context with the identity matrix and an empty stack.
+//! @param tctx Pointer to the transformed context
+//! @param ctx Context that the transformed primitives are drawn into
+void gtransform_context_init(GTransformContext *tctx, GContext *ctx);
+
+//! Replaces the current matrix.
+//! @param tctx Pointer to the transformed context
+//! @param t Pointer to the new matrix; if NULL the identity is used.
+void gtransform_context_set(GTransformContext *tctx, const GTransform *t);
+
+//! Returns the current matrix.
+//! @param tctx Pointer to the transformed context
+//! @return Pointer to the current matrix; NULL if tctx is NULL.
+const GTransform *gtransform_context_get(const GTransformContext *tctx);
+
+//! Concatenates a matrix in front of the current one (i.e. current = t*current), so that t is
+//! applied to the coordinates passed to the drawing calls before the current matrix.
+//! @param tctx Pointer to the transformed context
+//! @param t Pointer to the matrix to apply
+void gtransform_context_concat(GTransformContext *tctx, const GTransform *t);
+
+//! Translates the coordinates of the following drawing calls, as gtransform_translate.
+//! @param tctx Pointer to the transformed context
+//! @param tx X translation factor
+//! @param ty Y translation factor
+void gtransform_context_translate(GTransformContext *tctx, GTransformNumber tx,
+                                  GTransformNumber ty);
+
+//! Scales the coordinates of the following drawing calls, as gtransform_scale.
+//! @param tctx Pointer to the transformed context
+//! @param sx X scaling factor
+//! @param sy Y scaling factor
+void gtransform_context_scale(GTransformContext *tctx, GTransformNumber sx, GTransformNumber sy);
+
+//! Rotates the coordinates of the following drawing calls, as gtransform_rotate_cached.
+//! @param tctx Pointer to the transformed context
+//! @param angle Rotation angle to apply (type is in same format as trig angle 0..TRIG_MAX_ANGLE)
+void gtransform_context_rotate(GTransformContext *tctx, int32_t angle);
+
+//! Saves a copy of the current matrix so that it can be restored with gtransform_context_pop.
+//! @param tctx Pointer to the transformed context
+//! @return True if the matrix was saved; False if the stack is full or tctx is NULL.
+bool gtransform_context_push(GTransformContext *tctx);
+
+//! Restores the matrix saved by the matching gtransform_context_push.
+//! @param tctx Pointer to the transformed context
+//! @return True if a matrix was restored; False if the stack is empty or tctx is NULL.
+bool gtransform_context_pop(GTransformContext *tctx);
+
+//! Draws a transformed line with graphics_draw_line.
+//! @param tctx Pointer to the transformed context
+//! @param p0 First end of the line
+//! @param p1 Second end of the line
+void gtransform_context_draw_line(GTransformContext *tctx, GPoint p0, GPoint p1);
+
+//! Draws the outline of a transformed rectangle with graphics_draw_rect, or as a path if the
+//! matrix rotates or shears it.
+//! @param tctx Pointer to the transformed context
+//! @param rect Rectangle to draw
+void gtransform_context_draw_rect(GTransformContext *tctx, GRect rect);
+
+//! Fills a transformed rectangle with graphics_fill_rect, or as a path if the matrix rotates or
+//! shears it.
+//! @param tctx Pointer to the transformed context
+//! @param rect Rectangle to fill
+void gtransform_context_fill_rect(GTransformContext *tctx, GRect rect);
+
+//! Draws the outline of a transformed circle with graphics_draw_circle and a scaled radius, or
+//! as a path if the matrix turns it into an ellipse.
+//! @param tctx Pointer to the transformed context
+//! @param center Center of the circle
+//! @param radius Radius of the circle before transformation
+void gtransform_context_draw_circle(GTransformContext *tctx, GPoint center, uint16_t radius);
+
+//! Fills a transformed circle with graphics_fill_circle and a scaled radius, or as a path if
+//! the matrix turns it into an ellipse.
+//! @param tctx Pointer to the transformed context
+//! @param center Center of the circle
+//! @param radius Radius of the circle before transformation
+void gtransform_context_fill_circle(GTransformContext *tctx, GPoint center, uint16_t radius);
+
+//! Draws the outline of a transformed path with gpath_draw_outline. The points are transformed
+//! into a buffer on the stack, so no memory is allocated.
+//! @param tctx Pointer to the transformed context
+//! @param info Pointer to the path to draw
+//! @return True if the path was drawn; False if it has more than
+//! GTRANSFORM_CONTEXT_MAX_PATH_POINTS points or an argument is NULL.
+bool gtransform_context_draw_path(GTransformContext *tctx, const GPathInfo *info);
+
+//! Fills a transformed path with gpath_draw_filled. The points are transformed into a buffer
+//! on the stack, so no memory is allocated.
+//! @param tctx Pointer to the transformed context
+//! @param info Pointer to the path to fill
+//! @return True if the path was drawn; False if it has more than
+//! GTRANSFORM_CONTEXT_MAX_PATH_POINTS points or an argument is NULL.
+bool gtransform_context_fill_path(GTransformContext *tctx, const GPathInfo *info);
+
+//!     @} // end addtogroup GraphicsTransformContext
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
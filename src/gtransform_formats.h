@@ -0,0 +1,138 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+#include "math_fixed.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformFormats Transform Formats
+//! \brief Transformation matrices and points in other fixed point formats than GTransform and
+//! GPointPrecise.
+//!
+//! Smaller formats halve the memory of large point sets and only need 16-bit multiplies; larger
+//! formats transform coordinates far beyond the ±4096 px of GPointPrecise without overflowing.
+//! A format is instantiated from any coefficient and coordinate types created with
+//! FIXED_DEFINE_FORMAT (or the built-in Fixed_S16_3 and Fixed_S32_16), so new ones need no edits
+//! to the library. The following are predefined:
+//!   GTransformQ8_8   / GPointQ8_8:   Q8.8 coefficients and coordinates
+//!   GTransformQ16_16 / GPointQ16_16: Q16.16 coefficients and coordinates
+//!   GTransformQ24_8  / GPointQ24_8:  Q16.16 coefficients and Q24.8 coordinates
+//!     @{
+
+//! Defines a transformation matrix and point type pair in the given fixed point formats.
+//! The matrix has the same layout and meaning as GTransform. The following functions are
+//! generated, prefixed with func:
+//!   func_identity()                       identity matrix
+//!   func_from_gtransform(t)               converts a GTransform, rounding down extra precision
+//!   func_concat(t_new, t1, t2)            t_new = t1*t2 as gtransform_concat; t_new may alias
+//!   func_point_from_gpoint(point)         converts a GPoint
+//!   func_point_to_gpoint(point)           converts to a GPoint, rounding down
+//!   func_point_transform(point, t)        transforms a point as gpoint_transform would
+//!   func_point_transform_saturating(point, t)
+//!                                         same, but results out of range are clamped
+//! @param transform Name of the matrix type
+//! @param point Name of the point type
+//! @param func Prefix of the generated functions
+//! @param number Fixed point type of the coefficients
+//! @param number_bits Fraction bits of number
+//! @param coordinate Fixed point type of the coordinates
+//! @param coordinate_bits Fraction bits of coordinate
+//! @param wide Signed integer type that holds the product of a coordinate and a coefficient
+#define GTRANSFORM_DEFINE_FORMAT(transform, point, func, number, number_bits, coordinate, \
+                                 coordinate_bits, wide) \
+  typedef struct transform { \
+    number a; \
+    number b; \
+    number c; \
+    number d; \
+    number tx; \
+    number ty; \
+  } transform; \
+  \
+  typedef struct point { \
+    coordinate x; \
+    coordinate y; \
+  } point; \
+  \
+  static __inline__ transform func##_identity(void) { \
+    const number zero = number##_from_int(0); \
+    const number one = number##_from_int(1); \
+    return (transform){ one, zero, zero, one, zero, zero }; \
+  } \
+  \
+  static __inline__ transform func##_from_gtransform(const GTransform *t) { \
+    return (transform){ \
+      number##_wrap(fixed_rescale(t->a.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+      number##_wrap(fixed_rescale(t->b.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+      number##_wrap(fixed_rescale(t->c.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+      number##_wrap(fixed_rescale(t->d.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+      number##_wrap(fixed_rescale(t->tx.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+      number##_wrap(fixed_rescale(t->ty.raw_value, FIXED_S32_16_PRECISION, number_bits)), \
+    }; \
+  } \
+  \
+  static __inline__ void func##_concat(transform *t_new, const transform *t1, \
+                                       const transform *t2) { \
+    const transform t = { \
+      number##_add(number##_mul(t1->a, t2->a), number##_mul(t1->b, t2->c)), \
+      number##_add(number##_mul(t1->a, t2->b), number##_mul(t1->b, t2->d)), \
+      number##_add(number##_mul(t1->c, t2->a), number##_mul(t1->d, t2->c)), \
+      number##_add(number##_mul(t1->c, t2->b), number##_mul(t1->d, t2->d)), \
+      number##_add(number##_add(number##_mul(t1->tx, t2->a), number##_mul(t1->ty, t2->c)), \
+                   t2->tx), \
+      number##_add(number##_add(number##_mul(t1->tx, t2->b), number##_mul(t1->ty, t2->d)), \
+                   t2->ty), \
+    }; \
+    *t_new = t; \
+  } \
+  \
+  static __inline__ point func##_point_from_gpoint(GPoint p) { \
+    return (point){ coordinate##_from_int(p.x), coordinate##_from_int(p.y) }; \
+  } \
+  \
+  static __inline__ GPoint func##_point_to_gpoint(point p) { \
+    return GPoint((int16_t)coordinate##_to_int(p.x), (int16_t)coordinate##_to_int(p.y)); \
+  } \
+  \
+  /* Each product is rounded down on its own, like Fixed_S16_3_S32_16_mul */ \
+  static __inline__ wide func##_point_mul(coordinate v, number k) { \
+    return ((wide)v.raw_value * k.raw_value) >> (number_bits); \
+  } \
+  \
+  static __inline__ point func##_point_transform(point p, const transform *t) { \
+    const wide one_tx = (wide)fixed_rescale(t->tx.raw_value, number_bits, coordinate_bits); \
+    const wide one_ty = (wide)fixed_rescale(t->ty.raw_value, number_bits, coordinate_bits); \
+    return (point){ \
+      coordinate##_wrap(func##_point_mul(p.x, t->a) + func##_point_mul(p.y, t->c) + one_tx), \
+      coordinate##_wrap(func##_point_mul(p.x, t->b) + func##_point_mul(p.y, t->d) + one_ty), \
+    }; \
+  } \
+  \
+  static __inline__ point func##_point_transform_saturating(point p, const transform *t) { \
+    const wide one_tx = (wide)fixed_rescale(t->tx.raw_value, number_bits, coordinate_bits); \
+    const wide one_ty = (wide)fixed_rescale(t->ty.raw_value, number_bits, coordinate_bits); \
+    return (point){ \
+      coordinate##_clamp(func##_point_mul(p.x, t->a) + func##_point_mul(p.y, t->c) + one_tx), \
+      coordinate##_clamp(func##_point_mul(p.x, t->b) + func##_point_mul(p.y, t->d) + one_ty), \
+    }; \
+  }
+
+GTRANSFORM_DEFINE_FORMAT(GTransformQ8_8, GPointQ8_8, gtransform_q8_8,
+                         Fixed_S16_8, FIXED_S16_8_PRECISION,
+                         Fixed_S16_8, FIXED_S16_8_PRECISION, int32_t)
+
+GTRANSFORM_DEFINE_FORMAT(GTransformQ16_16, GPointQ16_16, gtransform_q16_16,
+                         Fixed_S32_16, FIXED_S32_16_PRECISION,
+                         Fixed_S32_16, FIXED_S32_16_PRECISION, int64_t)
+
+GTRANSFORM_DEFINE_FORMAT(GTransformQ24_8, GPointQ24_8, gtransform_q24_8,
+                         Fixed_S32_16, FIXED_S32_16_PRECISION,
+                         Fixed_S32_8, FIXED_S32_8_PRECISION, int64_t)
+
+//!     @} // end addtogroup GraphicsTransformFormats
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,188 @@
+#include <pebble.h>
+
+#include "gtransform_interpolate.h"
+
+#include <string.h>
+
+//////////////////////////////////////
+/// Helpers
+//////////////////////////////////////
+// atan2_lookup takes 16-bit arguments, so both are shifted down together to keep their ratio
+static int32_t prv_atan2(int64_t y, int64_t x) {
+  while ((y > INT16_MAX) || (y < -INT16_MAX) || (x > INT16_MAX) || (x < -INT16_MAX)) {
+    y /= 2;
+    x /= 2;
+  }
+  return atan2_lookup((int16_t)y, (int16_t)x);
+}
+
+static void prv_interpolate_linear(GTransform *t_out, const GTransform *t_from,
+                                   const GTransform *t_to, AnimationProgress progress) {
+  const int32_t weight = gtransform_weight_from_progress(progress);
+  // Computed into a temporary so that t_out may alias either input
+  const GTransform t = {
+    .a = gtransform_lerp_number(t_from->a, t_to->a, weight),
+    .b = gtransform_lerp_number(t_from->b, t_to->b, weight),
+    .c = gtransform_lerp_number(t_from->c, t_to->c, weight),
+    .d = gtransform_lerp_number(t_from->d, t_to->d, weight),
+    .tx = gtransform_lerp_number(t_from->tx, t_to->tx, weight),
+    .ty = gtransform_lerp_number(t_from->ty, t_to->ty, weight),
+  };
+  *t_out = t;
+}
+
+static void prv_interpolate_parts(GTransform *t_out, const GTransformDecomposition *from,
+                                  const GTransformDecomposition *to, AnimationProgress progress) {
+  const int32_t weight = gtransform_weight_from_progress(progress);
+
+  // Turn along the shorter arc
+  int32_t delta_angle = (to->angle - from->angle) & (TRIG_MAX_ANGLE - 1);
+  if (delta_angle >= TRIG_MAX_ANGLE / 2) {
+    delta_angle -= TRIG_MAX_ANGLE;
+  }
+
+  const GTransformDecomposition parts = {
+    .sx = gtransform_lerp_number(from->sx, to->sx, weight),
+    .sy = gtransform_lerp_number(from->sy, to->sy, weight),
+    .k = gtransform_lerp_number(from->k, to->k, weight),
+    .angle = gtransform_lerp_raw(from->angle, from->angle + delta_angle, weight),
+    .tx = gtransform_lerp_number(from->tx, to->tx, weight),
+    .ty = gtransform_lerp_number(from->ty, to->ty, weight),
+  };
+  gtransform_recompose(t_out, &parts);
+}
+
+//////////////////////////////////////
+/// Decomposition
+//////////////////////////////////////
+bool gtransform_decompose(GTransformDecomposition *parts, const GTransform *t) {
+  if ((!parts) || (!t)) {
+    return false;
+  }
+
+  const int64_t a = t->a.raw_value;
+  const int64_t b = t->b.raw_value;
+  const int64_t c = t->c.raw_value;
+  const int64_t d = t->d.raw_value;
+
+  // The first row is sx * (cos, -sin); products of 16.16 values are in 32.32
+  const uint32_t sx = fixed_isqrt((uint64_t)(a * a) + (uint64_t)(b * b));
+  if ((sx == 0) || (sx > INT32_MAX)) {
+    return false;
+  }
+
+  // Projecting the second row on the unit first row gives the shear, and on its normal the
+  // y scale, which is also the determinant divided by sx
+  const int64_t k = ((a * c) + (b * d)) / (int64_t)sx;
+  const int64_t sy = ((a * d) - (b * c)) / (int64_t)sx;
+  if ((k > INT32_MAX) || (k < INT32_MIN) || (sy > INT32_MAX) || (sy < INT32_MIN)) {
+    return false;
+  }
+
+  *parts = (GTransformDecomposition) {
+    .sx = Fixed_S32_16((int32_t)sx),
+    .sy = Fixed_S32_16((int32_t)sy),
+    .k = Fixed_S32_16((int32_t)k),
+    .angle = prv_atan2(-b, a),
+    .tx = t->tx,
+    .ty = t->ty,
+  };
+  return true;
+}
+
+void gtransform_recompose(GTransform *t_new, const GTransformDecomposition *parts) {
+  if ((!t_new) || (!parts)) {
+    return;
+  }
+
+  const GTransform r = gtransform_init_rotation_cached(parts->angle);
+  const GTransformNumber cosine = r.a;
+  const GTransformNumber sine = r.c;
+
+  const GTransform t = {
+    .a = Fixed_S32_16_mul(parts->sx, cosine),
+    .b = Fixed_S32_16(-Fixed_S32_16_mul(parts->sx, sine).raw_value),
+    .c = Fixed_S32_16_add(Fixed_S32_16_mul(parts->k, cosine),
+                          Fixed_S32_16_mul(parts->sy, sine)),
+    .d = Fixed_S32_16(Fixed_S32_16_mul(parts->sy, cosine).raw_value -
+                      Fixed_S32_16_mul(parts->k, sine).raw_value),
+    .tx = parts->tx,
+    .ty = parts->ty,
+  };
+  *t_new = t;
+}
+
+//////////////////////////////////////
+/// Interpolation
+//////////////////////////////////////
+void gtransform_interpolate(GTransform *t_out, const GTransform *t_from, const GTransform *t_to,
+                            AnimationProgress progress, GTransformInterpolation mode) {
+  if ((!t_out) || (!t_from) || (!t_to)) {
+    return;
+  }
+
+  // Ends of the animation need no work and must not pick up recomposition rounding
+  if (progress == ANIMATION_NORMALIZED_MIN) {
+    *t_out = *t_from;
+    return;
+  } else if (progress == ANIMATION_NORMALIZED_MAX) {
+    *t_out = *t_to;
+    return;
+  }
+
+  GTransformDecomposition from;
+  GTransformDecomposition to;
+  if ((mode == GTransformInterpolationDecomposed) && gtransform_decompose(&from, t_from) &&
+      gtransform_decompose(&to, t_to)) {
+    prv_interpolate_parts(t_out, &from, &to, progress);
+  } else {
+    prv_interpolate_linear(t_out, t_from, t_to, progress);
+  }
+}
+
+void gtransform_tween_init(GTransformTween *tween, const GTransform *from, const GTransform *to,
+                           GTransformInterpolation mode) {
+  if ((!tween) || (!from) || (!to)) {
+    return;
+  }
+
+  memset(tween, 0, sizeof(*tween));
+  tween->from = *from;
+  tween->to = *to;
+  tween->mode = mode;
+
+  if ((mode == GTransformInterpolationDecomposed) &&
+      !(gtransform_decompose(&tween->from_parts, from) &&
+        gtransform_decompose(&tween->to_parts, to))) {
+    tween->mode = GTransformInterpolationLinear;
+  }
+}
+
+void gtransform_tween_evaluate(const GTransformTween *tween, AnimationProgress progress,
+                               GTransform *t_out) {
+  if ((!tween) || (!t_out)) {
+    return;
+  }
+
+  if (progress == ANIMATION_NORMALIZED_MIN) {
+    *t_out = tween->from;
+  } else if (progress == ANIMATION_NORMALIZED_MAX) {
+    *t_out = tween->to;
+  } else if (tween->mode == GTransformInterpolationDecomposed) {
+    prv_interpolate_parts(t_out, &tween->from_parts, &tween->to_parts, progress);
+  } else {
+    prv_interpolate_linear(t_out, &tween->from, &tween->to, progress);
+  }
+}
+
+void gtransform_tween_evaluate_array(const GTransformTween *tweens,
+                                     const AnimationProgress *progress, GTransform *t_out,
+                                     size_t n) {
+  if ((!tweens) || (!progress) || (!t_out)) {
+    return;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    gtransform_tween_evaluate(&tweens[i], progress[i], &t_out[i]);
+  }
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformInterpolation Interpolating Transforms
+//! \brief Integer-only interpolation between two transformation matrices, driven by the
+//! progress of an animation.
+//!
+//! Linear interpolation blends each coefficient independently; it is the cheapest but a rotation
+//! shrinks towards its midpoint. Decomposed interpolation blends scale, shear, rotation and
+//! translation separately, so rotating objects keep their size and turn along the shorter arc.
+//!     @{
+
+//! Ways of interpolating between two transformation matrices
+typedef enum GTransformInterpolation {
+  //! Every coefficient is interpolated on its own
+  GTransformInterpolationLinear,
+  //! Scale, shear, rotation and translation are interpolated separately
+  GTransformInterpolationDecomposed,
+} GTransformInterpolation;
+
+//! A transformation matrix split into its components. The matrix is recomposed as
+//! [ sx 0 ] * rotation(angle), with its translation (tx, ty) unchanged.
+//! [ k sy ]
+typedef struct GTransformDecomposition {
+  //! Scale along the rotated x-axis
+  GTransformNumber sx;
+  //! Scale along the rotated y-axis; negative if the matrix mirrors
+  GTransformNumber sy;
+  //! Shear of the y-axis along the rotated x-axis
+  GTransformNumber k;
+  //! Angle of rotation in TRIG_MAX_ANGLE units, from 0 to TRIG_MAX_ANGLE
+  int32_t angle;
+  //! X translation
+  GTransformNumber tx;
+  //! Y translation
+  GTransformNumber ty;
+} GTransformDecomposition;
+
+//! An animation between two matrices whose decompositions are computed once, so that advancing
+//! it only takes integer multiplies and one rotation table lookup.
+typedef struct GTransformTween {
+  //! Matrix at ANIMATION_NORMALIZED_MIN
+  GTransform from;
+  //! Matrix at ANIMATION_NORMALIZED_MAX
+  GTransform to;
+  //! Components of from, used by decomposed interpolation
+  GTransformDecomposition from_parts;
+  //! Components of to, used by decomposed interpolation
+  GTransformDecomposition to_parts;
+  //! How the tween interpolates
+  GTransformInterpolation mode;
+} GTransformTween;
+
+//! @internal
+//! Weight of one end of an interpolation against the other, in 1/GTRANSFORM_WEIGHT_ONE units.
+//! 28 bits keep the blend of two raw values that are as far apart as an int32_t allows, times a
+//! weight that overshoots by up to a factor of 4, within 64 bits.
+#define GTRANSFORM_WEIGHT_PRECISION 28
+#define GTRANSFORM_WEIGHT_ONE (1 << GTRANSFORM_WEIGHT_PRECISION)
+
+#if ANIMATION_NORMALIZED_MAX != 65535
+#error "gtransform_weight_from_progress expects ANIMATION_NORMALIZED_MAX to be 2^16 - 1"
+#endif
+
+//! @internal
+//! Rescales the progress of an animation to a weight without a division: 65535 * 65537 is
+//! 2^32 - 1, so multiplying by 65537 and rounding off 4 bits maps ANIMATION_NORMALIZED_MAX to
+//! exactly GTRANSFORM_WEIGHT_ONE.
+//! @param progress Progress of the animation; values outside of the animation range extrapolate
+//! @return Weight in 1/GTRANSFORM_WEIGHT_ONE units
+static __inline__ int32_t gtransform_weight_from_progress(AnimationProgress progress) {
+  return (int32_t)(((int64_t)progress * 65537 + 8) >> 4);
+}
+
+//! @internal
+//! Blends two raw values with a multiply and a shift. The result is exactly from at a weight of
+//! 0 and exactly to at GTRANSFORM_WEIGHT_ONE, and rounded to nearest in between.
+//! @param from Raw value at a weight of 0
+//! @param to Raw value at a weight of GTRANSFORM_WEIGHT_ONE
+//! @param weight Weight of to in 1/GTRANSFORM_WEIGHT_ONE units
+//! @return Blended raw value
+static __inline__ int32_t gtransform_lerp_raw(int32_t from, int32_t to, int32_t weight) {
+  const int64_t delta = (int64_t)to - from;
+  return (int32_t)(from + ((delta * weight + (GTRANSFORM_WEIGHT_ONE / 2)) >>
+                           GTRANSFORM_WEIGHT_PRECISION));
+}
+
+//! @internal
+//! Blends two GTransformNumbers with gtransform_lerp_raw.
+//! @param from Value at a weight of 0
+//! @param to Value at a weight of GTRANSFORM_WEIGHT_ONE
+//! @param weight Weight of to in 1/GTRANSFORM_WEIGHT_ONE units
+//! @return Blended value
+static __inline__ GTransformNumber gtransform_lerp_number(GTransformNumber from,
+                                                         GTransformNumber to, int32_t weight) {
+  return Fixed_S32_16(gtransform_lerp_raw(from.raw_value, to.raw_value, weight));
+}
+
+//! Splits a transformation matrix into scale, shear, rotation and translation.
+//! @param parts Pointer to the destination of the components
+//! @param t Pointer to the transformation matrix to split
+//! @return `true` if the matrix was split, `false` if it collapses the x-axis (its first row is
+//! zero) or an argument is NULL.
+bool gtransform_decompose(GTransformDecomposition *parts, const GTransform *t);
+
+//! Builds the transformation matrix that corresponds to a set of components.
+//! @param t_new Pointer to the destination matrix
+//! @param parts Pointer to the components
+void gtransform_recompose(GTransform *t_new, const GTransformDecomposition *parts);
+
+//! Interpolates between two transformation matrices.
+//! Progress values outside of the animation range extrapolate, as overshooting curves expect.
+//! The result is exactly t_from at ANIMATION_NORMALIZED_MIN and exactly t_to at
+//! ANIMATION_NORMALIZED_MAX.
+//! @param t_out Pointer to the destination matrix; may be the same as t_from or t_to.
+//! @param t_from Pointer to the matrix at the start of the animation
+//! @param t_to Pointer to the matrix at the end of the animation
+//! @param progress Progress of the animation, from ANIMATION_NORMALIZED_MIN to
+//! ANIMATION_NORMALIZED_MAX
+//! @param mode How to interpolate; decomposed interpolation falls back to linear if a matrix
+//! cannot be decomposed.
+void gtransform_interpolate(GTransform *t_out, const GTransform *t_from, const GTransform *t_to,
+                            AnimationProgress progress, GTransformInterpolation mode);
+
+//! Prepares an animation between two matrices.
+//! @param tween Pointer to the tween to initialize
+//! @param from Pointer to the matrix at the start of the animation
+//! @param to Pointer to the matrix at the end of the animation
+//! @param mode How to interpolate; decomposed interpolation falls back to linear if a matrix
+//! cannot be decomposed.
+void gtransform_tween_init(GTransformTween *tween, const GTransform *from, const GTransform *to,
+                           GTransformInterpolation mode);
+
+//! Computes the matrix of a tween at a given progress, as gtransform_interpolate would.
+//! @param tween Pointer to the tween
+//! @param progress Progress of the animation
+//! @param t_out Pointer to the destination matrix
+void gtransform_tween_evaluate(const GTransformTween *tween, AnimationProgress progress,
+                               GTransform *t_out);
+
+//! Advances many tweens at once.
+//! @param tweens Pointer to the tweens
+//! @param progress Pointer to the progress of each tween
+//! @param t_out Pointer to the destination matrices, one per tween
+//! @param n Number of tweens
+void gtransform_tween_evaluate_array(const GTransformTween *tweens,
+                                     const AnimationProgress *progress, GTransform *t_out,
+                                     size_t n);
+
+//!     @} // end addtogroup GraphicsTransformInterpolation
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,342 @@
+#include <pebble.h>
+
+#include "gtransform_projective.h"
+
+// The reciprocal table is indexed by the 8 bits that follow the leading one of W
+#define RECIPROCAL_TABLE_BITS 8
+#define RECIPROCAL_TABLE_SIZE (1 << RECIPROCAL_TABLE_BITS)
+// Entries are 1/m for m in [0.5, 1), so they are in (1, 2] and have 15 fraction bits
+#define RECIPROCAL_TABLE_PRECISION 15
+// Refined reciprocals have 30 fraction bits
+#define RECIPROCAL_PRECISION 30
+
+#define PERSPECTIVE_PRECISION FIXED_S32_24_PRECISION
+
+// Largest and smallest GPointPrecise coordinates, in 16.16 format
+#define POINT_SHIFT (FIXED_S32_16_PRECISION - GPOINT_PRECISE_PRECISION)
+#define POINT_MAX ((int32_t)INT16_MAX << POINT_SHIFT)
+#define POINT_MIN ((int32_t)INT16_MIN * (1 << POINT_SHIFT))
+
+static __inline__ Fixed_S32_24 prv_perspective_number(int32_t raw_value) {
+  return (Fixed_S32_24){ raw_value };
+}
+
+static uint16_t s_reciprocal_table[RECIPROCAL_TABLE_SIZE];
+static bool s_reciprocal_table_initialized;
+
+//////////////////////////////////////
+/// Perspective Divide
+//////////////////////////////////////
+// Entry i is the reciprocal of the middle of [0.5 + i / 512, 0.5 + (i + 1) / 512), which is
+// 1024 / (513 + 2 * i), in the 15 fraction bits of the table and rounded
+static void prv_reciprocal_table_init(void) {
+  const uint32_t dividend = (uint32_t)1 << (RECIPROCAL_TABLE_PRECISION + RECIPROCAL_TABLE_BITS + 2);
+  for (uint32_t i = 0; i < RECIPROCAL_TABLE_SIZE; i++) {
+    const uint32_t divisor = (2 * RECIPROCAL_TABLE_SIZE + 1) + 2 * i;
+    s_reciprocal_table[i] = (uint16_t)((dividend + divisor / 2) / divisor);
+  }
+  s_reciprocal_table_initialized = true;
+}
+
+// Returns r such that 1/value is about r / 2^(*exponent). The table gives a first guess to
+// 9 bits, and one Newton-Raphson step r = r * (2 - m * r) doubles that. The step never
+// overshoots, so r is up to 2^-17.9 below the exact reciprocal and never above it.
+static uint32_t prv_reciprocal(uint64_t value, int32_t *exponent) {
+  if (!s_reciprocal_table_initialized) {
+    prv_reciprocal_table_init();
+  }
+
+  // value is m * 2^(64 - leading_zeros) with m in [0.5, 1), held in 32 fraction bits
+  const int32_t leading_zeros = __builtin_clzll(value);
+  const uint32_t m = (uint32_t)((value << leading_zeros) >> 32);
+  const uint32_t guess = s_reciprocal_table[(m >> (31 - RECIPROCAL_TABLE_BITS)) &
+                                            (RECIPROCAL_TABLE_SIZE - 1)];
+
+  // m * guess is close to 1; with 32 + 15 fraction bits, shifted down to 30
+  const uint32_t product = (uint32_t)(((uint64_t)m * guess) >>
+                                      (32 + RECIPROCAL_TABLE_PRECISION - RECIPROCAL_PRECISION));
+  const uint32_t two = (uint32_t)2 << RECIPROCAL_PRECISION;
+  const uint32_t refined = (uint32_t)(((uint64_t)guess * (two - product)) >>
+                                      RECIPROCAL_TABLE_PRECISION);
+
+  *exponent = RECIPROCAL_PRECISION + 64 - leading_zeros;
+  return refined;
+}
+
+// Divides a homogeneous coordinate in 16.16 format by W in 8.24 format, giving 16.16
+static int32_t prv_divide(int64_t numerator, int64_t w, uint32_t reciprocal, int32_t exponent) {
+  // Quotients of 4096 px or more are out of the GPointPrecise range
+  if (numerator >= (w << 4)) {
+    return POINT_MAX;
+  } else if (-numerator >= (w << 4)) {
+    return POINT_MIN;
+  }
+
+  // The quotient is numerator * 2^24 / w. As it is below 2^28, the product with the
+  // reciprocal fits 64 bits once numerator is shifted down by the bits that w has above 2^27;
+  // those bits are far below the 16 fraction bits of the result.
+  const bool negative = (numerator < 0);
+  uint64_t magnitude = negative ? (uint64_t)-numerator : (uint64_t)numerator;
+  int32_t shift = exponent - PERSPECTIVE_PRECISION;
+  const int32_t pre_shift = exponent - RECIPROCAL_PRECISION - 27;
+  if (pre_shift > 0) {
+    magnitude >>= pre_shift;
+    shift -= pre_shift;
+  }
+
+  // The result must not fall below the exact quotient, or exact ones such as whole pixels under
+  // an affine matrix would be rounded down to the step below. A negative quotient is the
+  // negated, rounded down product with the reciprocal, which is below 1/w; a positive one uses
+  // the reciprocal lifted by 2^-17, which puts it just above 1/w.
+  if (negative) {
+    return -(int32_t)((magnitude * reciprocal) >> shift);
+  }
+  reciprocal += reciprocal >> 17;
+  return (int32_t)((magnitude * reciprocal) >> shift);
+}
+
+// Projects homogeneous coordinates to a point in 16.16 format
+static bool prv_project(int64_t x, int64_t y, int64_t w, int32_t *point_x, int32_t *point_y) {
+  if (w <= 0) {
+    *point_x = (x >= 0) ? POINT_MAX : POINT_MIN;
+    *point_y = (y >= 0) ? POINT_MAX : POINT_MIN;
+    return false;
+  }
+
+  int32_t exponent;
+  const uint32_t reciprocal = prv_reciprocal((uint64_t)w, &exponent);
+  *point_x = prv_divide(x, w, reciprocal, exponent);
+  *point_y = prv_divide(y, w, reciprocal, exponent);
+  return true;
+}
+
+static bool prv_transform(GPointPrecise *pointP_new, GPointPrecise pointP,
+                          const GTransformProjective *t) {
+  const int64_t x = pointP.x.raw_value;
+  const int64_t y = pointP.y.raw_value;
+  const int64_t hx = ((x * t->a.raw_value + y * t->c.raw_value) >> GPOINT_PRECISE_PRECISION) +
+                     t->tx.raw_value;
+  const int64_t hy = ((x * t->b.raw_value + y * t->d.raw_value) >> GPOINT_PRECISE_PRECISION) +
+                     t->ty.raw_value;
+  const int64_t hw = ((x * t->p.raw_value + y * t->q.raw_value) >> GPOINT_PRECISE_PRECISION) +
+                     t->w.raw_value;
+
+  int32_t point_x;
+  int32_t point_y;
+  const bool in_front = prv_project(hx, hy, hw, &point_x, &point_y);
+  *pointP_new = GPointPrecise((int16_t)(point_x >> POINT_SHIFT),
+                              (int16_t)(point_y >> POINT_SHIFT));
+  return in_front;
+}
+
+//////////////////////////////////////
+/// Creating Transforms
+//////////////////////////////////////
+void gtransform_projective_init_identity(GTransformProjective *t_new) {
+  gtransform_projective_from_gtransform(t_new, NULL);
+}
+
+void gtransform_projective_from_gtransform(GTransformProjective *t_new, const GTransform *t) {
+  if (!t_new) {
+    return;
+  }
+
+  const GTransform identity = GTransformIdentity();
+  if (!t) {
+    t = &identity;
+  }
+
+  *t_new = (GTransformProjective) {
+    .a = t->a,
+    .b = t->b,
+    .p = Fixed_S32_24_from_int(0),
+    .c = t->c,
+    .d = t->d,
+    .q = Fixed_S32_24_from_int(0),
+    .tx = t->tx,
+    .ty = t->ty,
+    .w = Fixed_S32_24_from_int(1),
+  };
+}
+
+// The plane z = 0 is turned around the y-axis and then around the x-axis, which moves (x, y)
+// to (x * cos_y, y * cos_x - x * sin_y * sin_x) at depth z = x * sin_y * cos_x + y * sin_x.
+// Seen from distance D, a point at depth z is scaled by D / (D + z), i.e. W = 1 + z / D.
+bool gtransform_projective_init_tilt(GTransformProjective *t_new, int32_t angle_x,
+                                     int32_t angle_y, GTransformNumber distance) {
+  if ((!t_new) || (distance.raw_value <= 0)) {
+    return false;
+  }
+
+  const GTransform rotation_x = gtransform_init_rotation_cached(angle_x);
+  const GTransform rotation_y = gtransform_init_rotation_cached(angle_y);
+  const GTransformNumber cos_x = rotation_x.a;
+  const GTransformNumber sin_x = rotation_x.c;
+  const GTransformNumber cos_y = rotation_y.a;
+  const GTransformNumber sin_y = rotation_y.c;
+
+  // Change of depth per pixel along x and y, divided by D in 8.24 format
+  const int64_t depth_x = Fixed_S32_16_mul(sin_y, cos_x).raw_value;
+  const int64_t depth_y = sin_x.raw_value;
+  const int32_t p = (int32_t)((depth_x << PERSPECTIVE_PRECISION) / distance.raw_value);
+  const int32_t q = (int32_t)((depth_y << PERSPECTIVE_PRECISION) / distance.raw_value);
+  *t_new = (GTransformProjective) {
+    .a = cos_y,
+    .b = Fixed_S32_16(-Fixed_S32_16_mul(sin_y, sin_x).raw_value),
+    .p = prv_perspective_number(p),
+    .c = GTransformNumberZero,
+    .d = cos_x,
+    .q = prv_perspective_number(q),
+    .tx = GTransformNumberZero,
+    .ty = GTransformNumberZero,
+    .w = Fixed_S32_24_from_int(1),
+  };
+  return true;
+}
+
+//////////////////////////////////////
+/// Modifying Transforms
+//////////////////////////////////////
+// Entry of a concatenation from a row of t1 and a column of t2. The first two entries of a row
+// are in 16.16 format and the last in 8.24, so dropping their fraction bits from each product
+// leaves it in the format of the column. Each product is rounded down, like gtransform_concat.
+static int32_t prv_dot(int32_t row0, int32_t row1, int32_t row2,
+                       int32_t column0, int32_t column1, int32_t column2) {
+  return (int32_t)((((int64_t)row0 * column0) >> FIXED_S32_16_PRECISION) +
+                   (((int64_t)row1 * column1) >> FIXED_S32_16_PRECISION) +
+                   (((int64_t)row2 * column2) >> PERSPECTIVE_PRECISION));
+}
+
+void gtransform_projective_concat(GTransformProjective *t_new, const GTransformProjective *t1,
+                                  const GTransformProjective *t2) {
+  if ((!t_new) || (!t1) || (!t2)) {
+    return;
+  }
+
+#define ROW(r0, r1, r2) t1->r0.raw_value, t1->r1.raw_value, t1->r2.raw_value
+#define COLUMN(c0, c1, c2) t2->c0.raw_value, t2->c1.raw_value, t2->c2.raw_value
+  const GTransformProjective t = {
+    .a = Fixed_S32_16(prv_dot(ROW(a, b, p), COLUMN(a, c, tx))),
+    .b = Fixed_S32_16(prv_dot(ROW(a, b, p), COLUMN(b, d, ty))),
+    .p = prv_perspective_number(prv_dot(ROW(a, b, p), COLUMN(p, q, w))),
+    .c = Fixed_S32_16(prv_dot(ROW(c, d, q), COLUMN(a, c, tx))),
+    .d = Fixed_S32_16(prv_dot(ROW(c, d, q), COLUMN(b, d, ty))),
+    .q = prv_perspective_number(prv_dot(ROW(c, d, q), COLUMN(p, q, w))),
+    .tx = Fixed_S32_16(prv_dot(ROW(tx, ty, w), COLUMN(a, c, tx))),
+    .ty = Fixed_S32_16(prv_dot(ROW(tx, ty, w), COLUMN(b, d, ty))),
+    .w = prv_perspective_number(prv_dot(ROW(tx, ty, w), COLUMN(p, q, w))),
+  };
+#undef ROW
+#undef COLUMN
+  *t_new = t;
+}
+
+void gtransform_projective_compose(GTransformProjective *t_new, const GTransform *before,
+                                   const GTransformProjective *t, const GTransform *after) {
+  if ((!t_new) || (!t)) {
+    return;
+  }
+
+  GTransformProjective result = *t;
+  GTransformProjective affine;
+  if (before) {
+    gtransform_projective_from_gtransform(&affine, before);
+    gtransform_projective_concat(&result, &affine, &result);
+  }
+  if (after) {
+    gtransform_projective_from_gtransform(&affine, after);
+    gtransform_projective_concat(&result, &result, &affine);
+  }
+  *t_new = result;
+}
+
+//////////////////////////////////////
+/// Applying Transformations
+//////////////////////////////////////
+bool gpointprecise_transform_projective(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                        const GTransformProjective *t) {
+  if (!pointP_new) {
+    return false;
+  }
+
+  if (!t) {
+    *pointP_new = pointP;
+    return true;
+  }
+  return prv_transform(pointP_new, pointP, t);
+}
+
+bool gpoint_transform_projective(GPointPrecise *pointP_new, GPoint point,
+                                 const GTransformProjective *t) {
+  return gpointprecise_transform_projective(pointP_new, GPointPreciseFromGPoint(point), t);
+}
+
+size_t gpoint_transform_projective_array(const GPoint *in, GPointPrecise *out, size_t n,
+                                         const GTransformProjective *t) {
+  if ((!in) || (!out)) {
+    return 0;
+  }
+
+  size_t num_in_front = 0;
+  if (!t) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = GPointPreciseFromGPoint(in[i]);
+    }
+    return n;
+  }
+
+  // The matrix is copied once so the loop reads it from registers and the stack only
+  const GTransformProjective t_local = *t;
+  for (size_t i = 0; i < n; i++) {
+    num_in_front += prv_transform(&out[i], GPointPreciseFromGPoint(in[i]), &t_local);
+  }
+  return num_in_front;
+}
+
+//////////////////////////////////////
+/// Scanline Iteration
+//////////////////////////////////////
+void gtransform_projective_iter_begin(GTransformProjectiveIterator *iter,
+                                      const GTransformProjective *t, GPointPrecise pointP) {
+  if (!iter) {
+    return;
+  }
+
+  GTransformProjective identity;
+  if (!t) {
+    gtransform_projective_init_identity(&identity);
+    t = &identity;
+  }
+
+  const int64_t x = pointP.x.raw_value;
+  const int64_t y = pointP.y.raw_value;
+  *iter = (GTransformProjectiveIterator) {
+    .x = ((x * t->a.raw_value + y * t->c.raw_value) >> GPOINT_PRECISE_PRECISION) +
+         t->tx.raw_value,
+    .y = ((x * t->b.raw_value + y * t->d.raw_value) >> GPOINT_PRECISE_PRECISION) +
+         t->ty.raw_value,
+    .w = ((x * t->p.raw_value + y * t->q.raw_value) >> GPOINT_PRECISE_PRECISION) +
+         t->w.raw_value,
+    .span_dx = (int64_t)t->a.raw_value * GTRANSFORM_PROJECTIVE_SPAN,
+    .span_dy = (int64_t)t->b.raw_value * GTRANSFORM_PROJECTIVE_SPAN,
+    .span_dw = (int64_t)t->p.raw_value * GTRANSFORM_PROJECTIVE_SPAN,
+  };
+  prv_project(iter->x, iter->y, iter->w, &iter->end_x, &iter->end_y);
+  gtransform_projective_iter_next_span(iter);
+}
+
+// The end of the previous span is exact and becomes the start of the next one, so the error of
+// the linear steps never carries over from one span to the next
+void gtransform_projective_iter_next_span(GTransformProjectiveIterator *iter) {
+  iter->point_x = iter->end_x;
+  iter->point_y = iter->end_y;
+
+  iter->x += iter->span_dx;
+  iter->y += iter->span_dy;
+  iter->w += iter->span_dw;
+  prv_project(iter->x, iter->y, iter->w, &iter->end_x, &iter->end_y);
+
+  iter->step_x = (iter->end_x - iter->point_x) / GTRANSFORM_PROJECTIVE_SPAN;
+  iter->step_y = (iter->end_y - iter->point_y) / GTRANSFORM_PROJECTIVE_SPAN;
+  iter->remaining = GTRANSFORM_PROJECTIVE_SPAN;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformProjective Projective Transforms
+//! \brief 3x3 transformation matrices with a perspective divide, for pseudo-3D effects such as
+//! card flips, tilted dials and ground planes.
+//!
+//! A GTransform is the 3x3 matrix below with p = q = 0 and w = 1. Points are row vectors as
+//! with GTransform:
+//!   [ x' * W  y' * W  W ] = [ x  y  1 ] * [ a   b   p ]
+//!                                         [ c   d   q ]
+//!                                         [ tx  ty  w ]
+//! Multiplying every coefficient by the same factor gives the same transform.
+//!
+//! The perspective divide needs no hardware divide. A 256 entry reciprocal table that is
+//! built on first use gives 1/W to 9 bits, and one Newton-Raphson step refines it to about
+//! 18 bits. Quotients are rounded down to 1/8 px, or end up one step above when they lie just
+//! below a step, so whole pixels under an affine matrix stay exact. Points with W <= 0 are at
+//! or behind the eye and cannot be projected. They are moved to the edge of the GPointPrecise
+//! range, on the side of their numerator, so lines towards them still leave the screen in the
+//! right direction.
+//!     @{
+
+//! Number of pixels between the exact perspective divides of GTransformProjectiveIterator; a
+//! power of two so that the per-pixel step is found with a shift
+#define GTRANSFORM_PROJECTIVE_SPAN 16
+
+//! A projective transformation matrix. The affine coefficients have the format of GTransform;
+//! the perspective column has 24 fraction bits, as its coefficients are usually small: p and
+//! q are the change of W per pixel.
+typedef struct GTransformProjective {
+  GTransformNumber a;
+  GTransformNumber b;
+  Fixed_S32_24 p;
+  GTransformNumber c;
+  GTransformNumber d;
+  Fixed_S32_24 q;
+  GTransformNumber tx;
+  GTransformNumber ty;
+  Fixed_S32_24 w;
+} GTransformProjective;
+
+//! Walks the transformed points of consecutive pixels along a row. The perspective divide is
+//! done once every GTRANSFORM_PROJECTIVE_SPAN pixels, and the points in between are
+//! interpolated linearly with two adds per pixel. The interpolated points are off the exact
+//! ones by at most about a quarter of the distance a span moves on screen, times the relative
+//! change of W across the span. For a card turned by 60 degrees and seen from 200 px, that is
+//! less than three quarters of a pixel at the corners of the screen and less elsewhere.
+typedef struct GTransformProjectiveIterator {
+  //! @internal
+  //! Homogeneous coordinates of the end of the current span; x and y in 16.16, w in 8.24
+  int64_t x;
+  int64_t y;
+  int64_t w;
+  //! @internal
+  //! Change of the homogeneous coordinates over one span
+  int64_t span_dx;
+  int64_t span_dy;
+  int64_t span_dw;
+  //! @internal
+  //! Transformed point of the current pixel and its change per pixel, in 16.16 format
+  int32_t point_x;
+  int32_t point_y;
+  int32_t step_x;
+  int32_t step_y;
+  //! @internal
+  //! Transformed end of the current span, in 16.16 format
+  int32_t end_x;
+  int32_t end_y;
+  //! @internal
+  //! Pixels left until the end of the current span
+  uint8_t remaining;
+} GTransformProjectiveIterator;
+
+//! Initializes a projective transformation matrix that is the identity.
+//! @param t_new Pointer to destination matrix
+void gtransform_projective_init_identity(GTransformProjective *t_new);
+
+//! Initializes a projective transformation matrix from an affine one.
+//! @param t_new Pointer to destination matrix
+//! @param t Pointer to the affine matrix; if NULL the identity is used.
+void gtransform_projective_from_gtransform(GTransformProjective *t_new, const GTransform *t);
+
+//! Initializes a projective transformation matrix that tilts the plane around the origin and
+//! projects it back onto the screen as seen from a viewer at the given distance. The plane is
+//! turned around the y-axis first, then around the x-axis. Points on the axes of rotation keep
+//! their positions.
+//! @param t_new Pointer to destination matrix
+//! @param angle_x Angle of rotation around the x-axis, in TRIG_MAX_ANGLE units. Positive angles
+//! move the side with positive y away from the viewer.
+//! @param angle_y Angle of rotation around the y-axis, in TRIG_MAX_ANGLE units. Positive angles
+//! move the side with positive x away from the viewer.
+//! @param distance Distance of the viewer from the screen in pixels; must be positive. Smaller
+//! distances give stronger perspective.
+//! @return True if successful; False if distance is not positive or t_new is NULL.
+bool gtransform_projective_init_tilt(GTransformProjective *t_new, int32_t angle_x,
+                                     int32_t angle_y, GTransformNumber distance);
+
+//! Concatenates two projective matrices, as gtransform_concat does for affine ones.
+//! t1 is applied first, then t2.
+//! @param t_new Pointer to destination matrix; may be the same as t1 or t2.
+//! @param t1 Pointer to the matrix applied first
+//! @param t2 Pointer to the matrix applied second
+void gtransform_projective_concat(GTransformProjective *t_new, const GTransformProjective *t1,
+                                  const GTransformProjective *t2);
+
+//! Places a projective matrix between two affine ones, e.g. to tilt a card around its center
+//! and move it into place:
+//! `gtransform_projective_compose(&t, &to_center, &tilt, &to_screen)`.
+//! @param t_new Pointer to destination matrix; may be the same as t.
+//! @param before Pointer to the affine matrix applied first; NULL for the identity.
+//! @param t Pointer to the projective matrix applied in between
+//! @param after Pointer to the affine matrix applied last; NULL for the identity.
+void gtransform_projective_compose(GTransformProjective *t_new, const GTransform *before,
+                                   const GTransformProjective *t, const GTransform *after);
+
+//! Transforms a GPointPrecise with a projective matrix.
+//! @param pointP_new Pointer to the destination point
+//! @param pointP Point to transform
+//! @param t Pointer to the projective matrix; if NULL the point is copied.
+//! @return True if the point is in front of the eye (W > 0); False if it is not, in which case
+//! it is moved to the edge of the GPointPrecise range, or if pointP_new is NULL.
+bool gpointprecise_transform_projective(GPointPrecise *pointP_new, GPointPrecise pointP,
+                                        const GTransformProjective *t);
+
+//! Transforms a GPoint with a projective matrix.
+//! @param pointP_new Pointer to the destination point
+//! @param point Point to transform
+//! @param t Pointer to the projective matrix; if NULL the point is only converted.
+//! @return Same as gpointprecise_transform_projective.
+bool gpoint_transform_projective(GPointPrecise *pointP_new, GPoint point,
+                                 const GTransformProjective *t);
+
+//! Transforms an array of GPoints with a projective matrix. The results are identical to
+//! calling gpoint_transform_projective on each point.
+//! @param in Pointer to the array of GPoints to be transformed
+//! @param out Pointer to the destination array (must hold n elements)
+//! @param n Number of points to transform
+//! @param t Pointer to the projective matrix; if NULL the points are only converted.
+//! @return Number of points that are in front of the eye.
+size_t gpoint_transform_projective_array(const GPoint *in, GPointPrecise *out, size_t n,
+                                         const GTransformProjective *t);
+
+//! Starts walking a row of pixels at a point, e.g. the center of a pixel
+//! (x * 8 + 4, y * 8 + 4) for sampling a texture under the inverse of a perspective.
+//! @param iter Pointer to the iterator to initialize
+//! @param t Pointer to the projective matrix; if NULL the identity is used.
+//! @param pointP First point of the row
+void gtransform_projective_iter_begin(GTransformProjectiveIterator *iter,
+                                      const GTransformProjective *t, GPointPrecise pointP);
+
+//! @internal
+//! Starts the next span of an iterator; called by gtransform_projective_iter_next.
+void gtransform_projective_iter_next_span(GTransformProjectiveIterator *iter);
+
+//! Moves to the next pixel along the row.
+//! @param iter Pointer to the iterator
+static __inline__ void gtransform_projective_iter_next(GTransformProjectiveIterator *iter) {
+  if (--iter->remaining == 0) {
+    gtransform_projective_iter_next_span(iter);
+  } else {
+    iter->point_x += iter->step_x;
+    iter->point_y += iter->step_y;
+  }
+}
+
+//! Returns the transformed point of the current pixel, rounded down to 1/8 px.
+//! @param iter Pointer to the iterator
+static __inline__ GPointPrecise gtransform_projective_iter_get_point(
+    const GTransformProjectiveIterator *iter) {
+  const int32_t shift = FIXED_S32_16_PRECISION - GPOINT_PRECISE_PRECISION;
+  return GPointPrecise((int16_t)(iter->point_x >> shift), (int16_t)(iter->point_y >> shift));
+}
+
+//!     @} // end addtogroup GraphicsTransformProjective
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,261 @@
+#include <pebble.h>
+
+#include "gtransform_simd.h"
+
+#include <string.h>
+
+#if defined(GTRANSFORM_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(GTRANSFORM_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// GPointPreciseFromGPoint computes (v % GPOINT_PRECISE_MAX) << GPOINT_PRECISE_PRECISION and
+// stores it in 16 bits. Since GPOINT_PRECISE_MAX << GPOINT_PRECISE_PRECISION is 2^16, the modulo
+// only removes multiples of 2^16 and the stored value is simply v << GPOINT_PRECISE_PRECISION
+// truncated to 16 bits. The kernels below rely on this to convert whole vectors with one shift.
+
+#if defined(GTRANSFORM_SIMD_ARM_DSP)
+
+// A packed GPointPrecise holds x in the bottom half-word and y in the top half-word
+static __inline__ int32_t prv_smlawb(int32_t coefficient, uint32_t packed, int32_t acc) {
+  int32_t result;
+  __asm__ ("smlawb %0, %1, %2, %3" : "=r" (result) : "r" (coefficient), "r" (packed), "r" (acc));
+  return result;
+}
+
+static __inline__ int32_t prv_smlawt(int32_t coefficient, uint32_t packed, int32_t acc) {
+  int32_t result;
+  __asm__ ("smlawt %0, %1, %2, %3" : "=r" (result) : "r" (coefficient), "r" (packed), "r" (acc));
+  return result;
+}
+
+size_t gtransform_simd_transform_points(const GTransform *t, Fixed_S16_3 one_tx,
+                                        Fixed_S16_3 one_ty, const GPoint *in,
+                                        GPointPrecise *out, size_t n) {
+  const int32_t a = t->a.raw_value;
+  const int32_t b = t->b.raw_value;
+  const int32_t c = t->c.raw_value;
+  const int32_t d = t->d.raw_value;
+
+  for (size_t i = 0; i < n; i++) {
+    uint32_t packed;
+    memcpy(&packed, &in[i], sizeof(packed));
+    // Shift both half-words at once and drop the bits x shifted into y
+    packed = (packed << GPOINT_PRECISE_PRECISION) & 0xfff8fff8;
+
+    const int32_t x = prv_smlawb(a, packed, prv_smlawt(c, packed, one_tx.raw_value));
+    const int32_t y = prv_smlawb(b, packed, prv_smlawt(d, packed, one_ty.raw_value));
+    out[i] = GPointPrecise(x, y);
+  }
+
+  return n;
+}
+
+// Separate coordinate arrays gain nothing from the packed multiplies; the scalar code compiles
+// to the same SMULWB per coordinate.
+size_t gtransform_simd_transform_axes(const GTransform *t, Fixed_S16_3 one_tx,
+                                      Fixed_S16_3 one_ty, const int16_t *in_x,
+                                      const int16_t *in_y, int16_t *out_x, int16_t *out_y,
+                                      size_t n) {
+  return 0;
+}
+
+size_t gtransform_simd_scale_translate_axis(GTransformNumber scale, Fixed_S16_3 offset,
+                                            const int16_t *in, int16_t *out, size_t n) {
+  return 0;
+}
+
+#elif defined(GTRANSFORM_SIMD_SSE2)
+
+// Per-lane coefficient split so that Fixed_S16_3_S32_16_mul can be done with 16-bit multiplies.
+// With k = hi * 2^16 + lo (lo unsigned), floor(v * k / 2^16) = v * hi + floor(v * lo / 2^16).
+// _mm_mulhi_epi16 treats lo as signed, which is lo - 2^16 when its top bit is set, so v is added
+// back in those lanes. Everything is modulo 2^16, matching the 16-bit result of the scalar code.
+typedef struct CoefficientVector {
+  __m128i hi;
+  __m128i lo;
+  __m128i lo_sign;
+} CoefficientVector;
+
+static CoefficientVector prv_coefficient_vector(int32_t even, int32_t odd) {
+  const int16_t even_hi = (int16_t)(even >> 16);
+  const int16_t odd_hi = (int16_t)(odd >> 16);
+  const int16_t even_lo = (int16_t)(even & 0xffff);
+  const int16_t odd_lo = (int16_t)(odd & 0xffff);
+  return (CoefficientVector) {
+    .hi = _mm_set_epi16(odd_hi, even_hi, odd_hi, even_hi, odd_hi, even_hi, odd_hi, even_hi),
+    .lo = _mm_set_epi16(odd_lo, even_lo, odd_lo, even_lo, odd_lo, even_lo, odd_lo, even_lo),
+    .lo_sign = _mm_srai_epi16(
+        _mm_set_epi16(odd_lo, even_lo, odd_lo, even_lo, odd_lo, even_lo, odd_lo, even_lo), 15),
+  };
+}
+
+static __inline__ __m128i prv_mul(__m128i v, const CoefficientVector *k) {
+  return _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(v, k->hi), _mm_mulhi_epi16(v, k->lo)),
+                       _mm_and_si128(v, k->lo_sign));
+}
+
+size_t gtransform_simd_transform_points(const GTransform *t, Fixed_S16_3 one_tx,
+                                        Fixed_S16_3 one_ty, const GPoint *in,
+                                        GPointPrecise *out, size_t n) {
+  // Lanes hold x0 y0 x1 y1 ... so the straight vector is multiplied by (a, d) and the vector
+  // with x and y swapped by (c, b).
+  const CoefficientVector k_ad = prv_coefficient_vector(t->a.raw_value, t->d.raw_value);
+  const CoefficientVector k_cb = prv_coefficient_vector(t->c.raw_value, t->b.raw_value);
+  const __m128i translation = _mm_set_epi16(one_ty.raw_value, one_tx.raw_value,
+                                            one_ty.raw_value, one_tx.raw_value,
+                                            one_ty.raw_value, one_tx.raw_value,
+                                            one_ty.raw_value, one_tx.raw_value);
+
+  const size_t num_vectors = n / 4;
+  for (size_t i = 0; i < num_vectors; i++) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&in[i * 4]);
+    v = _mm_slli_epi16(v, GPOINT_PRECISE_PRECISION);
+    __m128i swapped = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    swapped = _mm_shufflehi_epi16(swapped, _MM_SHUFFLE(2, 3, 0, 1));
+
+    __m128i result = _mm_add_epi16(prv_mul(v, &k_ad), prv_mul(swapped, &k_cb));
+    result = _mm_add_epi16(result, translation);
+    _mm_storeu_si128((__m128i *)&out[i * 4], result);
+  }
+
+  return num_vectors * 4;
+}
+
+size_t gtransform_simd_transform_axes(const GTransform *t, Fixed_S16_3 one_tx,
+                                      Fixed_S16_3 one_ty, const int16_t *in_x,
+                                      const int16_t *in_y, int16_t *out_x, int16_t *out_y,
+                                      size_t n) {
+  const CoefficientVector k_a = prv_coefficient_vector(t->a.raw_value, t->a.raw_value);
+  const CoefficientVector k_b = prv_coefficient_vector(t->b.raw_value, t->b.raw_value);
+  const CoefficientVector k_c = prv_coefficient_vector(t->c.raw_value, t->c.raw_value);
+  const CoefficientVector k_d = prv_coefficient_vector(t->d.raw_value, t->d.raw_value);
+  const __m128i translation_x = _mm_set1_epi16(one_tx.raw_value);
+  const __m128i translation_y = _mm_set1_epi16(one_ty.raw_value);
+
+  const size_t num_vectors = n / 8;
+  for (size_t i = 0; i < num_vectors; i++) {
+    const __m128i x = _mm_loadu_si128((const __m128i *)&in_x[i * 8]);
+    const __m128i y = _mm_loadu_si128((const __m128i *)&in_y[i * 8]);
+    const __m128i result_x = _mm_add_epi16(_mm_add_epi16(prv_mul(x, &k_a), prv_mul(y, &k_c)),
+                                           translation_x);
+    const __m128i result_y = _mm_add_epi16(_mm_add_epi16(prv_mul(x, &k_b), prv_mul(y, &k_d)),
+                                           translation_y);
+    _mm_storeu_si128((__m128i *)&out_x[i * 8], result_x);
+    _mm_storeu_si128((__m128i *)&out_y[i * 8], result_y);
+  }
+
+  return num_vectors * 8;
+}
+
+size_t gtransform_simd_scale_translate_axis(GTransformNumber scale, Fixed_S16_3 offset,
+                                            const int16_t *in, int16_t *out, size_t n) {
+  const CoefficientVector k = prv_coefficient_vector(scale.raw_value, scale.raw_value);
+  const __m128i translation = _mm_set1_epi16(offset.raw_value);
+
+  const size_t num_vectors = n / 8;
+  for (size_t i = 0; i < num_vectors; i++) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)&in[i * 8]);
+    _mm_storeu_si128((__m128i *)&out[i * 8], _mm_add_epi16(prv_mul(v, &k), translation));
+  }
+
+  return num_vectors * 8;
+}
+
+#elif defined(GTRANSFORM_SIMD_NEON)
+
+// Coordinates are widened to 32 bits so that the product with a 16.16 coefficient is the same
+// 32-bit product as in Fixed_S16_3_S32_16_mul, then shifted and narrowed back to 16 bits.
+static __inline__ int16x4_t prv_mul(int16x4_t v, int32x4_t k) {
+  return vmovn_s32(vshrq_n_s32(vmulq_s32(vmovl_s16(v), k), FIXED_S32_16_PRECISION));
+}
+
+size_t gtransform_simd_transform_points(const GTransform *t, Fixed_S16_3 one_tx,
+                                        Fixed_S16_3 one_ty, const GPoint *in,
+                                        GPointPrecise *out, size_t n) {
+  const int32_t ad[4] = { t->a.raw_value, t->d.raw_value, t->a.raw_value, t->d.raw_value };
+  const int32_t cb[4] = { t->c.raw_value, t->b.raw_value, t->c.raw_value, t->b.raw_value };
+  const int16_t translation[8] = {
+    one_tx.raw_value, one_ty.raw_value, one_tx.raw_value, one_ty.raw_value,
+    one_tx.raw_value, one_ty.raw_value, one_tx.raw_value, one_ty.raw_value,
+  };
+  const int32x4_t k_ad = vld1q_s32(ad);
+  const int32x4_t k_cb = vld1q_s32(cb);
+  const int16x8_t t_xy = vld1q_s16(translation);
+
+  const size_t num_vectors = n / 4;
+  for (size_t i = 0; i < num_vectors; i++) {
+    int16x8_t v = vld1q_s16((const int16_t *)&in[i * 4]);
+    v = vshlq_n_s16(v, GPOINT_PRECISE_PRECISION);
+    const int16x8_t swapped = vrev32q_s16(v);
+
+    const int16x8_t straight = vcombine_s16(prv_mul(vget_low_s16(v), k_ad),
+                                            prv_mul(vget_high_s16(v), k_ad));
+    const int16x8_t crossed = vcombine_s16(prv_mul(vget_low_s16(swapped), k_cb),
+                                           prv_mul(vget_high_s16(swapped), k_cb));
+    const int16x8_t result = vaddq_s16(vaddq_s16(straight, crossed), t_xy);
+    vst1q_s16((int16_t *)&out[i * 4], result);
+  }
+
+  return num_vectors * 4;
+}
+
+size_t gtransform_simd_transform_axes(const GTransform *t, Fixed_S16_3 one_tx,
+                                      Fixed_S16_3 one_ty, const int16_t *in_x,
+                                      const int16_t *in_y, int16_t *out_x, int16_t *out_y,
+                                      size_t n) {
+  const int32x4_t k_a = vdupq_n_s32(t->a.raw_value);
+  const int32x4_t k_b = vdupq_n_s32(t->b.raw_value);
+  const int32x4_t k_c = vdupq_n_s32(t->c.raw_value);
+  const int32x4_t k_d = vdupq_n_s32(t->d.raw_value);
+  const int16x4_t translation_x = vdup_n_s16(one_tx.raw_value);
+  const int16x4_t translation_y = vdup_n_s16(one_ty.raw_value);
+
+  const size_t num_vectors = n / 4;
+  for (size_t i = 0; i < num_vectors; i++) {
+    const int16x4_t x = vld1_s16(&in_x[i * 4]);
+    const int16x4_t y = vld1_s16(&in_y[i * 4]);
+    vst1_s16(&out_x[i * 4],
+             vadd_s16(vadd_s16(prv_mul(x, k_a), prv_mul(y, k_c)), translation_x));
+    vst1_s16(&out_y[i * 4],
+             vadd_s16(vadd_s16(prv_mul(x, k_b), prv_mul(y, k_d)), translation_y));
+  }
+
+  return num_vectors * 4;
+}
+
+size_t gtransform_simd_scale_translate_axis(GTransformNumber scale, Fixed_S16_3 offset,
+                                            const int16_t *in, int16_t *out, size_t n) {
+  const int32x4_t k = vdupq_n_s32(scale.raw_value);
+  const int16x4_t translation = vdup_n_s16(offset.raw_value);
+
+  const size_t num_vectors = n / 4;
+  for (size_t i = 0; i < num_vectors; i++) {
+    vst1_s16(&out[i * 4], vadd_s16(prv_mul(vld1_s16(&in[i * 4]), k), translation));
+  }
+
+  return num_vectors * 4;
+}
+
+#else
+
+size_t gtransform_simd_transform_points(const GTransform *t, Fixed_S16_3 one_tx,
+                                        Fixed_S16_3 one_ty, const GPoint *in,
+                                        GPointPrecise *out, size_t n) {
+  return 0;
+}
+
+size_t gtransform_simd_transform_axes(const GTransform *t, Fixed_S16_3 one_tx,
+                                      Fixed_S16_3 one_ty, const int16_t *in_x,
+                                      const int16_t *in_y, int16_t *out_x, int16_t *out_y,
+                                      size_t n) {
+  return 0;
+}
+
+size_t gtransform_simd_scale_translate_axis(GTransformNumber scale, Fixed_S16_3 offset,
+                                            const int16_t *in, int16_t *out, size_t n) {
+  return 0;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtypes.h"
+
+//! @internal
+//! Vectorized kernels for the general (rotation/shear) point transform.
+//!
+//! The implementation is chosen at compile time from the target's instruction set:
+//!   - ARM DSP extension (Cortex-M4): SMULWB/SMLAWT multiply a 16.16 coefficient by one 16-bit
+//!     half of a packed GPointPrecise and keep the top 32 bits, which is exactly
+//!     Fixed_S16_3_S32_16_mul, so each coordinate takes two instructions.
+//!   - SSE2: 4 points (8 coordinates) per iteration using 16-bit lanes.
+//!   - NEON: 4 points per iteration using 32-bit lanes.
+//! Defining GTRANSFORM_NO_SIMD forces the portable scalar code. All implementations produce
+//! results that are bit-identical to gpoint_transform.
+
+#if defined(GTRANSFORM_NO_SIMD)
+#define GTRANSFORM_SIMD_NAME "scalar"
+#elif defined(__ARM_FEATURE_DSP) || defined(__ARM_ARCH_7EM__)
+#define GTRANSFORM_SIMD_ARM_DSP 1
+#define GTRANSFORM_SIMD_NAME "arm_dsp"
+#elif defined(__SSE2__)
+#define GTRANSFORM_SIMD_SSE2 1
+#define GTRANSFORM_SIMD_NAME "sse2"
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GTRANSFORM_SIMD_NEON 1
+#define GTRANSFORM_SIMD_NAME "neon"
+#else
+#define GTRANSFORM_SIMD_NAME "scalar"
+#endif
+
+//! @internal
+//! Transforms as many leading points of the array as the selected instruction set handles in
+//! whole vectors. The caller transforms the remaining points with the scalar code.
+//! @param t Pointer to the transformation matrix
+//! @param one_tx X translation already converted to Fixed_S16_3
+//! @param one_ty Y translation already converted to Fixed_S16_3
+//! @param in Pointer to the points to transform
+//! @param out Pointer to the destination array
+//! @param n Number of points available
+//! @return Number of points that were transformed, starting from the first one.
+size_t gtransform_simd_transform_points(const GTransform *t, Fixed_S16_3 one_tx,
+                                        Fixed_S16_3 one_ty, const GPoint *in,
+                                        GPointPrecise *out, size_t n);
+
+//! @internal
+//! Same as gtransform_simd_transform_points for precise points stored as separate x and y
+//! arrays. The output arrays may be the same as the input arrays.
+//! @return Number of points that were transformed, starting from the first one.
+size_t gtransform_simd_transform_axes(const GTransform *t, Fixed_S16_3 one_tx,
+                                      Fixed_S16_3 one_ty, const int16_t *in_x,
+                                      const int16_t *in_y, int16_t *out_x, int16_t *out_y,
+                                      size_t n);
+
+//! @internal
+//! Scales and offsets a single array of precise coordinates as Fixed_S16_3_S32_16_mul followed
+//! by Fixed_S16_3_add would. The output array may be the same as the input array.
+//! @return Number of coordinates that were processed, starting from the first one.
+size_t gtransform_simd_scale_translate_axis(GTransformNumber scale, Fixed_S16_3 offset,
+                                            const int16_t *in, int16_t *out, size_t n);
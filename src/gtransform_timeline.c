@@ -0,0 +1,152 @@
+#include <pebble.h>
+
+#include "gtransform_timeline.h"
+#include "gtransform_interpolate.h"
+
+//////////////////////////////////////
+/// Helpers
+//////////////////////////////////////
+// Polynomial curves with multiplies and shifts: w^2, 1 - (1 - w)^2 and 3w^2 - 2w^3 in units of
+// GTRANSFORM_WEIGHT_ONE
+static int32_t prv_ease(uint8_t easing, int32_t w) {
+  const int64_t one = GTRANSFORM_WEIGHT_ONE;
+  switch (easing) {
+    case GTransformEasingHold:
+      return 0;
+    case GTransformEasingEaseIn:
+      return (int32_t)(((int64_t)w * w) >> GTRANSFORM_WEIGHT_PRECISION);
+    case GTransformEasingEaseOut: {
+      const int64_t q = one - w;
+      return (int32_t)(one - ((q * q) >> GTRANSFORM_WEIGHT_PRECISION));
+    }
+    case GTransformEasingEaseInOut: {
+      const int64_t w2 = ((int64_t)w * w) >> GTRANSFORM_WEIGHT_PRECISION;
+      return (int32_t)((3 * w2) - ((2 * w2 * w) >> GTRANSFORM_WEIGHT_PRECISION));
+    }
+    case GTransformEasingLinear:
+    default:
+      return w;
+  }
+}
+
+// Only moving the cursor divides. The share of the segment per millisecond is
+// (2^32 - 1) / duration, so within the segment the elapsed time times that share stays below
+// 2^32, which drops to below GTRANSFORM_WEIGHT_ONE with this shift
+#define WEIGHT_PER_MS_SHIFT (32 - GTRANSFORM_WEIGHT_PRECISION)
+
+static void prv_set_cursor(GTransformTrack *track, uint16_t cursor) {
+  track->cursor = cursor;
+  track->weight_per_ms = 0;
+  if (cursor + 1 < track->num_keys) {
+    const uint32_t duration = track->keys[cursor + 1].time - track->keys[cursor].time;
+    if (duration > 0) {
+      track->weight_per_ms = UINT32_MAX / duration;
+    }
+  }
+}
+
+static bool prv_in_segment(const GTransformTrack *track, uint16_t index, uint32_t time) {
+  return (track->keys[index].time <= time) &&
+         ((index + 1 == track->num_keys) || (time < track->keys[index + 1].time));
+}
+
+// Returns the last key at or before time, which must not be before the first key
+static uint16_t prv_search(const GTransformTrack *track, uint32_t time) {
+  uint16_t low = 0;
+  uint16_t high = track->num_keys;
+  while (high - low > 1) {
+    const uint16_t mid = low + (high - low) / 2;
+    if (track->keys[mid].time <= time) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+// Playing forward stays in the segment of the last lookup or moves to the next one; anything
+// else is a seek
+static uint16_t prv_find_segment(GTransformTrack *track, uint32_t time) {
+  uint16_t cursor = track->cursor;
+  if (!prv_in_segment(track, cursor, time)) {
+    if ((cursor + 1 < track->num_keys) && prv_in_segment(track, cursor + 1, time)) {
+      cursor++;
+    } else {
+      cursor = prv_search(track, time);
+    }
+    prv_set_cursor(track, cursor);
+  }
+  return cursor;
+}
+
+static void prv_evaluate(GTransformTrack *track, uint32_t time, GTransform *t_out) {
+  const GTransformKeyframe *first = &track->keys[0];
+  const GTransformKeyframe *last = &track->keys[track->num_keys - 1];
+  if (track->loop && (last->time > 0)) {
+    time %= last->time;
+  }
+  if (time < first->time) {
+    time = first->time;
+  }
+
+  const uint16_t index = prv_find_segment(track, time);
+  const GTransformKeyframe *from = &track->keys[index];
+  if ((from == last) || (time == from->time)) {
+    *t_out = gtransform_init_trs(from->sx, from->sy, from->angle, from->tx, from->ty);
+    return;
+  }
+
+  const GTransformKeyframe *to = from + 1;
+  const int32_t linear = (int32_t)(((uint64_t)(time - from->time) * track->weight_per_ms) >>
+                                   WEIGHT_PER_MS_SHIFT);
+  const int32_t weight = prv_ease(from->easing, linear);
+  *t_out = gtransform_init_trs(gtransform_lerp_number(from->sx, to->sx, weight),
+                               gtransform_lerp_number(from->sy, to->sy, weight),
+                               gtransform_lerp_raw(from->angle, to->angle, weight),
+                               gtransform_lerp_number(from->tx, to->tx, weight),
+                               gtransform_lerp_number(from->ty, to->ty, weight));
+}
+
+//////////////////////////////////////
+/// Tracks
+//////////////////////////////////////
+bool gtransform_track_init(GTransformTrack *track, const GTransformKeyframe *keys,
+                           uint16_t num_keys, bool loop) {
+  if ((!track) || (!keys) || (num_keys == 0)) {
+    return false;
+  }
+
+  for (uint16_t i = 1; i < num_keys; i++) {
+    if (keys[i].time < keys[i - 1].time) {
+      return false;
+    }
+  }
+
+  *track = (GTransformTrack) {
+    .keys = keys,
+    .num_keys = num_keys,
+    .loop = loop,
+  };
+  prv_set_cursor(track, 0);
+  return true;
+}
+
+void gtransform_track_evaluate(GTransformTrack *track, uint32_t time, GTransform *t_out) {
+  if ((!track) || (!track->keys) || (track->num_keys == 0) || (!t_out)) {
+    return;
+  }
+
+  prv_evaluate(track, time, t_out);
+}
+
+void gtransform_track_evaluate_array(GTransformTrack *tracks, uint32_t time, GTransform *t_out,
+                                     size_t n) {
+  if ((!tracks) || (!t_out)) {
+    return;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    gtransform_track_evaluate(&tracks[i], time, &t_out[i]);
+  }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformTimeline Keyframe Timelines
+//! \brief Integer-only keyframe animation of scale, rotation and translation.
+//!
+//! A track plays a time-sorted array of keyframes, which can be const data built ahead of time.
+//! Each key holds the components of a matrix built as by GTransformTRS, and the easing of the
+//! segment that starts at it. The track keeps the segment of its last lookup as a cursor, so
+//! playing forward finds the segment in constant time; any other jump in time falls back to a
+//! binary search. Angles are not wrapped between keys, so a key at TRIG_MAX_ANGLE after a key at
+//! 0 turns a full circle.
+//!     @{
+
+//! Easing curves of the segment between two keys
+typedef enum GTransformEasing {
+  //! Stays at the first key until the next one is reached
+  GTransformEasingHold,
+  //! Constant speed
+  GTransformEasingLinear,
+  //! Starts slow and speeds up
+  GTransformEasingEaseIn,
+  //! Starts fast and slows down
+  GTransformEasingEaseOut,
+  //! Starts and ends slow
+  GTransformEasingEaseInOut,
+} GTransformEasing;
+
+//! A keyframe of a track
+typedef struct GTransformKeyframe {
+  //! Time of the key in milliseconds
+  uint32_t time;
+  //! X scaling factor
+  GTransformNumber sx;
+  //! Y scaling factor
+  GTransformNumber sy;
+  //! Rotation angle in TRIG_MAX_ANGLE units; may be negative or span several turns
+  int32_t angle;
+  //! X translation
+  GTransformNumber tx;
+  //! Y translation
+  GTransformNumber ty;
+  //! GTransformEasing of the segment from this key to the next
+  uint8_t easing;
+} GTransformKeyframe;
+
+//! A keyframe track and the cursor of its last lookup
+typedef struct GTransformTrack {
+  //! Keys sorted by time; keys with the same time make the track jump
+  const GTransformKeyframe *keys;
+  //! Number of keys
+  uint16_t num_keys;
+  //! Index of the key that starts the segment of the last lookup
+  uint16_t cursor;
+  //! Share of the segment of the cursor that passes per millisecond, in 1/2^32 units, so that
+  //! a lookup in it does not divide; 0 if the segment has no length
+  uint32_t weight_per_ms;
+  //! Set if the time wraps around at the time of the last key
+  bool loop;
+} GTransformTrack;
+
+//! Sets up a track to play an array of keys.
+//! @param track Pointer to the track to initialize
+//! @param keys Pointer to the keys, which must stay valid as long as the track is used
+//! @param num_keys Number of keys
+//! @param loop If true the track repeats, otherwise it holds the last key
+//! @return `true` if the track was set up, `false` if there are no keys, they are not sorted by
+//! time or an argument is NULL.
+bool gtransform_track_init(GTransformTrack *track, const GTransformKeyframe *keys,
+                           uint16_t num_keys, bool loop);
+
+//! Computes the matrix of a track at a given time and moves its cursor there. Before the first
+//! key the track holds the first key, and after the last it holds the last key unless it loops.
+//! @param track Pointer to the track
+//! @param time Time in milliseconds
+//! @param t_out Pointer to the destination matrix
+void gtransform_track_evaluate(GTransformTrack *track, uint32_t time, GTransform *t_out);
+
+//! Advances many tracks to the same time at once.
+//! @param tracks Pointer to the tracks
+//! @param time Time in milliseconds
+//! @param t_out Pointer to the destination matrices, one per track
+//! @param n Number of tracks
+void gtransform_track_evaluate_array(GTransformTrack *tracks, uint32_t time, GTransform *t_out,
+                                     size_t n);
+
+//!     @} // end addtogroup GraphicsTransformTimeline
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
@@ -0,0 +1,102 @@
+#include <pebble.h>
+
+#include "gtransform_tree.h"
+
+#include <string.h>
+
+static bool prv_is_valid_node(const GTransformTree *tree, int16_t node) {
+  return (tree && (node >= 0) && (node < tree->num_nodes));
+}
+
+void gtransform_tree_init(GTransformTree *tree, GTransformNode *nodes, uint16_t capacity) {
+  if (!tree) {
+    return;
+  }
+
+  *tree = (GTransformTree) {
+    .nodes = nodes,
+    .num_nodes = 0,
+    .capacity = nodes ? capacity : 0,
+    .update_count = 0,
+  };
+}
+
+int16_t gtransform_tree_add_node(GTransformTree *tree, int16_t parent, const GTransform *local) {
+  if ((!tree) || (tree->num_nodes >= tree->capacity) || (tree->num_nodes >= INT16_MAX)) {
+    return GTRANSFORM_TREE_NO_PARENT;
+  }
+
+  if ((parent != GTRANSFORM_TREE_NO_PARENT) && !prv_is_valid_node(tree, parent)) {
+    return GTRANSFORM_TREE_NO_PARENT;
+  }
+
+  const int16_t index = tree->num_nodes++;
+  GTransformNode *node = &tree->nodes[index];
+  node->local = local ? *local : GTransformIdentity();
+  node->world = GTransformIdentity();
+  node->parent = parent;
+  node->dirty = true;
+  node->world_update = tree->update_count;
+  return index;
+}
+
+void gtransform_tree_set_local(GTransformTree *tree, int16_t node, const GTransform *local) {
+  if ((!prv_is_valid_node(tree, node)) || (!local)) {
+    return;
+  }
+
+  GTransformNode *n = &tree->nodes[node];
+  if (!gtransform_is_equal(&n->local, local)) {
+    n->local = *local;
+    n->dirty = true;
+  }
+}
+
+GTransform *gtransform_tree_edit_local(GTransformTree *tree, int16_t node) {
+  if (!prv_is_valid_node(tree, node)) {
+    return NULL;
+  }
+
+  tree->nodes[node].dirty = true;
+  return &tree->nodes[node].local;
+}
+
+// Parents always come before their children, so by the time a node is visited its parent's
+// world matrix is final for this update. A parent that was recomputed during this update is
+// recognized by its world_update matching the tree's counter, which lets the dirty state flow
+// down the hierarchy without a second pass to clear flags. If the counter wraps around onto a
+// stale value the only consequence is a redundant (but still correct) recompute of the children.
+void gtransform_tree_update(GTransformTree *tree) {
+  if (!tree) {
+    return;
+  }
+
+  const uint8_t update = ++tree->update_count;
+
+  for (uint16_t i = 0; i < tree->num_nodes; i++) {
+    GTransformNode *node = &tree->nodes[i];
+    const GTransformNode *parent =
+        (node->parent != GTRANSFORM_TREE_NO_PARENT) ? &tree->nodes[node->parent] : NULL;
+
+    if (!node->dirty && !(parent && (parent->world_update == update))) {
+      continue;
+    }
+
+    if (parent) {
+      // world = local*parent_world
+      gtransform_concat(&node->world, &node->local, &parent->world);
+    } else {
+      node->world = node->local;
+    }
+    node->dirty = false;
+    node->world_update = update;
+  }
+}
+
+const GTransform *gtransform_tree_get_world(const GTransformTree *tree, int16_t node) {
+  if (!prv_is_valid_node(tree, node)) {
+    return NULL;
+  }
+
+  return &tree->nodes[node].world;
+}
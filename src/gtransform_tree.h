@@ -0,0 +1,93 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "gtransform.h"
+
+//! @addtogroup Graphics
+//! @{
+//!   @addtogroup GraphicsTransforms Transformation Matrices
+//!   @{
+//!     @addtogroup GraphicsTransformTree Transform Hierarchy
+//! \brief A hierarchy of transformation matrices where each node's world matrix is its local
+//! matrix concatenated with the world matrix of its parent.
+//!
+//! Nodes are stored in a flat array provided by the caller, always with parents before their
+//! children, so one linear pass updates the whole hierarchy. Only nodes that were modified, or
+//! whose ancestors were modified, are recomputed; everything else keeps its cached world matrix.
+//!     @{
+
+//! Parent index used for nodes at the top of the hierarchy
+#define GTRANSFORM_TREE_NO_PARENT (-1)
+
+//! A node in a transform hierarchy
+typedef struct GTransformNode {
+  //! Transformation relative to the parent node
+  GTransform local;
+  //! Cached transformation relative to the root (i.e. local*parent_world)
+  GTransform world;
+  //! Index of the parent node, which is always lower than the index of this node, or
+  //! GTRANSFORM_TREE_NO_PARENT
+  int16_t parent;
+  //! Set when the local matrix changed since the last update
+  bool dirty;
+  //! @internal
+  //! Value of the tree's update counter when the world matrix was last recomputed
+  uint8_t world_update;
+} GTransformNode;
+
+//! A transform hierarchy backed by a caller provided array of nodes
+typedef struct GTransformTree {
+  //! Storage for the nodes, in parent-before-child order
+  GTransformNode *nodes;
+  //! Number of nodes in use
+  uint16_t num_nodes;
+  //! Number of nodes the storage can hold
+  uint16_t capacity;
+  //! @internal
+  //! Incremented on every update to tell which world matrices were recomputed during it
+  uint8_t update_count;
+} GTransformTree;
+
+//! Initializes an empty transform hierarchy.
+//! @param tree Pointer to the tree to initialize
+//! @param nodes Pointer to the storage for the nodes
+//! @param capacity Number of nodes the storage can hold
+void gtransform_tree_init(GTransformTree *tree, GTransformNode *nodes, uint16_t capacity);
+
+//! Appends a node to the hierarchy. Since a parent must already exist when its child is added,
+//! the nodes always stay in parent-before-child order.
+//! @param tree Pointer to the tree
+//! @param parent Index of the parent node or GTRANSFORM_TREE_NO_PARENT
+//! @param local Pointer to the local transformation matrix; if NULL the identity is used.
+//! @return Index of the new node; GTRANSFORM_TREE_NO_PARENT if the tree is full, the parent
+//! does not exist or tree is NULL.
+int16_t gtransform_tree_add_node(GTransformTree *tree, int16_t parent, const GTransform *local);
+
+//! Sets the local transformation matrix of a node. The node is only marked dirty if the matrix
+//! actually changed, so it is cheap to set the same matrix on every frame.
+//! @param tree Pointer to the tree
+//! @param node Index of the node
+//! @param local Pointer to the new local transformation matrix
+void gtransform_tree_set_local(GTransformTree *tree, int16_t node, const GTransform *local);
+
+//! Returns the local transformation matrix of a node so that it can be modified in place.
+//! The node is marked dirty since the caller is expected to change it.
+//! @param tree Pointer to the tree
+//! @param node Index of the node
+//! @return Pointer to the local transformation matrix; NULL if the node does not exist.
+GTransform *gtransform_tree_edit_local(GTransformTree *tree, int16_t node);
+
+//! Recomputes the world matrices of every dirty node and of all their descendants.
+//! @param tree Pointer to the tree
+void gtransform_tree_update(GTransformTree *tree);
+
+//! Returns the world transformation matrix of a node as of the last gtransform_tree_update.
+//! @param tree Pointer to the tree
+//! @param node Index of the node
+//! @return Pointer to the world transformation matrix; NULL if the node does not exist.
+const GTransform *gtransform_tree_get_world(const GTransformTree *tree, int16_t node);
+
+//!     @} // end addtogroup GraphicsTransformTree
+//!   @} // end addtogroup GraphicsTransforms
+//! @} // end addtogroup Graphics
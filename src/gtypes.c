@@ -14,3 +14,15 @@ bool gvectorprecise_equal(const GVectorPrecise * const vectorP_a,
           (vectorP_a->dy.raw_value == vectorP_b->dy.raw_value));
 }
 
+GRect grect_intersection(GRect r1, GRect r2) {
+  const int32_t x0 = (r1.origin.x > r2.origin.x) ? r1.origin.x : r2.origin.x;
+  const int32_t y0 = (r1.origin.y > r2.origin.y) ? r1.origin.y : r2.origin.y;
+  const int32_t x1 = ((r1.origin.x + r1.size.w) < (r2.origin.x + r2.size.w)) ?
+                     (r1.origin.x + r1.size.w) : (r2.origin.x + r2.size.w);
+  const int32_t y1 = ((r1.origin.y + r1.size.h) < (r2.origin.y + r2.size.h)) ?
+                     (r1.origin.y + r1.size.h) : (r2.origin.y + r2.size.h);
+  if ((x1 <= x0) || (y1 <= y0)) {
+    return GRect(0, 0, 0, 0);
+  }
+  return GRect(x0, y0, x1 - x0, y1 - y0);
+}
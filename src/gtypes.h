@@ -29,6 +29,15 @@ typedef struct __attribute__ ((__packed__)) GPointPrecise {
         GPoint(pointP.x.raw_value >> GPOINT_PRECISE_PRECISION, \
                pointP.y.raw_value >> GPOINT_PRECISE_PRECISION)
 
+//! Convenience macro to convert from GPointPrecise to GPoint, rounding to the nearest pixel
+//! (halves up) instead of truncating. Slow movements then change pixels half way between them
+//! instead of always one step late.
+#define GPointFromGPointPreciseRounded(pointP) \
+        GPoint((pointP.x.raw_value + (1 << (GPOINT_PRECISE_PRECISION - 1))) >> \
+                   GPOINT_PRECISE_PRECISION, \
+               (pointP.y.raw_value + (1 << (GPOINT_PRECISE_PRECISION - 1))) >> \
+                   GPOINT_PRECISE_PRECISION)
+
 //! Tests whether 2 precise points are equal.
 //! @param pointP_a Pointer to the first precise point
 //! @param pointP_b Pointer to the second precise point
@@ -70,6 +79,13 @@ typedef struct GVectorPrecise {
         GVector(vectorP.dx.raw_value >> GVECTOR_PRECISE_PRECISION, \
                 vectorP.dy.raw_value >> GVECTOR_PRECISE_PRECISION)
 
+//! Convenience macro to convert from GVectorPrecise to GVector, rounding to the nearest pixel.
+#define GVectorFromGVectorPreciseRounded(vectorP) \
+        GVector((vectorP.dx.raw_value + (1 << (GVECTOR_PRECISE_PRECISION - 1))) >> \
+                    GVECTOR_PRECISE_PRECISION, \
+                (vectorP.dy.raw_value + (1 << (GVECTOR_PRECISE_PRECISION - 1))) >> \
+                    GVECTOR_PRECISE_PRECISION)
+
 //! Tests whether 2 precise vectors are equal.
 //! @param vectorP_a Pointer to the first precise vector
 //! @param vectorP_b Pointer to the second precise vector
@@ -77,6 +93,13 @@ typedef struct GVectorPrecise {
 bool gvectorprecise_equal(const GVectorPrecise * const vectorP_a,
                           const GVectorPrecise * const vectorP_b);
 
+//! Computes the overlap of 2 rectangles.
+//! @param r1 The first rectangle
+//! @param r2 The second rectangle
+//! @return The area covered by both rectangles, or an empty rectangle at (0, 0) if they do not
+//! overlap.
+GRect grect_intersection(GRect r1, GRect r2);
+
 //! @internal
 //! Internal representation of a transformation matrix coefficient
 typedef Fixed_S32_16 GTransformNumber;
@@ -24,11 +24,11 @@ typedef union __attribute__ ((__packed__)) Fixed_S16_3 {
   };
 } Fixed_S16_3;
 
-#define Fixed_S16_3(raw) ((Fixed_S16_3){ .raw_value = (raw) })
+#define Fixed_S16_3(raw) ((Fixed_S16_3){ .raw_value = (int16_t)(raw) })
 #define FIXED_S16_3_PRECISION 3
 
-#define FIXED_S16_3_ZERO ((Fixed_S16_3){ .integer = 0, .fraction = 0 })
-#define FIXED_S16_3_ONE ((Fixed_S16_3){ .integer = 1, .fraction = 0 })
+#define FIXED_S16_3_ZERO ((Fixed_S16_3){ .fraction = 0, .integer = 0 })
+#define FIXED_S16_3_ONE ((Fixed_S16_3){ .fraction = 0, .integer = 1 })
 
 static __inline__ Fixed_S16_3 Fixed_S16_3_add(Fixed_S16_3 a, Fixed_S16_3 b) {
   return Fixed_S16_3(a.raw_value + b.raw_value);
@@ -60,7 +60,7 @@ typedef union __attribute__ ((__packed__)) Fixed_S32_16 {
 #define Fixed_S32_16(raw) ((Fixed_S32_16){ .raw_value = (raw) })
 #define FIXED_S32_16_PRECISION 16
 
-#define FIXED_S32_16_ONE ((Fixed_S32_16){ .integer = 1, .fraction = 0 })
+#define FIXED_S32_16_ONE ((Fixed_S32_16){ .fraction = 0, .integer = 1 })
 
 static __inline__ Fixed_S32_16 Fixed_S32_16_mul(Fixed_S32_16 a, Fixed_S32_16 b) {
   Fixed_S32_16 x;
@@ -70,6 +70,13 @@ static __inline__ Fixed_S32_16 Fixed_S32_16_mul(Fixed_S32_16 a, Fixed_S32_16 b)
   return x;
 }
 
+// Same as Fixed_S32_16_mul but rounds to the nearest value (halves up) instead of down, so the
+// error of long chains of products averages out instead of accumulating in one direction
+static __inline__ Fixed_S32_16 Fixed_S32_16_mul_round(Fixed_S32_16 a, Fixed_S32_16 b) {
+  return Fixed_S32_16((int32_t)((((int64_t)a.raw_value * (int64_t)b.raw_value) +
+                                 (1 << (FIXED_S32_16_PRECISION - 1))) >> FIXED_S32_16_PRECISION));
+}
+
 static __inline__ Fixed_S32_16 Fixed_S32_16_add(Fixed_S32_16 a, Fixed_S32_16 b) {
   return Fixed_S32_16(a.raw_value + b.raw_value);
 }
@@ -85,3 +92,122 @@ static __inline__ Fixed_S32_16 Fixed_S32_16_add3(Fixed_S32_16 a, Fixed_S32_16 b,
 static __inline__ Fixed_S16_3 Fixed_S16_3_S32_16_mul(Fixed_S16_3 a, Fixed_S32_16 b) {
   return Fixed_S16_3( a.raw_value * b.raw_value >> FIXED_S32_16_PRECISION );
 }
+
+// Same as Fixed_S16_3_S32_16_mul but rounds to the nearest value (halves up)
+static __inline__ Fixed_S16_3 Fixed_S16_3_S32_16_mul_round(Fixed_S16_3 a, Fixed_S32_16 b) {
+  return Fixed_S16_3(((int64_t)a.raw_value * b.raw_value + (1 << (FIXED_S32_16_PRECISION - 1))) >>
+                     FIXED_S32_16_PRECISION);
+}
+
+////////////////////////////////////////////////////////////////
+/// Generic formats
+////////////////////////////////////////////////////////////////
+// The macros below generate a fixed point format from its raw storage type, a signed integer
+// type at least twice as wide used for intermediate results, and its number of fraction bits.
+// For a format named Name they define:
+//   Name_add, Name_sub, Name_mul        wrapping arithmetic, like the formats above
+//   Name_from_int, Name_to_int          conversions to and from integers (rounding down)
+//   Name_wrap, Name_clamp               raw wide value to Name, wrapping or saturating
+//   Name_add_sat, Name_sub_sat,
+//   Name_mul_sat                        saturating arithmetic
+//   Name_mul_wide                       product kept in the wide type, so it cannot overflow
+
+//! Defines the type of a fixed point format
+#define FIXED_DEFINE_TYPE(name, storage) \
+  typedef struct __attribute__ ((__packed__)) name { \
+    storage raw_value; \
+  } name;
+
+//! Defines the wrapping add, sub and mul of a fixed point format
+#define FIXED_DEFINE_BASIC_OPS(name, storage, wide, frac_bits) \
+  static __inline__ name name##_add(name a, name b) { \
+    return (name){ (storage)((wide)a.raw_value + b.raw_value) }; \
+  } \
+  static __inline__ name name##_sub(name a, name b) { \
+    return (name){ (storage)((wide)a.raw_value - b.raw_value) }; \
+  } \
+  static __inline__ name name##_mul(name a, name b) { \
+    return (name){ (storage)(((wide)a.raw_value * b.raw_value) >> (frac_bits)) }; \
+  }
+
+//! Defines the conversions, saturating and widening operations of a fixed point format
+#define FIXED_DEFINE_EXTENDED_OPS(name, storage, wide, frac_bits) \
+  static __inline__ name name##_wrap(wide raw) { \
+    return (name){ (storage)raw }; \
+  } \
+  static __inline__ name name##_clamp(wide raw) { \
+    const wide max = (wide)(((uint64_t)1 << (sizeof(storage) * 8 - 1)) - 1); \
+    return (name){ (storage)((raw > max) ? max : ((raw < -max - 1) ? (-max - 1) : raw)) }; \
+  } \
+  static __inline__ name name##_from_int(int32_t value) { \
+    return name##_wrap((wide)value * ((wide)1 << (frac_bits))); \
+  } \
+  static __inline__ int32_t name##_to_int(name a) { \
+    return (int32_t)(a.raw_value >> (frac_bits)); \
+  } \
+  static __inline__ name name##_add_sat(name a, name b) { \
+    return name##_clamp((wide)a.raw_value + b.raw_value); \
+  } \
+  static __inline__ name name##_sub_sat(name a, name b) { \
+    return name##_clamp((wide)a.raw_value - b.raw_value); \
+  } \
+  static __inline__ wide name##_mul_wide(name a, name b) { \
+    return ((wide)a.raw_value * b.raw_value) >> (frac_bits); \
+  } \
+  static __inline__ name name##_mul_sat(name a, name b) { \
+    return name##_clamp(name##_mul_wide(a, b)); \
+  }
+
+//! Defines a complete fixed point format
+#define FIXED_DEFINE_FORMAT(name, storage, wide, frac_bits) \
+  FIXED_DEFINE_TYPE(name, storage) \
+  FIXED_DEFINE_BASIC_OPS(name, storage, wide, frac_bits) \
+  FIXED_DEFINE_EXTENDED_OPS(name, storage, wide, frac_bits)
+
+//! Converts a raw value between two numbers of fraction bits, rounding down
+static __inline__ int64_t fixed_rescale(int64_t raw, int from_bits, int to_bits) {
+  return (from_bits >= to_bits) ? (raw >> (from_bits - to_bits)) :
+                                  (raw * ((int64_t)1 << (to_bits - from_bits)));
+}
+
+//! Square root of a 64-bit value, rounded down
+static __inline__ uint32_t fixed_isqrt(uint64_t value) {
+  uint64_t result = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+
+  while (bit) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)result;
+}
+
+// The formats above get the operations they were missing
+FIXED_DEFINE_EXTENDED_OPS(Fixed_S16_3, int16_t, int32_t, FIXED_S16_3_PRECISION)
+FIXED_DEFINE_EXTENDED_OPS(Fixed_S32_16, int32_t, int64_t, FIXED_S32_16_PRECISION)
+
+////////////////////////////////////////////////////////////////
+/// Fixed_S16_8 = 1 bit sign, 7 bits integer, 8 bits fraction (Q8.8)
+////////////////////////////////////////////////////////////////
+#define FIXED_S16_8_PRECISION 8
+FIXED_DEFINE_FORMAT(Fixed_S16_8, int16_t, int32_t, FIXED_S16_8_PRECISION)
+
+////////////////////////////////////////////////////////////////
+/// Fixed_S32_8 = 1 bit sign, 23 bits integer, 8 bits fraction (Q24.8)
+////////////////////////////////////////////////////////////////
+#define FIXED_S32_8_PRECISION 8
+FIXED_DEFINE_FORMAT(Fixed_S32_8, int32_t, int64_t, FIXED_S32_8_PRECISION)
+
+////////////////////////////////////////////////////////////////
+/// Fixed_S32_24 = 1 bit sign, 7 bits integer, 24 bits fraction (Q8.24)
+////////////////////////////////////////////////////////////////
+#define FIXED_S32_24_PRECISION 24
+FIXED_DEFINE_FORMAT(Fixed_S32_24, int32_t, int64_t, FIXED_S32_24_PRECISION)
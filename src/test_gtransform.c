@@ -1,6 +1,9 @@
 #include <pebble.h>
 
+#include "gdamage_tracker.h"
 #include "gtransform.h"
+#include "gtransform_context.h"
+#include "gtransform_tree.h"
 
 #define DEG_TO_TRIG_ANGLE(angle) (((angle % 360) * TRIG_MAX_ANGLE) / 360)
 
@@ -8,9 +11,11 @@ static Window *window;
 static Layer *s_canvas;
 static AppTimer *s_render_timer;
 
-#define MAX_SCALE 1.5
-#define MIN_SCALE 0.5
-static float s_scale_factor;
+// Scale factors are kept in fixed point so that no float math runs on watches without an FPU
+#define MAX_SCALE GTransformNumberFromNumber(1.5)
+#define MIN_SCALE GTransformNumberFromNumber(0.5)
+#define SCALE_STEP GTransformNumberFromNumber(0.05)
+static GTransformNumber s_scale_factor;
 static bool s_scale_up;
 static uint8_t s_scale_pause_count;
 
@@ -20,14 +25,11 @@ static uint8_t s_seconds_count;
 static GPoint s_center;
 
 static int16_t s_sun_distance;
-static int16_t s_sun_radius;
 
 static int32_t s_earth_angle;
-static int32_t s_earth_radius;
 static int16_t s_earth_distance;  // distance from sun to earth
 
 static int32_t s_moon_angle;
-static int32_t s_moon_radius;
 static int16_t s_moon_distance;   // distance from earth to moon
 
 #define FRAME_RATE 20
@@ -43,6 +45,40 @@ static int16_t s_moon_distance;   // distance from earth to moon
 #define MOON_RADIUS 4
 #define MOON_DIST_OFFSET (EARTH_RADIUS + MOON_RADIUS + 10)
 
+// Scene hierarchy: the earth orbits the sun and the moon orbits the earth. The orbit nodes only
+// rotate and the body nodes only offset from their parent's center.
+enum {
+  SceneNodeSun,
+  SceneNodeEarthOrbit,
+  SceneNodeEarth,
+  SceneNodeMoonOrbit,
+  SceneNodeMoon,
+  SceneNodeCount,
+};
+
+static GTransformNode s_scene_nodes[SceneNodeCount];
+static GTransformTree s_scene;
+
+// Everything drawn besides the stars, each with its bounds kept by the damage tracker so that
+// only the parts of the screen that changed are cleared and redrawn
+enum {
+  DamageObjectSun,
+  DamageObjectEarth,
+  DamageObjectMoon,
+  DamageObjectEarthOrbit,
+  DamageObjectMoonOrbit,
+  DamageObjectEarthLine,
+  DamageObjectMoonLine,
+  DamageObjectCount,
+};
+
+static GDamageObject s_damage_objects[DamageObjectCount];
+static GDamageTracker s_damage;
+
+// Scale and star pattern of the frame on screen; changing either redraws everything
+static GTransformNumber s_drawn_scale_factor;
+static uint8_t s_drawn_seconds_index;
+
 #define NUM_STARS 60
 static const GPoint stars[NUM_STARS] = {
   {  2,   2},
@@ -108,90 +144,173 @@ static const GPoint stars[NUM_STARS] = {
 };
 
 static void draw_star_background(GContext *ctx) {
-  GTransform ts = GTransformScaleFromNumber(s_scale_factor + MIN_SCALE, s_scale_factor + MIN_SCALE);
+  GTransformNumber star_scale = Fixed_S32_16_add(s_scale_factor, MIN_SCALE);
+  GTransform ts = GTransformScale(star_scale, star_scale);
+  GPointPrecise stars_transformed[NUM_STARS];
+  gpoint_transform_array(stars, stars_transformed, NUM_STARS, &ts);
 
   graphics_context_set_stroke_color(ctx, GColorWhite);
   for (int index = 0; index < NUM_STARS; index++) {
-    if (index % 3 != (s_seconds_index % 3)) {
-      graphics_draw_pixel(ctx, GPointFromGPointPrecise(gpoint_transform(stars[index], &ts)));
+    const GPoint star = GPointFromGPointPrecise(stars_transformed[index]);
+    if ((index % 3 != (s_seconds_index % 3)) &&
+        gdamage_tracker_intersects(&s_damage, GRect(star.x, star.y, 1, 1))) {
+      graphics_draw_pixel(ctx, star);
     }
   }
 }
 
-static void frame_handler(GContext *ctx) {
-  graphics_context_set_fill_color(ctx, GColorBlack);
-  graphics_fill_rect(ctx, layer_get_bounds(window_get_root_layer(window)), 0, GCornerNone);
+// Pixels of a circle around the origin, with one to spare for the rounding of a scaled radius
+static GRect prv_circle_bounds(int16_t radius) {
+  return GRect(-radius - 1, -radius - 1, 2 * radius + 3, 2 * radius + 3);
+}
+
+// Pixels of a line from the origin straight up
+static GRect prv_line_bounds(int16_t length) {
+  return GRect(-1, -length - 1, 3, length + 3);
+}
 
+// Updates the damage tracker with the bounds of every object, as drawn by frame_handler
+static void prv_track_damage(void) {
+  const GTransform *sun = gtransform_tree_get_world(&s_scene, SceneNodeSun);
+  const GTransform *earth = gtransform_tree_get_world(&s_scene, SceneNodeEarth);
+  const GTransform *moon = gtransform_tree_get_world(&s_scene, SceneNodeMoon);
+
+  GTransform t = *sun;
+  gtransform_scale(&t, &t, s_scale_factor, s_scale_factor);
+  GRect bounds = prv_circle_bounds(SUN_RADIUS);
+  bounds.origin.y += s_sun_distance;
+  gdamage_tracker_update(&s_damage, DamageObjectSun, bounds, &t);
+
+  t = *earth;
+  gtransform_scale(&t, &t, s_scale_factor, s_scale_factor);
+  gdamage_tracker_update(&s_damage, DamageObjectEarth, prv_circle_bounds(EARTH_RADIUS), &t);
+
+  t = *moon;
+  gtransform_scale(&t, &t, s_scale_factor, s_scale_factor);
+  gdamage_tracker_update(&s_damage, DamageObjectMoon, prv_circle_bounds(MOON_RADIUS), &t);
+
+  gdamage_tracker_update(&s_damage, DamageObjectEarthOrbit, prv_circle_bounds(s_earth_distance),
+                         sun);
+  gdamage_tracker_update(&s_damage, DamageObjectMoonOrbit, prv_circle_bounds(s_moon_distance),
+                         earth);
+  gdamage_tracker_update(&s_damage, DamageObjectEarthLine, prv_line_bounds(s_earth_distance),
+                         gtransform_tree_get_world(&s_scene, SceneNodeEarthOrbit));
+  gdamage_tracker_update(&s_damage, DamageObjectMoonLine, prv_line_bounds(s_moon_distance),
+                         gtransform_tree_get_world(&s_scene, SceneNodeMoonOrbit));
+}
+
+static void frame_handler(GContext *ctx) {
   if (s_scale_pause_count < FRAME_RATE * 2) {
     s_scale_pause_count++;
   }
   else {
     s_scale_pause_count = FRAME_RATE * 2;
-    s_scale_factor += s_scale_up ? 0.05 : -0.05;
+    s_scale_factor.raw_value += s_scale_up ? SCALE_STEP.raw_value : -SCALE_STEP.raw_value;
 
     // Pause for two seconds after each switch of scale sign
-    if (s_scale_factor >= MAX_SCALE) {
+    if (s_scale_factor.raw_value >= MAX_SCALE.raw_value) {
       s_scale_up = false;
       s_scale_pause_count = 0;
-    } else if (s_scale_factor <= MIN_SCALE) {
+    } else if (s_scale_factor.raw_value <= MIN_SCALE.raw_value) {
       s_scale_up = true;
       s_scale_pause_count = 0;
     }
   }
 
-  draw_star_background(ctx);
-
-  // Transform sun size and position
-  GTransform ts = GTransformScaleFromNumber(s_scale_factor, s_scale_factor);
-  GTransform tt = GTransformTranslationFromNumber(s_center.x, s_center.y);
-  GVector sun_vector = GVector(0, SUN_RADIUS);
-  sun_vector = GVectorFromGVectorPrecise(gvector_transform(sun_vector, &ts));
-  s_sun_radius = sun_vector.dy;
-  GPoint sun_point = GPoint(0, s_sun_distance);
-  sun_point = GPointFromGPointPrecise(gpoint_transform(sun_point, &tt));
-  graphics_context_set_fill_color(ctx, GColorWhite);
-  graphics_fill_circle(ctx, sun_point, s_sun_radius);
-
-  // Transform earth size and position
-  GVector earth_vector = GVector(0, EARTH_RADIUS);
-  earth_vector = GVectorFromGVectorPrecise(gvector_transform(earth_vector, &ts));
-  s_earth_radius = earth_vector.dy;
-  earth_vector = GVector(0, EARTH_DIST_OFFSET);
+  // Scale the orbit distances
+  GTransform ts = GTransformScale(s_scale_factor, s_scale_factor);
+  GVector earth_vector = GVector(0, EARTH_DIST_OFFSET);
   earth_vector = GVectorFromGVectorPrecise(gvector_transform(earth_vector, &ts));
   s_earth_distance = earth_vector.dy;
+  GVector moon_vector = GVector(0, MOON_DIST_OFFSET);
+  moon_vector = GVectorFromGVectorPrecise(gvector_transform(moon_vector, &ts));
+  s_moon_distance = moon_vector.dy;
 
   // Rotate earth position
-  GPoint earth_point = GPoint(0, -s_earth_distance);
   s_earth_angle = (s_earth_angle + EARTH_ANGLE_OFFSET) % TRIG_MAX_ANGLE;
-  GTransform tr = GTransformRotation(s_earth_angle);
-  GTransform t_concat;
-  gtransform_concat(&t_concat, &tr, &tt);
-  earth_point = GPointFromGPointPrecise(gpoint_transform(earth_point, &t_concat));
-  graphics_fill_circle(ctx, earth_point, s_earth_radius);
-
-  // Transform moon size and position
-  GVector moon_vector = GVector(0, MOON_RADIUS);
-  moon_vector = GVectorFromGVectorPrecise(gvector_transform(moon_vector, &ts));
-  s_moon_radius = moon_vector.dy;
-  moon_vector = GVector(0, MOON_DIST_OFFSET);
-  moon_vector = GVectorFromGVectorPrecise(gvector_transform(moon_vector, &ts));
-  s_moon_distance = moon_vector.dy;
+  GTransform t = GTransformRotationCached(s_earth_angle);
+  gtransform_tree_set_local(&s_scene, SceneNodeEarthOrbit, &t);
+  t = GTransformTranslationFromNumber(0, -s_earth_distance);
+  gtransform_tree_set_local(&s_scene, SceneNodeEarth, &t);
 
-  // Rotate moon position - translate by the center of the earth
-  GPoint moon_point = GPoint(0, -s_moon_distance);
+  // Rotate moon position around the center of the earth. The moon orbit inherits the earth's
+  // rotation, so only the difference between the two angles is applied here.
   s_moon_angle = (s_moon_angle + MOON_ANGLE_OFFSET) % TRIG_MAX_ANGLE;
-  tr = GTransformRotation(s_moon_angle);
-  tt = GTransformTranslationFromNumber(earth_point.x, earth_point.y);
-  gtransform_concat(&t_concat, &tr, &tt);
-  moon_point = GPointFromGPointPrecise(gpoint_transform(moon_point, &t_concat));
-  graphics_fill_circle(ctx, moon_point, s_moon_radius);
-
-  // Draw lines and circles between each of the center points for visual reference
-  graphics_draw_circle(ctx, earth_point, s_moon_distance);
-  graphics_draw_circle(ctx, sun_point, s_earth_distance);
+  t = GTransformRotationCached(s_moon_angle - s_earth_angle);
+  gtransform_tree_set_local(&s_scene, SceneNodeMoonOrbit, &t);
+  t = GTransformTranslationFromNumber(0, -s_moon_distance);
+  gtransform_tree_set_local(&s_scene, SceneNodeMoon, &t);
+
+  // Only the nodes that changed since the last frame (and their children) are recomputed
+  gtransform_tree_update(&s_scene);
+
+  // Clear only where something moved since the last frame, which relies on the frame buffer
+  // keeping the last frame (see window_appear). Everything is white on black, so redrawing a
+  // whole object that reaches into a cleared part cannot spoil what it overlaps.
+  gdamage_tracker_begin_frame(&s_damage);
+  if ((s_scale_factor.raw_value != s_drawn_scale_factor.raw_value) ||
+      (s_seconds_index != s_drawn_seconds_index)) {
+    gdamage_tracker_invalidate(&s_damage);
+    s_drawn_scale_factor = s_scale_factor;
+    s_drawn_seconds_index = s_seconds_index;
+  }
+  prv_track_damage();
+
+  const GRect *damaged_rects;
+  const uint8_t num_damaged_rects = gdamage_tracker_get_rects(&s_damage, &damaged_rects);
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  for (uint8_t i = 0; i < num_damaged_rects; i++) {
+    graphics_fill_rect(ctx, damaged_rects[i], 0, GCornerNone);
+  }
+
+  draw_star_background(ctx);
+
+  // Each body is drawn at the origin of its node, scaled by the current scale factor
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, ctx);
+  graphics_context_set_fill_color(ctx, GColorWhite);
+
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectSun)) {
+    gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeSun));
+    gtransform_context_scale(&tctx, s_scale_factor, s_scale_factor);
+    gtransform_context_fill_circle(&tctx, GPoint(0, s_sun_distance), SUN_RADIUS);
+  }
+
+  gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeEarth));
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectEarth)) {
+    gtransform_context_push(&tctx);
+    gtransform_context_scale(&tctx, s_scale_factor, s_scale_factor);
+    gtransform_context_fill_circle(&tctx, GPoint(0, 0), EARTH_RADIUS);
+    gtransform_context_pop(&tctx);
+  }
+
+  // The earth's matrix is still current, so the orbit of the moon is centered on the earth
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectMoonOrbit)) {
+    gtransform_context_draw_circle(&tctx, GPoint(0, 0), s_moon_distance);
+  }
+
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectMoon)) {
+    gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeMoon));
+    gtransform_context_scale(&tctx, s_scale_factor, s_scale_factor);
+    gtransform_context_fill_circle(&tctx, GPoint(0, 0), MOON_RADIUS);
+  }
+
+  // Orbit of the earth, for visual reference
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectEarthOrbit)) {
+    gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeSun));
+    gtransform_context_draw_circle(&tctx, GPoint(0, 0), s_earth_distance);
+  }
+
+  // Lines between each of the center points, drawn along the rotated orbit axes
   graphics_context_set_stroke_color(ctx, GColorWhite);
-  graphics_draw_line(ctx, sun_point, earth_point);
-  graphics_draw_line(ctx, earth_point, moon_point);
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectEarthLine)) {
+    gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeEarthOrbit));
+    gtransform_context_draw_line(&tctx, GPoint(0, 0), GPoint(0, -s_earth_distance));
+  }
+  if (gdamage_tracker_object_is_damaged(&s_damage, DamageObjectMoonLine)) {
+    gtransform_context_set(&tctx, gtransform_tree_get_world(&s_scene, SceneNodeMoonOrbit));
+    gtransform_context_draw_line(&tctx, GPoint(0, 0), GPoint(0, -s_moon_distance));
+  }
 }
 
 static void frame_timer_handler(void *context) {
@@ -224,24 +343,31 @@ static void window_load(Window *window) {
   tick_timer_service_subscribe(SECOND_UNIT, time_handler);
 }
 
+// Partial redraw assumes the frame buffer still holds the last frame. It does not after another
+// window or a notification covered this one, so the next frame redraws the whole screen.
+static void window_appear(Window *window) {
+  gdamage_tracker_invalidate(&s_damage);
+}
+
 static void window_unload(Window *window) {
   layer_destroy(s_canvas);
 }
 
 static void init(void) {
   window = window_create();
+  // The frame buffer keeps the last frame, which only gets cleared where it is damaged
+  window_set_background_color(window, GColorClear);
   window_set_window_handlers(window, (WindowHandlers) {
     .load = window_load,
+    .appear = window_appear,
     .unload = window_unload,
   });
-  const bool animated = true;
-  window_stack_push(window, animated);
 
   Layer *window_layer = window_get_root_layer(window);
   GRect frame = layer_get_frame(window_layer);
   s_center = grect_center_point(&frame);
 
-  s_scale_factor = 1;
+  s_scale_factor = GTransformNumberOne;
   s_scale_up = true;
   s_scale_pause_count = 0;
 
@@ -249,15 +375,28 @@ static void init(void) {
   s_seconds_count = 0;
 
   s_sun_distance = SUN_DIST_OFFSET;
-  s_sun_radius = SUN_RADIUS;
 
   s_earth_angle = 0;
   s_earth_distance = EARTH_DIST_OFFSET;
-  s_earth_radius = EARTH_RADIUS;
 
   s_moon_angle = 0;
   s_moon_distance = MOON_DIST_OFFSET;
-  s_moon_radius = MOON_RADIUS;
+
+  GTransform tt = GTransformTranslationFromNumber(s_center.x, s_center.y);
+  gtransform_tree_init(&s_scene, s_scene_nodes, SceneNodeCount);
+  gtransform_tree_add_node(&s_scene, GTRANSFORM_TREE_NO_PARENT, &tt);
+  gtransform_tree_add_node(&s_scene, SceneNodeSun, NULL);
+  gtransform_tree_add_node(&s_scene, SceneNodeEarthOrbit, NULL);
+  gtransform_tree_add_node(&s_scene, SceneNodeEarth, NULL);
+  gtransform_tree_add_node(&s_scene, SceneNodeMoonOrbit, NULL);
+
+  gdamage_tracker_init(&s_damage, s_damage_objects, DamageObjectCount, frame);
+  s_drawn_scale_factor = s_scale_factor;
+  s_drawn_seconds_index = s_seconds_index;
+
+  // Pushed last, so that the damage tracker is set up by the time the window appears
+  const bool animated = true;
+  window_stack_push(window, animated);
 }
 
 static void deinit(void) {
@@ -0,0 +1,877 @@
+// Microbenchmarks for the public transform functions.
+//
+// Every function is run over a set of input distributions and reported in ns/op, ops/sec and,
+// where the host exposes a cycle counter, cycles/op. Pass --json to get machine readable output
+// that can be compared between releases.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <pebble.h>
+
+#include "gbitmap_transform.h"
+#include "gparticle_system.h"
+#include "gpoint_buffer.h"
+#include "gtransform.h"
+#include "gtransform_interpolate.h"
+#include "gtransform_projective.h"
+#include "gtransform_timeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+static uint64_t prv_cycles(void) {
+  return __rdtsc();
+}
+#else
+#define BENCH_HAS_CYCLES 0
+static uint64_t prv_cycles(void) {
+  return 0;
+}
+#endif
+
+// Number of distinct inputs per distribution; small enough to stay in L1 so that the numbers
+// reflect the arithmetic rather than memory bandwidth.
+#define BENCH_NUM_INPUTS 256
+// Number of passes over the inputs per measurement
+#define BENCH_NUM_PASSES 1000
+// Each case is measured this many times and the fastest run is reported
+#define BENCH_NUM_REPEATS 5
+
+typedef enum BenchDistribution {
+  BenchDistributionIdentity,
+  BenchDistributionTranslation,
+  BenchDistributionRotation,
+  BenchDistributionLargeCoordinates,
+  BenchDistributionCount,
+} BenchDistribution;
+
+static const char *s_distribution_names[BenchDistributionCount] = {
+  [BenchDistributionIdentity] = "identity",
+  [BenchDistributionTranslation] = "translation",
+  [BenchDistributionRotation] = "rotation",
+  [BenchDistributionLargeCoordinates] = "large_coordinates",
+};
+
+typedef struct BenchInputs {
+  GTransform transforms[BENCH_NUM_INPUTS];
+  GTransformPrepared prepared[BENCH_NUM_INPUTS];
+  GTransformInverse inverses[BENCH_NUM_INPUTS];
+  GTransformProjective projective[BENCH_NUM_INPUTS];
+  GPoint points[BENCH_NUM_INPUTS];
+  GPointPrecise points_precise[BENCH_NUM_INPUTS];
+  GVector vectors[BENCH_NUM_INPUTS];
+  GRect rects[BENCH_NUM_INPUTS];
+  int32_t angles[BENCH_NUM_INPUTS];
+  GPointPrecise points_out[BENCH_NUM_INPUTS];
+  GVectorPrecise vectors_out[BENCH_NUM_INPUTS];
+} BenchInputs;
+
+static BenchInputs s_inputs;
+
+// The input points in structure-of-arrays layout and the buffer their transforms are written to
+static GPointBufferSoA *s_points_soa;
+static GPointBufferSoA *s_points_soa_out;
+
+// Results are folded into this so the compiler cannot drop the work being measured
+static volatile int32_t s_sink;
+
+static uint32_t s_seed = 0x2545f491;
+
+static int32_t prv_random(int32_t min, int32_t max) {
+  s_seed = s_seed * 1664525 + 1013904223;
+  return min + (int32_t)((s_seed >> 8) % (uint32_t)(max - min + 1));
+}
+
+static void prv_init_inputs(BenchDistribution distribution) {
+  for (int i = 0; i < BENCH_NUM_INPUTS; i++) {
+    GTransform t = GTransformIdentity();
+    int16_t coordinate_max = 168;
+    int32_t angle = 0;
+
+    switch (distribution) {
+      case BenchDistributionIdentity:
+        break;
+      case BenchDistributionTranslation:
+        t = GTransformTranslation(Fixed_S32_16(prv_random(-144 * 0x10000, 144 * 0x10000)),
+                                  Fixed_S32_16(prv_random(-168 * 0x10000, 168 * 0x10000)));
+        break;
+      case BenchDistributionRotation:
+        angle = prv_random(1, TRIG_MAX_ANGLE - 1);
+        t = GTransformRotation(angle);
+        gtransform_scale(&t, &t, Fixed_S32_16(prv_random(1 << 15, 3 << 15)),
+                         Fixed_S32_16(prv_random(1 << 15, 3 << 15)));
+        gtransform_translate(&t, &t, Fixed_S32_16(prv_random(0, 144 << 16)),
+                             Fixed_S32_16(prv_random(0, 168 << 16)));
+        break;
+      case BenchDistributionLargeCoordinates:
+        angle = prv_random(1, TRIG_MAX_ANGLE - 1);
+        t = GTransformRotation(angle);
+        // Keep the product of coordinate and coefficient within the range of the format
+        coordinate_max = (GPOINT_PRECISE_MAX / 2) - 1;
+        break;
+      default:
+        break;
+    }
+
+    s_inputs.transforms[i] = t;
+    gtransform_prepare(&s_inputs.prepared[i], &t);
+    gtransform_prepare_inverse(&s_inputs.inverses[i], &t);
+    // The same matrix behind a card tilted by 30 degrees and seen from 200 px
+    GTransformProjective tilt;
+    gtransform_projective_init_tilt(&tilt, TRIG_MAX_ANGLE / 12, 0, GTransformNumberFromNumber(200));
+    gtransform_projective_compose(&s_inputs.projective[i], NULL, &tilt, &t);
+    s_inputs.angles[i] = angle;
+    s_inputs.points[i] = GPoint(prv_random(-coordinate_max, coordinate_max),
+                                prv_random(-coordinate_max, coordinate_max));
+    s_inputs.points_precise[i] = GPointPreciseFromGPoint(s_inputs.points[i]);
+    s_inputs.vectors[i] = GVector(s_inputs.points[i].x, s_inputs.points[i].y);
+    s_inputs.rects[i] = GRect(s_inputs.points[i].x, s_inputs.points[i].y, prv_random(1, 32),
+                              prv_random(1, 32));
+  }
+
+  if (!s_points_soa) {
+    s_points_soa = gpoint_buffer_create(BENCH_NUM_INPUTS);
+    s_points_soa_out = gpoint_buffer_create(BENCH_NUM_INPUTS);
+  }
+  gpoint_buffer_set_points(s_points_soa, s_inputs.points, BENCH_NUM_INPUTS);
+}
+
+//////////////////////////////////////
+/// Benchmark cases
+//////////////////////////////////////
+// Each case runs one pass over the inputs and returns the number of operations performed
+typedef size_t (*BenchFunction)(void);
+
+#define BENCH_FOR_EACH_INPUT(body)              \
+  do {                                          \
+    for (int i = 0; i < BENCH_NUM_INPUTS; i++) { \
+      body;                                     \
+    }                                           \
+  } while (0)
+
+static size_t prv_bench_fixed_s32_16_mul(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += Fixed_S32_16_mul(s_inputs.transforms[i].a, s_inputs.transforms[i].tx).raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_fixed_s16_3_s32_16_mul(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += Fixed_S16_3_S32_16_mul(s_inputs.points_precise[i].x, s_inputs.transforms[i].a)
+           .raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_init_rotation(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_init_rotation(s_inputs.angles[i]).b.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_init_rotation_cached(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_init_rotation_cached(s_inputs.angles[i]).b.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_init_trs(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gtransform_init_trs(s_inputs.transforms[i].a, s_inputs.transforms[i].d,
+                               s_inputs.angles[i], s_inputs.transforms[i].tx,
+                               s_inputs.transforms[i].ty).b.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_is_identity(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_is_identity(&s_inputs.transforms[i]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_is_only_scale(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_is_only_scale(&s_inputs.transforms[i]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_is_only_translation(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_is_only_translation(&s_inputs.transforms[i]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_is_only_scale_or_translation(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_is_only_scale_or_translation(&s_inputs.transforms[i]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_is_equal(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gtransform_is_equal(&s_inputs.transforms[i],
+                               &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_classify(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(acc += gtransform_classify(&s_inputs.transforms[i]));
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_concat(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_concat(&t_new, &s_inputs.transforms[i],
+                      &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS]);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_concat_rounded(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_concat_rounded(&t_new, &s_inputs.transforms[i],
+                              &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS]);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+// Progress is derived from the index so that every input exercises a different blend
+static size_t prv_bench_interpolate_linear(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_interpolate(&t_new, &s_inputs.transforms[i],
+                           &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS], i * 255 + 1,
+                           GTransformInterpolationLinear);
+    acc += t_new.a.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_interpolate_decomposed(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_interpolate(&t_new, &s_inputs.transforms[i],
+                           &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS], i * 255 + 1,
+                           GTransformInterpolationDecomposed);
+    acc += t_new.a.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+// Decompositions are computed once per tween, so each evaluation is only the blend
+static size_t prv_bench_tween_evaluate_decomposed(void) {
+  static GTransformTween s_tweens[BENCH_NUM_INPUTS];
+  static AnimationProgress s_progress[BENCH_NUM_INPUTS];
+  static GTransform s_out[BENCH_NUM_INPUTS];
+  if (!gtransform_is_equal(&s_tweens[0].from, &s_inputs.transforms[0])) {
+    for (int i = 0; i < BENCH_NUM_INPUTS; i++) {
+      gtransform_tween_init(&s_tweens[i], &s_inputs.transforms[i],
+                            &s_inputs.transforms[(i + 1) % BENCH_NUM_INPUTS],
+                            GTransformInterpolationDecomposed);
+      s_progress[i] = i * 255 + 1;
+    }
+  }
+
+  gtransform_tween_evaluate_array(s_tweens, s_progress, s_out, BENCH_NUM_INPUTS);
+  s_sink = s_out[BENCH_NUM_INPUTS - 1].a.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+// Plays 256 looping tracks of four eased keys forward by one 30 fps frame per pass, so most
+// lookups hit the cursor and every track seeks back once per loop
+#define BENCH_TRACK_NUM_KEYS 4
+#define BENCH_TRACK_FRAME_MS 33
+
+static size_t prv_bench_track_evaluate_array(void) {
+  static GTransformKeyframe s_keys[BENCH_NUM_INPUTS][BENCH_TRACK_NUM_KEYS];
+  static GTransformTrack s_tracks[BENCH_NUM_INPUTS];
+  static GTransform s_out[BENCH_NUM_INPUTS];
+  static uint32_t s_time;
+  if (!s_tracks[0].keys) {
+    for (int i = 0; i < BENCH_NUM_INPUTS; i++) {
+      for (int k = 0; k < BENCH_TRACK_NUM_KEYS; k++) {
+        s_keys[i][k] = (GTransformKeyframe) {
+          .time = k * 1000 + (i % 7) * 10,
+          .sx = Fixed_S32_16(prv_random(0x8000, 0x20000)),
+          .sy = Fixed_S32_16(prv_random(0x8000, 0x20000)),
+          .angle = k * TRIG_MAX_ANGLE / 2,
+          .tx = Fixed_S32_16(prv_random(-100 * 0x10000, 100 * 0x10000)),
+          .ty = Fixed_S32_16(prv_random(-100 * 0x10000, 100 * 0x10000)),
+          .easing = (i + k) % (GTransformEasingEaseInOut + 1),
+        };
+      }
+      gtransform_track_init(&s_tracks[i], s_keys[i], BENCH_TRACK_NUM_KEYS, true);
+    }
+  }
+
+  s_time += BENCH_TRACK_FRAME_MS;
+  gtransform_track_evaluate_array(s_tracks, s_time, s_out, BENCH_NUM_INPUTS);
+  s_sink = s_out[BENCH_NUM_INPUTS - 1].a.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_scale(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_scale(&t_new, &s_inputs.transforms[i], s_inputs.transforms[i].a,
+                     s_inputs.transforms[i].d);
+    acc += t_new.a.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_translate(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_translate(&t_new, &s_inputs.transforms[i], s_inputs.transforms[i].ty,
+                         s_inputs.transforms[i].tx);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_rotate(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_rotate(&t_new, &s_inputs.transforms[i], s_inputs.angles[i]);
+    acc += t_new.b.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_rotate_cached(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_rotate_cached(&t_new, &s_inputs.transforms[i], s_inputs.angles[i]);
+    acc += t_new.b.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_rotate_rounded(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_rotate_rounded(&t_new, &s_inputs.transforms[i], s_inputs.angles[i]);
+    acc += t_new.b.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_rotate_about_point(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_rotate_about_point(&t_new, &s_inputs.transforms[i], s_inputs.angles[i],
+                                  s_inputs.points[i]);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_scale_about_point(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    gtransform_scale_about_point(&t_new, &s_inputs.transforms[i], s_inputs.transforms[i].a,
+                                 s_inputs.transforms[i].d, s_inputs.points[i]);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_invert(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    acc += gtransform_invert(&t_new, &s_inputs.transforms[i]);
+    acc += t_new.tx.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_orthonormalize(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransform t_new;
+    acc += gtransform_orthonormalize(&t_new, &s_inputs.transforms[i]);
+    acc += t_new.a.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_prepare(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransformPrepared prepared;
+    gtransform_prepare(&prepared, &s_inputs.transforms[i]);
+    acc += prepared.type;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpoint_transform(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gpoint_transform(s_inputs.points[i], &s_inputs.transforms[i]).x.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpointprecise_transform(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gpointprecise_transform(s_inputs.points_precise[i],
+                                   &s_inputs.transforms[i]).x.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpointprecise_inverse_transform(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GPointPrecise pointP;
+    acc += gpointprecise_inverse_transform(&pointP, s_inputs.points_precise[i],
+                                           &s_inputs.transforms[i]);
+    acc += pointP.x.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpointprecise_inverse_transform_prepared(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GPointPrecise pointP;
+    acc += gpointprecise_inverse_transform_prepared(&pointP, s_inputs.points_precise[i],
+                                                    &s_inputs.inverses[i]);
+    acc += pointP.x.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gvector_transform(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gvector_transform(s_inputs.vectors[i], &s_inputs.transforms[i]).dx.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpoint_transform_prepared(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += gpoint_transform_prepared(s_inputs.points[i], &s_inputs.prepared[i]).x.raw_value);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+// The batch functions apply a single matrix to every input point, so ops are counted in points
+static size_t prv_bench_gpoint_transform_array(void) {
+  gpoint_transform_array(s_inputs.points, s_inputs.points_out, BENCH_NUM_INPUTS,
+                         &s_inputs.transforms[0]);
+  s_sink = s_inputs.points_out[BENCH_NUM_INPUTS - 1].x.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gvector_transform_array(void) {
+  gvector_transform_array(s_inputs.vectors, s_inputs.vectors_out, BENCH_NUM_INPUTS,
+                          &s_inputs.transforms[0]);
+  s_sink = s_inputs.vectors_out[BENCH_NUM_INPUTS - 1].dx.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpoint_transform_array_prepared(void) {
+  gpoint_transform_array_prepared(s_inputs.points, s_inputs.points_out, BENCH_NUM_INPUTS,
+                                  &s_inputs.prepared[0]);
+  s_sink = s_inputs.points_out[BENCH_NUM_INPUTS - 1].x.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+// Same work as gpoint_transform_array, but on points already stored as separate x and y arrays
+static size_t prv_bench_gpoint_buffer_transform(void) {
+  gpoint_buffer_transform(s_points_soa_out, s_points_soa, &s_inputs.transforms[0]);
+  s_sink = s_points_soa_out->x[BENCH_NUM_INPUTS - 1].raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+// The input points as one path, transformed with its bounding box in the same pass
+static size_t prv_bench_gpath_info_transform(void) {
+  static GPoint s_out[BENCH_NUM_INPUTS];
+  const GPathInfo info = { .num_points = BENCH_NUM_INPUTS, .points = s_inputs.points };
+  GRect bounds;
+  gpath_info_transform(&info, &s_inputs.transforms[0], s_out, &bounds);
+  s_sink = s_out[BENCH_NUM_INPUTS - 1].x + bounds.size.w;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_gpath_info_transform_precise(void) {
+  const GPathInfo info = { .num_points = BENCH_NUM_INPUTS, .points = s_inputs.points };
+  GRect bounds;
+  gpath_info_transform_precise(&info, &s_inputs.transforms[0], s_inputs.points_out, &bounds);
+  s_sink = s_inputs.points_out[BENCH_NUM_INPUTS - 1].x.raw_value + bounds.size.w;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_grect_transform_bounds(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT(
+    acc += grect_transform_bounds(s_inputs.rects[i], &s_inputs.transforms[i]).size.w);
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+// Culls the input rectangles against the screen with one matrix, so ops are counted in rects
+static size_t prv_bench_grect_cull_against(void) {
+  static uint8_t s_visible[(BENCH_NUM_INPUTS + 7) / 8];
+  s_sink = grect_cull_against(s_inputs.rects, BENCH_NUM_INPUTS, &s_inputs.transforms[0],
+                              GRect(0, 0, 144, 168), s_visible);
+  return BENCH_NUM_INPUTS;
+}
+
+// Transforms every pixel of a 144 px row with one matrix per row, pixel by pixel or with the
+// iterator; ops are counted in pixels
+#define BENCH_ROW_LENGTH 144
+
+static size_t prv_bench_row_gpoint_transform(void) {
+  int32_t acc = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    for (int x = 0; x < BENCH_ROW_LENGTH; x++) {
+      acc += gpoint_transform(GPoint(x, i), &s_inputs.transforms[i]).x.raw_value;
+    }
+  }
+  s_sink = acc;
+  return (BENCH_NUM_INPUTS / 16) * BENCH_ROW_LENGTH;
+}
+
+static size_t prv_bench_row_iterator(void) {
+  int32_t acc = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    GTransformIterator iter;
+    gtransform_iter_begin(&iter, &s_inputs.transforms[i], 0, i);
+    for (int x = 0; x < BENCH_ROW_LENGTH; x++, gtransform_iter_next(&iter)) {
+      acc += gtransform_iter_get_point(&iter).x.raw_value;
+    }
+  }
+  s_sink = acc;
+  return (BENCH_NUM_INPUTS / 16) * BENCH_ROW_LENGTH;
+}
+
+// Starts an iterator at a pixel center and jumps into the row, as when entering a clip rectangle
+static size_t prv_bench_iter_skip(void) {
+  int32_t acc = 0;
+  BENCH_FOR_EACH_INPUT({
+    GTransformIterator iter;
+    gtransform_iter_begin_precise(&iter, &s_inputs.transforms[i],
+                                  GPointPrecise(4, s_inputs.points_precise[i].y.raw_value + 4));
+    gtransform_iter_skip(&iter, s_inputs.points[i].x);
+    acc += iter.x.raw_value;
+  });
+  s_sink = acc;
+  return BENCH_NUM_INPUTS;
+}
+
+// Walks a 144x16 block row by row with whole pixel results, as when sampling a texture; ops are
+// counted in pixels
+#define BENCH_BLOCK_HEIGHT 16
+
+static size_t prv_bench_block_iterator(void) {
+  int32_t acc = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    GTransformIterator iter;
+    gtransform_iter_begin_precise(&iter, &s_inputs.transforms[i], GPointPrecise(4, 4));
+    for (int y = 0; y < BENCH_BLOCK_HEIGHT; y++, gtransform_iter_next_row(&iter)) {
+      for (int x = 0; x < BENCH_ROW_LENGTH; x++, gtransform_iter_next(&iter)) {
+        acc += gtransform_iter_get_gpoint(&iter).x;
+      }
+    }
+  }
+  s_sink = acc;
+  return (BENCH_NUM_INPUTS / 16) * BENCH_BLOCK_HEIGHT * BENCH_ROW_LENGTH;
+}
+
+static size_t prv_bench_gpoint_transform_projective_array(void) {
+  gpoint_transform_projective_array(s_inputs.points, s_inputs.points_out, BENCH_NUM_INPUTS,
+                                    &s_inputs.projective[0]);
+  s_sink = s_inputs.points_out[BENCH_NUM_INPUTS - 1].x.raw_value;
+  return BENCH_NUM_INPUTS;
+}
+
+static size_t prv_bench_row_gpoint_transform_projective(void) {
+  int32_t acc = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    for (int x = 0; x < BENCH_ROW_LENGTH; x++) {
+      GPointPrecise pointP;
+      gpoint_transform_projective(&pointP, GPoint(x, i), &s_inputs.projective[i]);
+      acc += pointP.x.raw_value;
+    }
+  }
+  s_sink = acc;
+  return (BENCH_NUM_INPUTS / 16) * BENCH_ROW_LENGTH;
+}
+
+static size_t prv_bench_row_projective_iterator(void) {
+  int32_t acc = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    GTransformProjectiveIterator iter;
+    gtransform_projective_iter_begin(&iter, &s_inputs.projective[i], GPointPrecise(0, i * 8));
+    for (int x = 0; x < BENCH_ROW_LENGTH; x++, gtransform_projective_iter_next(&iter)) {
+      acc += gtransform_projective_iter_get_point(&iter).x.raw_value;
+    }
+  }
+  s_sink = acc;
+  return (BENCH_NUM_INPUTS / 16) * BENCH_ROW_LENGTH;
+}
+
+// Draws a 32x32 sprite into a 144x168 framebuffer with each input matrix, centered on screen
+static size_t prv_bench_gbitmap_draw_transformed(void) {
+  static GBitmap *s_sprite;
+  static GBitmap *s_framebuffer;
+  if (!s_sprite) {
+    s_sprite = gbitmap_create_blank(GSize(32, 32), GBitmapFormat8Bit);
+    s_framebuffer = gbitmap_create_blank(GSize(144, 168), GBitmapFormat8Bit);
+    memset(gbitmap_get_data(s_sprite), 0xff, 32 * gbitmap_get_bytes_per_row(s_sprite));
+  }
+
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    GTransform t = s_inputs.transforms[i];
+    t.tx = GTransformNumberFromNumber(72);
+    t.ty = GTransformNumberFromNumber(84);
+    gbitmap_draw_transformed(s_framebuffer, GRect(0, 0, 144, 168), s_sprite, &t);
+  }
+  return BENCH_NUM_INPUTS / 16;
+}
+
+// Steps a fountain of about 1000 particles, which emits 10 per frame that live 100 frames, and
+// draws it into a 144x168 framebuffer with each input matrix as the camera; ops are counted in
+// particles
+#define BENCH_NUM_PARTICLES 1000
+
+static size_t prv_bench_particle_system_step(void) {
+  static uint32_t s_storage[GPARTICLE_SYSTEM_STORAGE_WORDS(BENCH_NUM_PARTICLES)];
+  static GParticleSystem s_system;
+  static GBitmap *s_framebuffer;
+  if (!s_framebuffer) {
+    s_framebuffer = gbitmap_create_blank(GSize(144, 168), GBitmapFormat8Bit);
+    gparticle_system_init(&s_system, s_storage, BENCH_NUM_PARTICLES);
+    s_system.ay = GTransformNumberFromNumber(0.05);
+  }
+
+  const GParticleEmitter emitter = {
+    .dy = GTransformNumberFromNumber(-2),
+    .spread = GTransformNumberFromNumber(1),
+    .life = BENCH_NUM_PARTICLES / 10,
+    .rate = 10,
+  };
+  size_t num_particles = 0;
+  for (int i = 0; i < BENCH_NUM_INPUTS; i += 16) {
+    GTransform camera = s_inputs.transforms[i];
+    camera.tx = GTransformNumberFromNumber(72);
+    camera.ty = GTransformNumberFromNumber(84);
+    gparticle_system_step(&s_system, &emitter, &camera, s_framebuffer, GRect(0, 0, 144, 168),
+                          0xff);
+    num_particles += s_system.num_particles;
+  }
+  return num_particles;
+}
+
+typedef struct BenchCase {
+  const char *name;
+  BenchFunction function;
+} BenchCase;
+
+#define BENCH_CASE(name) { #name, prv_bench_##name }
+
+static const BenchCase s_cases[] = {
+  BENCH_CASE(fixed_s32_16_mul),
+  BENCH_CASE(fixed_s16_3_s32_16_mul),
+  BENCH_CASE(init_rotation),
+  BENCH_CASE(init_rotation_cached),
+  BENCH_CASE(init_trs),
+  BENCH_CASE(is_identity),
+  BENCH_CASE(is_only_scale),
+  BENCH_CASE(is_only_translation),
+  BENCH_CASE(is_only_scale_or_translation),
+  BENCH_CASE(is_equal),
+  BENCH_CASE(classify),
+  BENCH_CASE(concat),
+  BENCH_CASE(concat_rounded),
+  BENCH_CASE(interpolate_linear),
+  BENCH_CASE(interpolate_decomposed),
+  BENCH_CASE(tween_evaluate_decomposed),
+  BENCH_CASE(track_evaluate_array),
+  BENCH_CASE(scale),
+  BENCH_CASE(translate),
+  BENCH_CASE(rotate),
+  BENCH_CASE(rotate_cached),
+  BENCH_CASE(rotate_rounded),
+  BENCH_CASE(rotate_about_point),
+  BENCH_CASE(scale_about_point),
+  BENCH_CASE(invert),
+  BENCH_CASE(orthonormalize),
+  BENCH_CASE(prepare),
+  BENCH_CASE(gpoint_transform),
+  BENCH_CASE(gpointprecise_transform),
+  BENCH_CASE(gpointprecise_inverse_transform),
+  BENCH_CASE(gpointprecise_inverse_transform_prepared),
+  BENCH_CASE(gvector_transform),
+  BENCH_CASE(gpoint_transform_prepared),
+  BENCH_CASE(gpoint_transform_array),
+  BENCH_CASE(gvector_transform_array),
+  BENCH_CASE(gpoint_transform_array_prepared),
+  BENCH_CASE(gpoint_buffer_transform),
+  BENCH_CASE(gpath_info_transform),
+  BENCH_CASE(gpath_info_transform_precise),
+  BENCH_CASE(grect_transform_bounds),
+  BENCH_CASE(grect_cull_against),
+  BENCH_CASE(row_gpoint_transform),
+  BENCH_CASE(row_iterator),
+  BENCH_CASE(iter_skip),
+  BENCH_CASE(block_iterator),
+  BENCH_CASE(gpoint_transform_projective_array),
+  BENCH_CASE(row_gpoint_transform_projective),
+  BENCH_CASE(row_projective_iterator),
+  BENCH_CASE(gbitmap_draw_transformed),
+  BENCH_CASE(particle_system_step),
+};
+
+#define BENCH_NUM_CASES (sizeof(s_cases) / sizeof(s_cases[0]))
+
+//////////////////////////////////////
+/// Measurement and reporting
+//////////////////////////////////////
+typedef struct BenchResult {
+  double ns_per_op;
+  double ops_per_sec;
+  double cycles_per_op;
+} BenchResult;
+
+static uint64_t prv_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static BenchResult prv_measure(BenchFunction function) {
+  BenchResult best = { 0 };
+
+  // Warm up caches and branch predictors
+  function();
+
+  for (int repeat = 0; repeat < BENCH_NUM_REPEATS; repeat++) {
+    size_t ops = 0;
+    const uint64_t start_ns = prv_now_ns();
+    const uint64_t start_cycles = prv_cycles();
+    for (int pass = 0; pass < BENCH_NUM_PASSES; pass++) {
+      ops += function();
+    }
+    const uint64_t cycles = prv_cycles() - start_cycles;
+    const uint64_t ns = prv_now_ns() - start_ns;
+
+    const double ns_per_op = (double)ns / ops;
+    if ((repeat == 0) || (ns_per_op < best.ns_per_op)) {
+      best.ns_per_op = ns_per_op;
+      best.ops_per_sec = (ns_per_op > 0) ? (1e9 / ns_per_op) : 0;
+      best.cycles_per_op = (double)cycles / ops;
+    }
+  }
+
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  bool json = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else {
+      fprintf(stderr, "usage: %s [--json]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if (json) {
+    printf("{\n  \"cycles_available\": %s,\n  \"results\": [", BENCH_HAS_CYCLES ? "true" : "false");
+  } else {
+    printf("%-34s %-18s %10s %14s %10s\n", "function", "distribution", "ns/op", "ops/sec",
+           "cycles/op");
+  }
+
+  bool first = true;
+  for (int distribution = 0; distribution < BenchDistributionCount; distribution++) {
+    prv_init_inputs(distribution);
+
+    for (size_t i = 0; i < BENCH_NUM_CASES; i++) {
+      const BenchResult result = prv_measure(s_cases[i].function);
+      if (json) {
+        printf("%s\n    { \"function\": \"%s\", \"distribution\": \"%s\", \"ns_per_op\": %.3f, "
+               "\"ops_per_sec\": %.0f, \"cycles_per_op\": ",
+               first ? "" : ",", s_cases[i].name, s_distribution_names[distribution],
+               result.ns_per_op, result.ops_per_sec);
+        if (BENCH_HAS_CYCLES) {
+          printf("%.2f }", result.cycles_per_op);
+        } else {
+          printf("null }");
+        }
+      } else {
+        printf("%-34s %-18s %10.3f %14.0f %10.2f\n", s_cases[i].name,
+               s_distribution_names[distribution], result.ns_per_op, result.ops_per_sec,
+               result.cycles_per_op);
+      }
+      first = false;
+    }
+  }
+
+  if (json) {
+    printf("\n  ]\n}\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+//! Minimal stand-in for the Pebble SDK header used to build the math core on the host.
+//! Only the types and functions that the library depends on are provided here; they follow
+//! the declarations and semantics of the SDK.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//! Calculate the length of an array, based on the size of the element type.
+#define ARRAY_LENGTH(array) (sizeof((array))/sizeof((array)[0]))
+
+//! Represents a point in a 2-dimensional coordinate system.
+typedef struct GPoint {
+  //! The x-coordinate.
+  int16_t x;
+  //! The y-coordinate.
+  int16_t y;
+} GPoint;
+
+//! Convenience macro to make a GPoint.
+#define GPoint(x, y) ((GPoint){(x), (y)})
+
+//! Represents a 2-dimensional size.
+typedef struct GSize {
+  //! The width
+  int16_t w;
+  //! The height
+  int16_t h;
+} GSize;
+
+//! Convenience macro to make a GSize.
+#define GSize(w, h) ((GSize){(w), (h)})
+
+//! Represents a rectangle and defining it using the origin of the upper-lefthand corner and
+//! its size.
+typedef struct GRect {
+  //! The coordinate of the upper-lefthand corner point of the rectangle.
+  GPoint origin;
+  //! The size of the rectangle.
+  GSize size;
+} GRect;
+
+//! Convenience macro to make a GRect
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+
+//! Data structure describing a naked path
+typedef struct GPathInfo {
+  //! The number of points in the `points` array
+  uint32_t num_points;
+  //! Pointer to an array of points.
+  GPoint *points;
+} GPathInfo;
+
+//! The largest value that can result from a call to sin_lookup or cos_lookup.
+#define TRIG_MAX_RATIO 0xffff
+
+//! Angle value that corresponds to 360 degrees or 2 PI radians
+#define TRIG_MAX_ANGLE 0x10000
+
+//! Look-up the sine of the given angle from a pre-computed table.
+//! @param angle The angle for which to compute the sine, where 0x10000 represents 360 degrees.
+//! @return The signed sine of the angle, scaled by TRIG_MAX_RATIO.
+int32_t sin_lookup(int32_t angle);
+
+//! Look-up the cosine of the given angle from a pre-computed table.
+//! @param angle The angle for which to compute the cosine, where 0x10000 represents 360 degrees.
+//! @return The signed cosine of the angle, scaled by TRIG_MAX_RATIO.
+int32_t cos_lookup(int32_t angle);
+
+//! Look-up the arctangent of a given x, y pair.
+//! @param y The y coordinate
+//! @param x The x coordinate
+//! @return The angle of the point (x, y) from the x axis, from 0 to TRIG_MAX_ANGLE.
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+//! The normalized distance at the start of an animation.
+#define ANIMATION_NORMALIZED_MIN 0
+
+//! The normalized distance at the end of an animation.
+#define ANIMATION_NORMALIZED_MAX 65535
+
+//! Progress of an animation, from ANIMATION_NORMALIZED_MIN to ANIMATION_NORMALIZED_MAX. Curves
+//! that overshoot can produce values outside of that range.
+typedef int32_t AnimationProgress;
+
+//! Indicates the format of a GBitmap
+typedef enum GBitmapFormat {
+  //! 1-bit black and white. 0 = black, 1 = white.
+  GBitmapFormat1Bit = 0,
+  //! 6-bit color + 2 bit alpha channel.
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+} GBitmapFormat;
+
+//! Opaque bitmap type. On the host it always owns its pixel data.
+typedef struct GBitmap GBitmap;
+
+//! Creates a new blank GBitmap on the heap initialized to zeroes.
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+
+//! Destroys a GBitmap and its pixel data.
+void gbitmap_destroy(GBitmap *bitmap);
+
+//! Get the number of bytes per row in the bitmap data.
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+
+//! Get the GBitmapFormat for the GBitmap.
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+
+//! Get a pointer to the raw image data section of the bitmap.
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+
+//! Gets the bounds of the content of the GBitmap.
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+
+//! Opaque graphics context. On the host it draws into a caller provided framebuffer.
+typedef struct GContext GContext;
+
+//! Host only: creates a graphics context that draws into the given bitmap. The bitmap is not
+//! owned by the context.
+GContext *graphics_context_create_for_bitmap(GBitmap *framebuffer);
+
+//! Host only: destroys a context created with graphics_context_create_for_bitmap.
+void graphics_context_destroy(GContext *ctx);
+
+//! Gets the framebuffer bitmap so that it can be modified directly.
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+
+//! Releases the framebuffer captured with graphics_capture_frame_buffer.
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+//! Bit mask of the corners of a rectangle that are rounded.
+typedef enum {
+  //! No corners
+  GCornerNone = 0,
+  //! Top-Left corner
+  GCornerTopLeft = 1 << 0,
+  //! Top-Right corner
+  GCornerTopRight = 1 << 1,
+  //! Bottom-Left corner
+  GCornerBottomLeft = 1 << 2,
+  //! Bottom-Right corner
+  GCornerBottomRight = 1 << 3,
+  //! All corners
+  GCornersAll = GCornerTopLeft | GCornerTopRight | GCornerBottomLeft | GCornerBottomRight,
+} GCornerMask;
+
+//! Data structure describing a path, plus its rotation and translation.
+typedef struct GPath {
+  //! The number of points in the `points` array
+  uint32_t num_points;
+  //! Pointer to an array of points.
+  GPoint *points;
+  //! The rotation that will be used when drawing the path with gpath_draw_filled() or
+  //! gpath_draw_outline()
+  int32_t rotation;
+  //! The offset that will be used when drawing the path with gpath_draw_filled() or
+  //! gpath_draw_outline()
+  GPoint offset;
+} GPath;
+
+//! Draws line in the current stroke color, current stroke width and AA flag.
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+
+//! Draws a 1-pixel wide rectangle outline in the current stroke color.
+void graphics_draw_rect(GContext *ctx, GRect rect);
+
+//! Fills a rectangle with the current fill color, optionally rounding all or a selection of
+//! its corners.
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask);
+
+//! Draws the outline of a circle in the current stroke color.
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+
+//! Fills a circle in the current fill color.
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+
+//! Draws the outline of a path using the current stroke color.
+void gpath_draw_outline(GContext *ctx, GPath *path);
+
+//! Draws the fill of a path into a graphics context, using the current fill color.
+void gpath_draw_filled(GContext *ctx, GPath *path);
+
+//! Host only: drawing primitives that can be issued through a GContext.
+typedef enum HostDrawOp {
+  HostDrawOpLine,
+  HostDrawOpRect,
+  HostDrawOpFillRect,
+  HostDrawOpCircle,
+  HostDrawOpFillCircle,
+  HostDrawOpPathOutline,
+  HostDrawOpPathFilled,
+} HostDrawOp;
+
+//! Host only: most points of a path that are recorded
+#define HOST_DRAW_CALL_MAX_POINTS 64
+
+//! Host only: a drawing primitive as it was issued, so tests can check what would be drawn.
+typedef struct HostDrawCall {
+  HostDrawOp op;
+  //! Line ends, or the circle center in p0
+  GPoint p0;
+  GPoint p1;
+  GRect rect;
+  uint16_t radius;
+  //! Path points, with the path offset already applied
+  uint32_t num_points;
+  GPoint points[HOST_DRAW_CALL_MAX_POINTS];
+} HostDrawCall;
+
+//! Host only: the drawing primitives do not rasterize; they are recorded in the context
+//! instead. Returns the number of recorded calls and points calls at them.
+size_t graphics_context_get_draw_calls(GContext *ctx, const HostDrawCall **calls);
+
+//! Host only: forgets the recorded calls.
+void graphics_context_clear_draw_calls(GContext *ctx);
@@ -0,0 +1,193 @@
+#include <pebble.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The SDK reads these from a quarter-wave table; computing them in double precision and rounding
+// gives the same results to within one unit of TRIG_MAX_RATIO.
+#define PI 3.14159265358979323846
+
+static int32_t prv_normalize_angle(int32_t angle) {
+  return angle & (TRIG_MAX_ANGLE - 1);
+}
+
+int32_t sin_lookup(int32_t angle) {
+  const double radians = prv_normalize_angle(angle) * (2 * PI) / TRIG_MAX_ANGLE;
+  return (int32_t)lround(sin(radians) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  const double radians = prv_normalize_angle(angle) * (2 * PI) / TRIG_MAX_ANGLE;
+  return (int32_t)lround(cos(radians) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+  const int32_t angle = (int32_t)lround(atan2(y, x) * TRIG_MAX_ANGLE / (2 * PI));
+  return prv_normalize_angle(angle);
+}
+
+struct GBitmap {
+  uint8_t *data;
+  uint16_t bytes_per_row;
+  GBitmapFormat format;
+  GRect bounds;
+};
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  if ((format != GBitmapFormat1Bit) && (format != GBitmapFormat8Bit)) {
+    return NULL;
+  }
+
+  GBitmap *bitmap = malloc(sizeof(GBitmap));
+  if (!bitmap) {
+    return NULL;
+  }
+
+  // 1-bit rows are padded to a multiple of 32 bits like the firmware does
+  bitmap->bytes_per_row = (format == GBitmapFormat1Bit) ? ((size.w + 31) / 32) * 4 : size.w;
+  bitmap->format = format;
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->data = calloc(size.h, bitmap->bytes_per_row);
+  if (!bitmap->data) {
+    free(bitmap);
+    return NULL;
+  }
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap) {
+    free(bitmap->data);
+    free(bitmap);
+  }
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->bytes_per_row;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+  return bitmap->format;
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+struct GContext {
+  GBitmap *framebuffer;
+  bool framebuffer_captured;
+  HostDrawCall *draw_calls;
+  size_t num_draw_calls;
+  size_t draw_calls_capacity;
+};
+
+GContext *graphics_context_create_for_bitmap(GBitmap *framebuffer) {
+  GContext *ctx = calloc(1, sizeof(GContext));
+  if (ctx) {
+    ctx->framebuffer = framebuffer;
+  }
+  return ctx;
+}
+
+void graphics_context_destroy(GContext *ctx) {
+  if (ctx) {
+    free(ctx->draw_calls);
+  }
+  free(ctx);
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  if (ctx->framebuffer_captured) {
+    return NULL;
+  }
+  ctx->framebuffer_captured = true;
+  return ctx->framebuffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  if (!ctx->framebuffer_captured || (buffer != ctx->framebuffer)) {
+    return false;
+  }
+  ctx->framebuffer_captured = false;
+  return true;
+}
+
+// The drawing primitives are recorded instead of rasterized so that tests can check the exact
+// arguments that would reach the firmware
+static HostDrawCall *prv_record(GContext *ctx, HostDrawOp op) {
+  if (ctx->num_draw_calls == ctx->draw_calls_capacity) {
+    const size_t capacity = ctx->draw_calls_capacity ? (2 * ctx->draw_calls_capacity) : 16;
+    HostDrawCall *draw_calls = realloc(ctx->draw_calls, capacity * sizeof(HostDrawCall));
+    if (!draw_calls) {
+      abort();
+    }
+    ctx->draw_calls = draw_calls;
+    ctx->draw_calls_capacity = capacity;
+  }
+
+  HostDrawCall *call = &ctx->draw_calls[ctx->num_draw_calls++];
+  memset(call, 0, sizeof(*call));
+  call->op = op;
+  return call;
+}
+
+static void prv_record_path(GContext *ctx, HostDrawOp op, const GPath *path) {
+  HostDrawCall *call = prv_record(ctx, op);
+  call->num_points = path->num_points;
+  for (uint32_t i = 0; (i < path->num_points) && (i < HOST_DRAW_CALL_MAX_POINTS); i++) {
+    call->points[i] = GPoint(path->points[i].x + path->offset.x,
+                             path->points[i].y + path->offset.y);
+  }
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  HostDrawCall *call = prv_record(ctx, HostDrawOpLine);
+  call->p0 = p0;
+  call->p1 = p1;
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+  prv_record(ctx, HostDrawOpRect)->rect = rect;
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius,
+                        GCornerMask corner_mask) {
+  prv_record(ctx, HostDrawOpFillRect)->rect = rect;
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  HostDrawCall *call = prv_record(ctx, HostDrawOpCircle);
+  call->p0 = p;
+  call->radius = radius;
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  HostDrawCall *call = prv_record(ctx, HostDrawOpFillCircle);
+  call->p0 = p;
+  call->radius = radius;
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  prv_record_path(ctx, HostDrawOpPathOutline, path);
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  prv_record_path(ctx, HostDrawOpPathFilled, path);
+}
+
+size_t graphics_context_get_draw_calls(GContext *ctx, const HostDrawCall **calls) {
+  if (calls) {
+    *calls = ctx->draw_calls;
+  }
+  return ctx->num_draw_calls;
+}
+
+void graphics_context_clear_draw_calls(GContext *ctx) {
+  ctx->num_draw_calls = 0;
+}
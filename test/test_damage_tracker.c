@@ -0,0 +1,266 @@
+#include <pebble.h>
+
+#include "gdamage_tracker.h"
+#include "unit.h"
+
+#include <string.h>
+
+#define SCREEN_WIDTH 144
+#define SCREEN_HEIGHT 168
+#define SCREEN_AREA (SCREEN_WIDTH * SCREEN_HEIGHT)
+#define NUM_OBJECTS 16
+
+static GDamageObject s_objects[NUM_OBJECTS];
+
+static bool prv_rect_contains(GRect rect, int x, int y) {
+  return (x >= rect.origin.x) && (y >= rect.origin.y) && (x < rect.origin.x + rect.size.w) &&
+         (y < rect.origin.y + rect.size.h);
+}
+
+// Counts how often every pixel of the screen is damaged, and checks that none is damaged twice
+static int prv_count_damage(const GDamageTracker *tracker, uint8_t *coverage) {
+  memset(coverage, 0, SCREEN_AREA);
+  const GRect *rects;
+  const uint8_t num_rects = gdamage_tracker_get_rects(tracker, &rects);
+  int num_pixels = 0;
+  for (uint8_t i = 0; i < num_rects; i++) {
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+      for (int x = 0; x < SCREEN_WIDTH; x++) {
+        if (prv_rect_contains(rects[i], x, y)) {
+          coverage[y * SCREEN_WIDTH + x]++;
+          num_pixels++;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < SCREEN_AREA; i++) {
+    unit_check(coverage[i] <= 1);
+  }
+  return num_pixels;
+}
+
+static void prv_init(GDamageTracker *tracker) {
+  gdamage_tracker_init(tracker, s_objects, NUM_OBJECTS, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+  gdamage_tracker_begin_frame(tracker);
+}
+
+//////////////////////////////////////
+/// Tests
+//////////////////////////////////////
+static void test_init(void) {
+  // Nothing has been drawn at first, so the whole screen is damaged
+  GDamageTracker tracker;
+  gdamage_tracker_init(&tracker, s_objects, NUM_OBJECTS, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+  unit_check(gdamage_tracker_get_area(&tracker) == SCREEN_AREA);
+  unit_check(!gdamage_tracker_object_is_damaged(&tracker, 0));
+
+  gdamage_tracker_begin_frame(&tracker);
+  unit_check(gdamage_tracker_get_area(&tracker) == 0);
+  unit_check(!gdamage_tracker_intersects(&tracker, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT)));
+
+  gdamage_tracker_invalidate(&tracker);
+  const GRect *rects;
+  unit_check(gdamage_tracker_get_rects(&tracker, &rects) == 1);
+  unit_check(rects[0].size.w == SCREEN_WIDTH);
+  unit_check(gdamage_tracker_get_rects(&tracker, NULL) == 0);
+  unit_check(gdamage_tracker_get_area(NULL) == 0);
+}
+
+static void test_set_bounds(void) {
+  GDamageTracker tracker;
+  prv_init(&tracker);
+
+  // An object that appears damages its bounds
+  unit_check(gdamage_tracker_set_bounds(&tracker, 3, GRect(10, 10, 20, 10)));
+  unit_check(gdamage_tracker_get_area(&tracker) == 200);
+  unit_check(gdamage_tracker_object_is_damaged(&tracker, 3));
+
+  // An object that stays in place damages nothing
+  gdamage_tracker_begin_frame(&tracker);
+  unit_check(!gdamage_tracker_set_bounds(&tracker, 3, GRect(10, 10, 20, 10)));
+  unit_check(gdamage_tracker_get_area(&tracker) == 0);
+  unit_check(!gdamage_tracker_object_is_damaged(&tracker, 3));
+
+  // An object that moves far damages where it was and where it is now
+  gdamage_tracker_begin_frame(&tracker);
+  unit_check(gdamage_tracker_set_bounds(&tracker, 3, GRect(100, 100, 20, 10)));
+  const GRect *rects;
+  unit_check(gdamage_tracker_get_rects(&tracker, &rects) == 2);
+  unit_check(gdamage_tracker_get_area(&tracker) == 400);
+
+  // A small step merges both into one rectangle
+  gdamage_tracker_begin_frame(&tracker);
+  unit_check(gdamage_tracker_set_bounds(&tracker, 3, GRect(102, 101, 20, 10)));
+  unit_check(gdamage_tracker_get_rects(&tracker, &rects) == 1);
+  unit_check(gdamage_tracker_get_area(&tracker) == 22 * 11);
+
+  // Static objects are redrawn only where the damage reaches them
+  gdamage_tracker_begin_frame(&tracker);
+  gdamage_tracker_set_bounds(&tracker, 4, GRect(0, 0, 50, 50));
+  gdamage_tracker_set_bounds(&tracker, 5, GRect(110, 100, 5, 5));
+  gdamage_tracker_begin_frame(&tracker);
+  gdamage_tracker_set_bounds(&tracker, 3, GRect(103, 101, 20, 10));
+  unit_check(!gdamage_tracker_object_is_damaged(&tracker, 4));
+  unit_check(gdamage_tracker_object_is_damaged(&tracker, 5));
+
+  // Hiding an object damages its last bounds
+  gdamage_tracker_begin_frame(&tracker);
+  gdamage_tracker_hide(&tracker, 4);
+  unit_check(gdamage_tracker_get_area(&tracker) == 2500);
+  unit_check(!gdamage_tracker_object_is_damaged(&tracker, 4));
+  gdamage_tracker_begin_frame(&tracker);
+  gdamage_tracker_hide(&tracker, 4);
+  unit_check(gdamage_tracker_get_area(&tracker) == 0);
+
+  // Damage is limited to the screen
+  gdamage_tracker_add_rect(&tracker, GRect(-10, 160, 20, 20));
+  unit_check(gdamage_tracker_get_area(&tracker) == 10 * 8);
+  gdamage_tracker_add_rect(&tracker, GRect(200, 0, 20, 20));
+  unit_check(gdamage_tracker_get_area(&tracker) == 10 * 8);
+
+  unit_check(!gdamage_tracker_set_bounds(&tracker, NUM_OBJECTS, GRect(0, 0, 5, 5)));
+  unit_check(!gdamage_tracker_set_bounds(NULL, 0, GRect(0, 0, 5, 5)));
+  unit_check(!gdamage_tracker_object_is_damaged(&tracker, NUM_OBJECTS));
+}
+
+static void test_merge(void) {
+  static uint8_t s_coverage[SCREEN_AREA];
+  static uint8_t s_expected[SCREEN_AREA];
+
+  // However the damage is added, it covers every damaged pixel once and uses at most
+  // GDAMAGE_TRACKER_MAX_RECTS rectangles
+  for (int round = 0; round < 200; round++) {
+    GDamageTracker tracker;
+    prv_init(&tracker);
+    memset(s_expected, 0, sizeof(s_expected));
+
+    const int num_added = unit_random(1, 20);
+    int num_expected = 0;
+    for (int i = 0; i < num_added; i++) {
+      const GRect rect = GRect(unit_random(-20, SCREEN_WIDTH), unit_random(-20, SCREEN_HEIGHT),
+                               unit_random(1, 30), unit_random(1, 30));
+      gdamage_tracker_add_rect(&tracker, rect);
+      for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+          if (prv_rect_contains(rect, x, y) && !s_expected[y * SCREEN_WIDTH + x]) {
+            s_expected[y * SCREEN_WIDTH + x] = 1;
+            num_expected++;
+          }
+        }
+      }
+    }
+
+    const GRect *rects;
+    unit_check(gdamage_tracker_get_rects(&tracker, &rects) <= GDAMAGE_TRACKER_MAX_RECTS);
+    const int num_pixels = prv_count_damage(&tracker, s_coverage);
+    unit_check(num_pixels == (int)gdamage_tracker_get_area(&tracker));
+    unit_check(num_pixels >= num_expected);
+    for (int i = 0; i < SCREEN_AREA; i++) {
+      unit_check(s_coverage[i] >= s_expected[i]);
+    }
+  }
+
+  // Neighbours that line up become one rectangle without extra pixels
+  GDamageTracker tracker;
+  prv_init(&tracker);
+  gdamage_tracker_add_rect(&tracker, GRect(10, 10, 10, 10));
+  gdamage_tracker_add_rect(&tracker, GRect(20, 10, 10, 10));
+  gdamage_tracker_add_rect(&tracker, GRect(10, 20, 20, 5));
+  const GRect *rects;
+  unit_check(gdamage_tracker_get_rects(&tracker, &rects) == 1);
+  unit_check(gdamage_tracker_get_area(&tracker) == 20 * 15);
+}
+
+static void test_update(void) {
+  GDamageTracker tracker;
+  prv_init(&tracker);
+
+  // Translations give the exact bounds, also at fractions of a pixel
+  GTransform t = GTransformTranslationFromNumber(30, 40);
+  gdamage_tracker_update(&tracker, 0, GRect(-5, -5, 11, 11), &t);
+  unit_check(prv_rect_contains(s_objects[0].bounds, 25, 35));
+  unit_check(s_objects[0].bounds.origin.x == 25);
+  unit_check((s_objects[0].bounds.size.w == 11) && (s_objects[0].bounds.size.h == 11));
+  t = GTransformTranslationFromNumber(30.5, 40);
+  gdamage_tracker_update(&tracker, 0, GRect(-5, -5, 11, 11), &t);
+  unit_check((s_objects[0].bounds.origin.x == 25) && (s_objects[0].bounds.size.w == 12));
+  gdamage_tracker_update(&tracker, 1, GRect(2, 3, 4, 5), NULL);
+  unit_check(s_objects[1].bounds.origin.y == 3);
+  unit_check((s_objects[1].bounds.size.w == 4) && (s_objects[1].bounds.size.h == 5));
+
+  // Under any matrix, every pixel of the object lands in its bounds, whether the drawing rounds
+  // its transformed position down or to the nearest pixel
+  for (int round = 0; round < 100; round++) {
+    t = GTransformTRS(Fixed_S32_16(unit_random(0x4000, 0x30000)),
+                      Fixed_S32_16(unit_random(0x4000, 0x30000)),
+                      unit_random(0, TRIG_MAX_ANGLE - 1),
+                      Fixed_S32_16(unit_random(0, 144 << 16)),
+                      Fixed_S32_16(unit_random(0, 168 << 16)));
+    const GRect local = GRect(unit_random(-20, 0), unit_random(-20, 0), unit_random(1, 20),
+                              unit_random(1, 20));
+    gdamage_tracker_update(&tracker, 2, local, &t);
+    const GRect bounds = s_objects[2].bounds;
+    for (int y = local.origin.y; y < local.origin.y + local.size.h; y++) {
+      for (int x = local.origin.x; x < local.origin.x + local.size.w; x++) {
+        const GPointPrecise pointP = gpoint_transform(GPoint(x, y), &t);
+        const GPoint floored = GPointFromGPointPrecise(pointP);
+        const GPoint rounded = GPointFromGPointPreciseRounded(pointP);
+        unit_check(prv_rect_contains(bounds, floored.x, floored.y));
+        unit_check(prv_rect_contains(bounds, rounded.x, rounded.y));
+      }
+    }
+  }
+}
+
+// A sun in the middle of the screen with an earth and a moon that circle it, as in the sample
+// watchface. Reports the pixels that the damage tracker redraws per frame.
+static void test_report(void) {
+  enum { Sun, Earth, Moon };
+  GDamageTracker tracker;
+  gdamage_tracker_init(&tracker, s_objects, NUM_OBJECTS, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+
+  const int num_frames = 360;
+  uint32_t total = 0;
+  uint32_t most = 0;
+  for (int frame = 0; frame < num_frames; frame++) {
+    const int32_t earth_angle = -frame * (TRIG_MAX_ANGLE / 90);
+    const int32_t moon_angle = -frame * (TRIG_MAX_ANGLE / 40);
+    GTransform sun = GTransformTranslationFromNumber(72, 84);
+    GTransform earth = GTransformTranslationFromNumber(0, -60);
+    GTransform rotation = GTransformRotation(earth_angle);
+    gtransform_concat(&earth, &earth, &rotation);
+    gtransform_concat(&earth, &earth, &sun);
+    GTransform moon = GTransformTranslationFromNumber(0, -20);
+    rotation = GTransformRotation(moon_angle - earth_angle);
+    gtransform_concat(&moon, &moon, &rotation);
+    gtransform_concat(&moon, &moon, &earth);
+
+    gdamage_tracker_update(&tracker, Sun, GRect(-30, -30, 61, 61), &sun);
+    gdamage_tracker_update(&tracker, Earth, GRect(-10, -10, 21, 21), &earth);
+    gdamage_tracker_update(&tracker, Moon, GRect(-4, -4, 9, 9), &moon);
+    if (frame > 0) {
+      const uint32_t area = gdamage_tracker_get_area(&tracker);
+      total += area;
+      most = (area > most) ? area : most;
+      unit_check(!gdamage_tracker_object_is_damaged(&tracker, Sun) ||
+                 gdamage_tracker_intersects(&tracker, s_objects[Earth].bounds) ||
+                 gdamage_tracker_intersects(&tracker, s_objects[Moon].bounds));
+    }
+    gdamage_tracker_begin_frame(&tracker);
+  }
+
+  const uint32_t average = total / (num_frames - 1);
+  printf("pixels redrawn per frame: average %u, most %u, full screen %u\n",
+         (unsigned)average, (unsigned)most, (unsigned)SCREEN_AREA);
+  unit_check(average < SCREEN_AREA / 4);
+  unit_check(most < SCREEN_AREA / 2);
+}
+
+int main(void) {
+  unit_run(test_init);
+  unit_run(test_set_bounds);
+  unit_run(test_merge);
+  unit_run(test_update);
+  unit_run(test_report);
+  return unit_report();
+}
@@ -0,0 +1,342 @@
+#include <pebble.h>
+
+#include "gdraw_precise.h"
+#include "unit.h"
+
+#include <string.h>
+
+#define DEST_W 64
+#define DEST_H 64
+
+#define BLACK 0xc0
+#define WHITE 0xff
+
+static GBitmap *prv_create_canvas(GBitmapFormat format) {
+  GBitmap *bitmap = gbitmap_create_blank(GSize(DEST_W, DEST_H), format);
+  if (format == GBitmapFormat8Bit) {
+    memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  }
+  return bitmap;
+}
+
+// Coverage of an 8-bit pixel drawn white over black, from 0 to 3
+static int prv_level(const GBitmap *bitmap, int x, int y) {
+  return unit_get_pixel(bitmap, x, y) & 3;
+}
+
+static GPointPrecise prv_point(double x, double y) {
+  return GPointPrecise((int16_t)lround(x * 8), (int16_t)lround(y * 8));
+}
+
+static GRect prv_bounds(void) {
+  return GRect(0, 0, DEST_W, DEST_H);
+}
+
+static void test_rounding(void) {
+  const GPointPrecise pointP = GPointPrecise(8 * 10 + 3, -(8 * 4 + 4));
+  const GPoint rounded = GPointFromGPointPreciseRounded(pointP);
+  const GPoint truncated = GPointFromGPointPrecise(pointP);
+  unit_check((rounded.x == 10) && (rounded.y == -4));
+  unit_check((truncated.x == 10) && (truncated.y == -5));
+
+  const GPoint up = GPointFromGPointPreciseRounded(GPointPrecise(8 * 10 + 4, 8 * 3 + 5));
+  unit_check((up.x == 11) && (up.y == 4));
+
+  const GVector vector = GVectorFromGVectorPreciseRounded(GVectorPrecise(-3, 13));
+  unit_check((vector.dx == 0) && (vector.dy == 2));
+}
+
+static void test_line(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+
+  // A line between pixel centers covers exactly its pixels, anti-aliased or not
+  for (int aa = 0; aa < 2; aa++) {
+    memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+    unit_check(gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(2, 5), prv_point(9, 5),
+                                         WHITE, aa));
+    for (int y = 0; y < DEST_H; y++) {
+      for (int x = 0; x < DEST_W; x++) {
+        const bool on = (y == 5) && (x >= 2) && (x <= 9);
+        unit_check(unit_get_pixel(bitmap, x, y) == (on ? WHITE : BLACK));
+      }
+    }
+  }
+
+  // Halfway between two rows, each gets half of the color
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(2, 5.5), prv_point(9, 5.5), WHITE,
+                            true);
+  unit_check(unit_get_pixel(bitmap, 4, 5) == 0xea);
+  unit_check(unit_get_pixel(bitmap, 4, 6) == 0xea);
+  unit_check(unit_get_pixel(bitmap, 4, 7) == BLACK);
+
+  // The same goes for columns of steep lines
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(3.5, 20), prv_point(3.5, 2), WHITE,
+                            true);
+  unit_check((prv_level(bitmap, 3, 10) == 2) && (prv_level(bitmap, 4, 10) == 2));
+  unit_check((prv_level(bitmap, 3, 2) == 2) && (prv_level(bitmap, 3, 20) == 2));
+  unit_check((prv_level(bitmap, 3, 1) == 0) && (prv_level(bitmap, 3, 21) == 0));
+
+  // Without anti-aliasing the nearest row is drawn
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(2, 5.5), prv_point(9, 5.5), WHITE,
+                            false);
+  gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(2, 10.375), prv_point(9, 10.375),
+                            WHITE, false);
+  unit_check((unit_get_pixel(bitmap, 4, 6) == WHITE) && (unit_get_pixel(bitmap, 4, 5) == BLACK));
+  unit_check((unit_get_pixel(bitmap, 4, 10) == WHITE) && (unit_get_pixel(bitmap, 4, 11) == BLACK));
+
+  gbitmap_destroy(bitmap);
+}
+
+// The weight of an anti-aliased line follows every 1/8 px step instead of jumping whole pixels
+static void test_line_subpixel(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+
+  double previous = 0;
+  for (int step = 0; step <= 16; step++) {
+    const double y = 20 + step / 8.0;
+    memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+    gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(4, y), prv_point(40, y + 0.5),
+                              WHITE, true);
+
+    double weight = 0;
+    double moment = 0;
+    for (int row = 0; row < DEST_H; row++) {
+      const int level = prv_level(bitmap, 22, row);
+      weight += level;
+      moment += level * row;
+    }
+    const double centroid = moment / weight;
+    const double expected = y + 0.5 * (22 - 4) / 36.0;
+    unit_check_near(centroid, expected, 0.2);
+    unit_check(centroid >= previous);
+    previous = centroid;
+  }
+
+  gbitmap_destroy(bitmap);
+}
+
+static void test_polygon(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+
+  // Pixels whose centers are inside the rectangle from (1.5, 1.5) to (5.5, 3.5)
+  const GPointPrecise rect[] = {
+    prv_point(1.5, 1.5), prv_point(5.5, 1.5), prv_point(5.5, 3.5), prv_point(1.5, 3.5),
+  };
+  unit_check(gbitmap_fill_polygon_precise(bitmap, prv_bounds(), rect, ARRAY_LENGTH(rect),
+                                          WHITE));
+  int count = 0;
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const bool on = (x >= 2) && (x <= 5) && (y >= 2) && (y <= 3);
+      unit_check(unit_get_pixel(bitmap, x, y) == (on ? WHITE : BLACK));
+      count += (unit_get_pixel(bitmap, x, y) == WHITE);
+    }
+  }
+  unit_check(count == 8);
+
+  // Moving it by 1/8 px moves no pixel until an edge crosses a center
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  const GPointPrecise moved[] = {
+    prv_point(1.625, 1.5), prv_point(5.625, 1.5), prv_point(5.625, 3.5), prv_point(1.625, 3.5),
+  };
+  gbitmap_fill_polygon_precise(bitmap, prv_bounds(), moved, ARRAY_LENGTH(moved), WHITE);
+  unit_check((unit_get_pixel(bitmap, 2, 2) == WHITE) && (unit_get_pixel(bitmap, 6, 2) == BLACK));
+
+  // The outline goes through every corner
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  const GPointPrecise triangle[] = { prv_point(10, 10), prv_point(30, 12), prv_point(18, 40) };
+  unit_check(gbitmap_draw_polygon_precise(bitmap, prv_bounds(), triangle,
+                                          ARRAY_LENGTH(triangle), WHITE, false));
+  unit_check(unit_get_pixel(bitmap, 10, 10) == WHITE);
+  unit_check(unit_get_pixel(bitmap, 30, 12) == WHITE);
+  unit_check(unit_get_pixel(bitmap, 18, 40) == WHITE);
+  unit_check(unit_get_pixel(bitmap, 20, 20) == BLACK);
+
+  GPointPrecise many[GDRAW_PRECISE_MAX_POLYGON_POINTS + 1] = { { { 0 }, { 0 } } };
+  unit_check(!gbitmap_fill_polygon_precise(bitmap, prv_bounds(), many, ARRAY_LENGTH(many),
+                                           WHITE));
+  unit_check(!gbitmap_fill_polygon_precise(bitmap, prv_bounds(), NULL, 3, WHITE));
+
+  gbitmap_destroy(bitmap);
+}
+
+static void test_circle_fill(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+  const double cx = 30.375;
+  const double cy = 28.625;
+  const double r = 17.25;
+
+  // Pixels are inside exactly when their centers are, except for centers right on the edge
+  gbitmap_fill_circle_precise(bitmap, prv_bounds(), prv_point(cx, cy),
+                              (Fixed_S16_3){ (int16_t)(r * 8) }, WHITE, false);
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const double d = sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy));
+      if (fabs(d - r) > 0.05) {
+        unit_check(unit_get_pixel(bitmap, x, y) == ((d < r) ? WHITE : BLACK));
+      }
+    }
+  }
+
+  // Anti-aliased, the coverage adds up to the area of the circle
+  memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+  gbitmap_fill_circle_precise(bitmap, prv_bounds(), prv_point(cx, cy),
+                              (Fixed_S16_3){ (int16_t)(r * 8) }, WHITE, true);
+  double area = 0;
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const double d = sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy));
+      area += prv_level(bitmap, x, y) / 3.0;
+      if (d < r - 0.5) {
+        unit_check(unit_get_pixel(bitmap, x, y) == WHITE);
+      } else if (d > r + 0.5) {
+        unit_check(unit_get_pixel(bitmap, x, y) == BLACK);
+      }
+    }
+  }
+  unit_check_near(area / (M_PI * r * r), 1.0, 0.03);
+
+  gbitmap_destroy(bitmap);
+}
+
+static void test_circle_outline(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+  const double cx = 31.5;
+  const double cy = 30.125;
+  const double r = 12.625;
+
+  for (int aa = 0; aa < 2; aa++) {
+    memset(gbitmap_get_data(bitmap), BLACK, gbitmap_get_bytes_per_row(bitmap) * DEST_H);
+    unit_check(gbitmap_draw_circle_precise(bitmap, prv_bounds(), prv_point(cx, cy),
+                                           (Fixed_S16_3){ (int16_t)(r * 8) }, WHITE, aa));
+    double weight = 0;
+    for (int y = 0; y < DEST_H; y++) {
+      for (int x = 0; x < DEST_W; x++) {
+        if (unit_get_pixel(bitmap, x, y) != BLACK) {
+          const double d = sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy));
+          unit_check(fabs(d - r) < (aa ? 1.0 : 0.51));
+          weight += prv_level(bitmap, x, y) / 3.0;
+        }
+      }
+    }
+    // Either way the outline is about one pixel wide
+    unit_check_near(weight / (2 * M_PI * r), 1.0, 0.1);
+  }
+
+  gbitmap_destroy(bitmap);
+}
+
+static void test_clip(void) {
+  GBitmap *bitmap = prv_create_canvas(GBitmapFormat8Bit);
+  const GRect clip = GRect(10, 12, 20, 15);
+
+  gbitmap_fill_circle_precise(bitmap, clip, prv_point(20, 20), (Fixed_S16_3){ 8 * 30 }, WHITE,
+                              true);
+  gbitmap_draw_line_precise(bitmap, clip, prv_point(-100, 0), prv_point(100, 60), WHITE, true);
+  const GPointPrecise quad[] = {
+    prv_point(-50, -50), prv_point(200, -50), prv_point(200, 200), prv_point(-50, 200),
+  };
+  gbitmap_fill_polygon_precise(bitmap, clip, quad, ARRAY_LENGTH(quad), WHITE);
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const bool inside = (x >= clip.origin.x) && (x < clip.origin.x + clip.size.w) &&
+                          (y >= clip.origin.y) && (y < clip.origin.y + clip.size.h);
+      unit_check(unit_get_pixel(bitmap, x, y) == (inside ? WHITE : BLACK));
+    }
+  }
+
+  // Shapes far outside of the bitmap are skipped
+  unit_check(gbitmap_draw_line_precise(bitmap, prv_bounds(), prv_point(-1000, -1000),
+                                       prv_point(1000, -900), WHITE, true));
+
+  gbitmap_destroy(bitmap);
+}
+
+static void test_formats(void) {
+  GBitmap *bitmap_8bit = prv_create_canvas(GBitmapFormat8Bit);
+  GBitmap *bitmap_1bit = prv_create_canvas(GBitmapFormat1Bit);
+
+  // 1-bit bitmaps get the pixels that are at least half covered
+  gbitmap_fill_circle_precise(bitmap_8bit, prv_bounds(), prv_point(20.5, 21), (Fixed_S16_3){ 100 },
+                              WHITE, false);
+  gbitmap_fill_circle_precise(bitmap_1bit, prv_bounds(), prv_point(20.5, 21), (Fixed_S16_3){ 100 },
+                              1, true);
+  gbitmap_draw_line_precise(bitmap_8bit, prv_bounds(), prv_point(40, 3), prv_point(60, 50), WHITE,
+                            false);
+  gbitmap_draw_line_precise(bitmap_1bit, prv_bounds(), prv_point(40, 3), prv_point(60, 50), 1,
+                            true);
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      unit_check((unit_get_pixel(bitmap_8bit, x, y) == WHITE) == unit_get_pixel(bitmap_1bit, x, y));
+    }
+  }
+
+  // 0 clears pixels
+  gbitmap_fill_circle_precise(bitmap_1bit, prv_bounds(), prv_point(20.5, 21), (Fixed_S16_3){ 100 },
+                              0, false);
+  unit_check(unit_get_pixel(bitmap_1bit, 20, 21) == 0);
+
+  GBitmap *palette = gbitmap_create_blank(GSize(DEST_W, DEST_H), GBitmapFormat2BitPalette);
+  unit_check(!gbitmap_draw_line_precise(palette, prv_bounds(), prv_point(0, 0), prv_point(5, 5),
+                                        1, false));
+  unit_check(!gbitmap_fill_circle_precise(NULL, prv_bounds(), prv_point(0, 0),
+                                          (Fixed_S16_3){ 8 }, 1, false));
+
+  gbitmap_destroy(palette);
+  gbitmap_destroy(bitmap_1bit);
+  gbitmap_destroy(bitmap_8bit);
+}
+
+static void test_graphics_context(void) {
+  GBitmap *framebuffer = prv_create_canvas(GBitmapFormat8Bit);
+  GBitmap *expected = prv_create_canvas(GBitmapFormat8Bit);
+  GContext *ctx = graphics_context_create_for_bitmap(framebuffer);
+
+  const GPointPrecise triangle[] = { prv_point(3, 4), prv_point(50, 9.5), prv_point(20, 60.25) };
+  unit_check(framebuffer_fill_polygon_precise(ctx, triangle, ARRAY_LENGTH(triangle), 0xf0));
+  unit_check(framebuffer_draw_polygon_precise(ctx, triangle, ARRAY_LENGTH(triangle), WHITE, true));
+  unit_check(framebuffer_fill_circle_precise(ctx, prv_point(40, 40), (Fixed_S16_3){ 80 }, 0xcc,
+                                             true));
+  unit_check(framebuffer_draw_circle_precise(ctx, prv_point(40, 40), (Fixed_S16_3){ 80 }, WHITE,
+                                             false));
+  unit_check(framebuffer_draw_line_precise(ctx, prv_point(0, 63), prv_point(63, 0), 0xc3, true));
+
+  gbitmap_fill_polygon_precise(expected, prv_bounds(), triangle, ARRAY_LENGTH(triangle), 0xf0);
+  gbitmap_draw_polygon_precise(expected, prv_bounds(), triangle, ARRAY_LENGTH(triangle), WHITE,
+                               true);
+  gbitmap_fill_circle_precise(expected, prv_bounds(), prv_point(40, 40), (Fixed_S16_3){ 80 },
+                              0xcc, true);
+  gbitmap_draw_circle_precise(expected, prv_bounds(), prv_point(40, 40), (Fixed_S16_3){ 80 },
+                              WHITE, false);
+  gbitmap_draw_line_precise(expected, prv_bounds(), prv_point(0, 63), prv_point(63, 0), 0xc3,
+                            true);
+  unit_check(memcmp(gbitmap_get_data(framebuffer), gbitmap_get_data(expected),
+                    gbitmap_get_bytes_per_row(expected) * DEST_H) == 0);
+
+  // Every call released the framebuffer
+  GBitmap *captured = graphics_capture_frame_buffer(ctx);
+  unit_check(captured == framebuffer);
+  unit_check(!framebuffer_draw_line_precise(ctx, prv_point(0, 0), prv_point(1, 1), WHITE, false));
+  graphics_release_frame_buffer(ctx, captured);
+  unit_check(!framebuffer_draw_line_precise(NULL, prv_point(0, 0), prv_point(1, 1), WHITE, false));
+
+  graphics_context_destroy(ctx);
+  gbitmap_destroy(expected);
+  gbitmap_destroy(framebuffer);
+}
+
+int main(void) {
+  unit_run(test_rounding);
+  unit_run(test_line);
+  unit_run(test_line_subpixel);
+  unit_run(test_polygon);
+  unit_run(test_circle_fill);
+  unit_run(test_circle_outline);
+  unit_run(test_clip);
+  unit_run(test_formats);
+  unit_run(test_graphics_context);
+  return unit_report();
+}
@@ -0,0 +1,146 @@
+#include <pebble.h>
+
+#include "gbitmap_transform.h"
+#include "unit.h"
+
+#include <string.h>
+
+#define DEST_W 144
+#define DEST_H 168
+
+static void prv_set_pixel(GBitmap *bitmap, int x, int y, uint8_t value) {
+  uint8_t *row = gbitmap_get_data(bitmap) + y * gbitmap_get_bytes_per_row(bitmap);
+  if (gbitmap_get_format(bitmap) == GBitmapFormat1Bit) {
+    row[x / 8] = (row[x / 8] & ~(1 << (x % 8))) | ((value & 1) << (x % 8));
+  } else {
+    row[x] = value;
+  }
+}
+
+static GBitmap *prv_create_pattern(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = gbitmap_create_blank(size, format);
+  for (int y = 0; y < size.h; y++) {
+    for (int x = 0; x < size.w; x++) {
+      // Fully opaque 8-bit colors, with a few transparent pixels mixed in
+      const uint8_t color = ((x * 7 + y * 13) % 5 == 0) ? 0x00 : (0xc0 | ((x + y * 3) & 0x3f));
+      prv_set_pixel(bitmap, x, y, (format == GBitmapFormat1Bit) ? ((x ^ y) & 1) : color);
+    }
+  }
+  return bitmap;
+}
+
+// Straightforward per pixel evaluation of the same sampling rule
+static void prv_reference_draw(GBitmap *dest, const GBitmap *src, const GTransform *t) {
+  GTransform t_inv = *t;
+  unit_check(gtransform_invert(&t_inv, &t_inv));
+  const GRect src_bounds = gbitmap_get_bounds(src);
+  const bool is_8bit = (gbitmap_get_format(src) == GBitmapFormat8Bit);
+
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const int64_t x2 = 2 * x + 1;
+      const int64_t y2 = 2 * y + 1;
+      const int32_t u = ((x2 * t_inv.a.raw_value + y2 * t_inv.c.raw_value) >> 1) +
+                        t_inv.tx.raw_value;
+      const int32_t v = ((x2 * t_inv.b.raw_value + y2 * t_inv.d.raw_value) >> 1) +
+                        t_inv.ty.raw_value;
+      const int32_t su = u >> 16;
+      const int32_t sv = v >> 16;
+      if ((su < 0) || (sv < 0) || (su >= src_bounds.size.w) || (sv >= src_bounds.size.h)) {
+        continue;
+      }
+      const uint8_t pixel = unit_get_pixel(src, su, sv);
+      if (is_8bit && !(pixel & 0xc0)) {
+        continue;
+      }
+      prv_set_pixel(dest, x, y, pixel);
+    }
+  }
+}
+
+static void prv_check_matches_reference(GBitmapFormat format, const GTransform *t) {
+  GBitmap *src = prv_create_pattern(GSize(37, 23), format);
+  GBitmap *dest = gbitmap_create_blank(GSize(DEST_W, DEST_H), format);
+  GBitmap *expected = gbitmap_create_blank(GSize(DEST_W, DEST_H), format);
+
+  unit_check(gbitmap_draw_transformed(dest, GRect(0, 0, DEST_W, DEST_H), src, t));
+  prv_reference_draw(expected, src, t);
+  unit_check(memcmp(gbitmap_get_data(dest), gbitmap_get_data(expected),
+                    DEST_H * gbitmap_get_bytes_per_row(dest)) == 0);
+
+  gbitmap_destroy(src);
+  gbitmap_destroy(dest);
+  gbitmap_destroy(expected);
+}
+
+static void test_identity(void) {
+  GBitmap *src = prv_create_pattern(GSize(20, 10), GBitmapFormat8Bit);
+  GBitmap *dest = gbitmap_create_blank(GSize(DEST_W, DEST_H), GBitmapFormat8Bit);
+  GContext *ctx = graphics_context_create_for_bitmap(dest);
+
+  GTransform t = GTransformTranslationFromNumber(5, 7);
+  unit_check(framebuffer_draw_bitmap_transformed(ctx, src, &t));
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const bool inside = (x >= 5) && (x < 25) && (y >= 7) && (y < 17);
+      const uint8_t src_pixel = inside ? unit_get_pixel(src, x - 5, y - 7) : 0;
+      unit_check(unit_get_pixel(dest, x, y) == ((src_pixel & 0xc0) ? src_pixel : 0));
+    }
+  }
+
+  graphics_context_destroy(ctx);
+  gbitmap_destroy(src);
+  gbitmap_destroy(dest);
+}
+
+static void test_clip(void) {
+  GBitmap *src = prv_create_pattern(GSize(20, 20), GBitmapFormat1Bit);
+  GBitmap *dest = gbitmap_create_blank(GSize(DEST_W, DEST_H), GBitmapFormat1Bit);
+
+  GTransform t = GTransformScaleFromNumber(3, 3);
+  unit_check(gbitmap_draw_transformed(dest, GRect(10, 10, 5, 5), src, &t));
+  for (int y = 0; y < DEST_H; y++) {
+    for (int x = 0; x < DEST_W; x++) {
+      const bool inside = (x >= 10) && (x < 15) && (y >= 10) && (y < 15);
+      unit_check(unit_get_pixel(dest, x, y) == (inside ? unit_get_pixel(src, x / 3, y / 3) : 0));
+    }
+  }
+
+  gbitmap_destroy(src);
+  gbitmap_destroy(dest);
+}
+
+static void test_matches_reference(void) {
+  for (int i = 0; i < 200; i++) {
+    const GBitmapFormat format = (i % 2) ? GBitmapFormat1Bit : GBitmapFormat8Bit;
+    GTransform t = GTransformTRS(Fixed_S32_16(unit_random(0x4000, 0x40000)),
+                                 Fixed_S32_16(unit_random(-0x40000, -0x4000)),
+                                 (i % 4 < 2) ? 0 : unit_random(0, TRIG_MAX_ANGLE - 1),
+                                 Fixed_S32_16(unit_random(-20 * 0x10000, 160 * 0x10000)),
+                                 Fixed_S32_16(unit_random(-20 * 0x10000, 180 * 0x10000)));
+    if (i % 8 == 7) {
+      // Add some shear
+      t.b.raw_value += unit_random(-0x8000, 0x8000);
+    }
+    prv_check_matches_reference(format, &t);
+  }
+}
+
+static void test_unsupported(void) {
+  GBitmap *src = gbitmap_create_blank(GSize(4, 4), GBitmapFormat1Bit);
+  GBitmap *dest = gbitmap_create_blank(GSize(DEST_W, DEST_H), GBitmapFormat8Bit);
+  GTransform t = GTransformIdentity();
+  unit_check(!gbitmap_draw_transformed(dest, GRect(0, 0, DEST_W, DEST_H), src, &t));
+  t = GTransformScaleFromNumber(0, 1);
+  unit_check(!gbitmap_draw_transformed(src, GRect(0, 0, 4, 4), src, &t));
+  gbitmap_destroy(src);
+  gbitmap_destroy(dest);
+}
+
+int main(void) {
+  unit_run(test_identity);
+  unit_run(test_clip);
+  unit_run(test_matches_reference);
+  unit_run(test_unsupported);
+  return unit_report();
+}
@@ -0,0 +1,125 @@
+#include <pebble.h>
+
+#include "gpoint_buffer.h"
+#include "unit.h"
+
+#include <stdint.h>
+
+#define NUM_POINTS 101
+#define POINT_RANGE 512
+#define NUM_RANDOM_MATRICES 500
+
+static void prv_random_points(GPoint *points, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    points[i] = GPoint(unit_random(-POINT_RANGE, POINT_RANGE),
+                       unit_random(-POINT_RANGE, POINT_RANGE));
+  }
+}
+
+static void test_create(void) {
+  GPointBufferSoA *buffer = gpoint_buffer_create(NUM_POINTS);
+  unit_check(buffer != NULL);
+  unit_check(buffer->capacity == NUM_POINTS);
+  unit_check(buffer->num_points == 0);
+  unit_check(((uintptr_t)buffer->x % GPOINT_BUFFER_ALIGNMENT) == 0);
+  unit_check(((uintptr_t)buffer->y % GPOINT_BUFFER_ALIGNMENT) == 0);
+  // The arrays must not overlap
+  unit_check(buffer->y >= buffer->x + NUM_POINTS);
+  gpoint_buffer_destroy(buffer);
+
+  gpoint_buffer_destroy(NULL);
+}
+
+static void test_conversion(void) {
+  GPoint points[NUM_POINTS];
+  GPoint points_out[NUM_POINTS];
+  GPointPrecise points_precise[NUM_POINTS];
+  prv_random_points(points, NUM_POINTS);
+
+  GPointBufferSoA *buffer = gpoint_buffer_create(NUM_POINTS);
+  unit_check(gpoint_buffer_set_points(buffer, points, NUM_POINTS));
+  unit_check(buffer->num_points == NUM_POINTS);
+  unit_check(gpoint_buffer_get_points(buffer, points_out, NUM_POINTS) == NUM_POINTS);
+  unit_check(gpoint_buffer_get_points_precise(buffer, points_precise, NUM_POINTS) == NUM_POINTS);
+  for (int i = 0; i < NUM_POINTS; i++) {
+    unit_check((points[i].x == points_out[i].x) && (points[i].y == points_out[i].y));
+    GPointPrecise expected = GPointPreciseFromGPoint(points[i]);
+    unit_check(gpointprecise_equal(&points_precise[i], &expected));
+  }
+
+  // Precise points round trip, and reads are limited by both the buffer and the destination
+  points_precise[0] = GPointPrecise(-3, 5);
+  unit_check(gpoint_buffer_set_points_precise(buffer, points_precise, 10));
+  unit_check(buffer->num_points == 10);
+  unit_check(gpoint_buffer_get_points(buffer, points_out, NUM_POINTS) == 10);
+  unit_check((points_out[0].x == -1) && (points_out[0].y == 0));
+  unit_check(gpoint_buffer_get_points(buffer, points_out, 4) == 4);
+
+  // Too many points are rejected without changing the buffer
+  unit_check(!gpoint_buffer_set_points(buffer, points, NUM_POINTS + 1));
+  unit_check(buffer->num_points == 10);
+  unit_check(!gpoint_buffer_set_points(NULL, points, 1));
+  unit_check(gpoint_buffer_get_points(NULL, points_out, 1) == 0);
+
+  gpoint_buffer_destroy(buffer);
+}
+
+static void test_transform(void) {
+  GPoint points[NUM_POINTS];
+  GPointPrecise points_out[NUM_POINTS];
+  GPointBufferSoA *src = gpoint_buffer_create(NUM_POINTS);
+  GPointBufferSoA *dest = gpoint_buffer_create(NUM_POINTS);
+
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(4 * 0x10000, 200 * 0x10000);
+    // Exercise the per-axis paths as well as the general one
+    switch (i % 6) {
+      case 0: t = GTransformIdentity(); break;
+      case 1: t.a = t.d = GTransformNumberOne; // fallthrough
+      case 2: t.b = t.c = GTransformNumberZero; break;
+      case 3: t.b = t.c = t.tx = t.ty = GTransformNumberZero; break;
+      case 4: t = GTransformScale(GTransformNumberOne, t.d); break;
+      default: break;
+    }
+
+    prv_random_points(points, NUM_POINTS);
+    gpoint_buffer_set_points(src, points, NUM_POINTS);
+    unit_check(gpoint_buffer_transform(dest, src, &t));
+    unit_check(dest->num_points == NUM_POINTS);
+    unit_check(gpoint_buffer_get_points_precise(dest, points_out, NUM_POINTS) == NUM_POINTS);
+    for (int j = 0; j < NUM_POINTS; j++) {
+      GPointPrecise expected = gpoint_transform(points[j], &t);
+      unit_check(gpointprecise_equal(&points_out[j], &expected));
+    }
+
+    // Transforming in place gives the same result as transforming into another buffer
+    unit_check(gpoint_buffer_transform(src, src, &t));
+    for (int j = 0; j < NUM_POINTS; j++) {
+      unit_check(Fixed_S16_3_equal(src->x[j], dest->x[j]));
+      unit_check(Fixed_S16_3_equal(src->y[j], dest->y[j]));
+    }
+  }
+
+  // A NULL matrix is the identity
+  gpoint_buffer_set_points(src, points, NUM_POINTS);
+  unit_check(gpoint_buffer_transform(dest, src, NULL));
+  for (int j = 0; j < NUM_POINTS; j++) {
+    unit_check(Fixed_S16_3_equal(src->x[j], dest->x[j]));
+  }
+
+  // The destination must be able to hold every point
+  GPointBufferSoA *small = gpoint_buffer_create(NUM_POINTS - 1);
+  GTransform t = GTransformIdentity();
+  unit_check(!gpoint_buffer_transform(small, src, &t));
+  gpoint_buffer_destroy(small);
+
+  gpoint_buffer_destroy(src);
+  gpoint_buffer_destroy(dest);
+}
+
+int main(void) {
+  unit_run(test_create);
+  unit_run(test_conversion);
+  unit_run(test_transform);
+  return unit_report();
+}
@@ -0,0 +1,231 @@
+#include <pebble.h>
+
+#include "gparticle_system.h"
+#include "unit.h"
+
+#include <string.h>
+
+#define CAPACITY 2000
+
+// Raw 8-bit pixel values
+#define WHITE 0xff
+#define RED 0xf0
+
+static uint32_t s_storage[GPARTICLE_SYSTEM_STORAGE_WORDS(CAPACITY)];
+
+static GParticleEmitter prv_emitter(int x, int y, int dx, int dy, uint16_t life,
+                                    uint16_t rate) {
+  return (GParticleEmitter) {
+    .x = Fixed_S32_16(x * 0x10000),
+    .y = Fixed_S32_16(y * 0x10000),
+    .dx = Fixed_S32_16(dx * 0x10000),
+    .dy = Fixed_S32_16(dy * 0x10000),
+    .spread = Fixed_S32_16(0),
+    .life = life,
+    .rate = rate,
+  };
+}
+
+//////////////////////////////////////
+/// Tests
+//////////////////////////////////////
+static void test_storage(void) {
+  // The arrays of the largest pool end exactly at the end of its storage
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+  unit_check(system.num_particles == 0);
+  const uint8_t *storage_end = (const uint8_t *)(s_storage + ARRAY_LENGTH(s_storage));
+  unit_check((const uint8_t *)(system.life + CAPACITY) <= storage_end);
+  unit_check((const uint8_t *)(system.life + CAPACITY + 2) > storage_end);
+  unit_check((void *)system.dy < (void *)system.life);
+
+  // An odd capacity still has room for the last life
+  unit_check(GPARTICLE_SYSTEM_STORAGE_WORDS(3) == 14);
+}
+
+static void test_emit(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, 10);
+
+  const GParticleEmitter emitter = prv_emitter(5, 6, 1, -1, 30, 4);
+  unit_check(gparticle_system_emit(&system, &emitter, 7) == 7);
+  unit_check(gparticle_system_emit(&system, &emitter, 7) == 3);
+  unit_check(gparticle_system_emit(&system, &emitter, 7) == 0);
+  unit_check(system.num_particles == 10);
+  unit_check((system.x[9].raw_value == 5 << 16) && (system.dy[9].raw_value == -0x10000));
+
+  gparticle_system_clear(&system);
+  unit_check(system.num_particles == 0);
+
+  // Without a life there is nothing to emit
+  const GParticleEmitter dead = prv_emitter(0, 0, 0, 0, 0, 4);
+  unit_check(gparticle_system_emit(&system, &dead, 5) == 0);
+  unit_check(gparticle_system_emit(&system, NULL, 5) == 0);
+  unit_check(gparticle_system_emit(NULL, &emitter, 5) == 0);
+}
+
+static void test_spread(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+
+  // Velocities are spread evenly within the limit in both directions
+  GParticleEmitter emitter = prv_emitter(0, 0, 2, 0, 10, 0);
+  emitter.spread = Fixed_S32_16(1 << 15);
+  gparticle_system_emit(&system, &emitter, CAPACITY);
+
+  int64_t sum = 0;
+  int32_t min = INT32_MAX;
+  int32_t max = INT32_MIN;
+  for (int i = 0; i < CAPACITY; i++) {
+    const int32_t dx = system.dx[i].raw_value;
+    sum += dx;
+    min = (dx < min) ? dx : min;
+    max = (dx > max) ? dx : max;
+  }
+  unit_check((min >= (2 << 16) - (1 << 15)) && (max < (2 << 16) + (1 << 15)));
+  unit_check((min < (2 << 16) - (1 << 14)) && (max > (2 << 16) + (1 << 14)));
+  unit_check_near(sum / (double)CAPACITY / 65536.0, 2.0, 0.02);
+}
+
+static void test_integration(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, 4);
+  system.ay = Fixed_S32_16(1 << 14);
+
+  // Integration is exact: x = x0 + n*dx and y = y0 + n*dy + n*(n + 1)/2*ay after n frames
+  const GParticleEmitter emitter = prv_emitter(-3, 7, 2, -5, 100, 1);
+  gparticle_system_emit(&system, &emitter, 1);
+  for (int n = 1; n <= 50; n++) {
+    gparticle_system_step(&system, NULL, NULL, NULL, GRect(0, 0, 0, 0), 0);
+    unit_check(system.x[0].raw_value == (-3 + 2 * n) * 0x10000);
+    unit_check(system.y[0].raw_value == ((7 - 5 * n) * 0x10000) + (n * (n + 1) / 2) * (1 << 14));
+  }
+}
+
+static void test_life(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+
+  // With one particle emitted per frame and a life of 10 frames, the system fills up to 9
+  // particles and then stays there, one being removed as the next one comes in
+  const GParticleEmitter emitter = prv_emitter(0, 0, 0, 0, 10, 1);
+  for (int frame = 1; frame <= 30; frame++) {
+    gparticle_system_step(&system, &emitter, NULL, NULL, GRect(0, 0, 0, 0), 0);
+    unit_check(system.num_particles == ((frame < 9) ? frame : 9));
+  }
+
+  // Without the emitter all of them die out
+  for (int frame = 0; frame < 10; frame++) {
+    gparticle_system_step(&system, NULL, NULL, NULL, GRect(0, 0, 0, 0), 0);
+  }
+  unit_check(system.num_particles == 0);
+
+  // A particle with a life of one frame is drawn in the frame it is emitted in, then removed
+  const GParticleEmitter spark = prv_emitter(10, 10, 0, 0, 1, 1);
+  unit_check(gparticle_system_step(&system, &spark, NULL, NULL, GRect(0, 0, 144, 168), 0) == 1);
+  unit_check(system.num_particles == 0);
+
+  // The pool never grows beyond its capacity
+  const GParticleEmitter fountain = prv_emitter(0, 0, 0, 0, 1000, 300);
+  for (int frame = 0; frame < 10; frame++) {
+    gparticle_system_step(&system, &fountain, NULL, NULL, GRect(0, 0, 0, 0), 0);
+  }
+  unit_check(system.num_particles == CAPACITY);
+}
+
+static void test_camera_and_cull(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+
+  // Particles along the x-axis, 1 px apart; the camera scales them by 2 and moves them down.
+  // Those that land outside the 144 px wide screen are counted out but stay alive.
+  for (int i = 0; i < 100; i++) {
+    const GParticleEmitter emitter = prv_emitter(i - 20, 0, 0, 0, 10, 0);
+    gparticle_system_emit(&system, &emitter, 1);
+  }
+  GTransform camera = GTransformScaleFromNumber(2, 2);
+  camera.ty = GTransformNumberFromNumber(50);
+
+  GBitmap *screen = gbitmap_create_blank(GSize(144, 168), GBitmapFormat8Bit);
+  memset(gbitmap_get_data(screen), 0, 144 * 168);
+  const uint16_t visible = gparticle_system_step(&system, NULL, &camera, screen,
+                                                 GRect(0, 0, 200, 200), WHITE);
+  unit_check(visible == 72);
+  unit_check(system.num_particles == 100);
+
+  const uint8_t *row = gbitmap_get_data(screen) + 50 * gbitmap_get_bytes_per_row(screen);
+  for (int x = 0; x < 144; x++) {
+    unit_check(row[x] == ((x % 2) ? 0 : WHITE));
+  }
+  int num_set = 0;
+  for (int i = 0; i < 144 * 168; i++) {
+    num_set += (gbitmap_get_data(screen)[i] != 0);
+  }
+  unit_check(num_set == 72);
+
+  // Particles far off screen are culled rather than wrapped around onto it
+  gparticle_system_clear(&system);
+  const GParticleEmitter far = prv_emitter(8192 + 10, 10, 0, 0, 10, 1);
+  unit_check(gparticle_system_step(&system, &far, NULL, NULL, GRect(0, 0, 144, 168), 0) == 0);
+  gbitmap_destroy(screen);
+}
+
+static void test_1bit(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+
+  GBitmap *screen = gbitmap_create_blank(GSize(144, 168), GBitmapFormat1Bit);
+  const uint16_t bytes_per_row = gbitmap_get_bytes_per_row(screen);
+  memset(gbitmap_get_data(screen), 0xff, bytes_per_row * 168);
+
+  // A particle that moves right by 1 px per frame clears one pixel per frame
+  const GParticleEmitter emitter = prv_emitter(10, 20, 1, 0, 100, 0);
+  gparticle_system_emit(&system, &emitter, 1);
+  for (int frame = 0; frame < 3; frame++) {
+    unit_check(gparticle_system_step(&system, NULL, NULL, screen, GRect(0, 0, 144, 168), 0) == 1);
+  }
+  const uint8_t *row = gbitmap_get_data(screen) + 20 * bytes_per_row;
+  unit_check(row[1] == (uint8_t)~((1 << 3) | (1 << 4) | (1 << 5)));
+
+  // The clip rectangle limits drawing but particles outside it still move
+  unit_check(gparticle_system_step(&system, NULL, NULL, screen, GRect(0, 0, 14, 168), 0) == 0);
+  unit_check(row[1] & (1 << 6));
+  unit_check(system.x[0].raw_value == 14 << 16);
+  gbitmap_destroy(screen);
+}
+
+static void test_graphics_context(void) {
+  GParticleSystem system;
+  gparticle_system_init(&system, s_storage, CAPACITY);
+
+  GBitmap *screen = gbitmap_create_blank(GSize(144, 168), GBitmapFormat8Bit);
+  memset(gbitmap_get_data(screen), 0, 144 * 168);
+  GContext *ctx = graphics_context_create_for_bitmap(screen);
+
+  const GParticleEmitter emitter = prv_emitter(70, 80, 0, 1, 100, 5);
+  unit_check(framebuffer_step_particle_system(ctx, &system, &emitter, NULL, RED) == 5);
+  unit_check(gbitmap_get_data(screen)[81 * 144 + 70] == RED);
+
+  // The framebuffer is released again, and a context that cannot give it out draws nothing
+  GBitmap *framebuffer = graphics_capture_frame_buffer(ctx);
+  unit_check(framebuffer == screen);
+  unit_check(framebuffer_step_particle_system(ctx, &system, &emitter, NULL, RED) == 0);
+  unit_check(system.num_particles == 5);
+  graphics_release_frame_buffer(ctx, framebuffer);
+  unit_check(framebuffer_step_particle_system(NULL, &system, &emitter, NULL, RED) == 0);
+
+  graphics_context_destroy(ctx);
+  gbitmap_destroy(screen);
+}
+
+int main(void) {
+  unit_run(test_storage);
+  unit_run(test_emit);
+  unit_run(test_spread);
+  unit_run(test_integration);
+  unit_run(test_life);
+  unit_run(test_camera_and_cull);
+  unit_run(test_1bit);
+  unit_run(test_graphics_context);
+  return unit_report();
+}
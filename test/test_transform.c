@@ -0,0 +1,649 @@
+#include <pebble.h>
+
+#include "gtransform.h"
+#include "unit.h"
+
+#include <string.h>
+
+// Coefficients are kept within +/-4.0 and translations within +/-1024 px so that none of the
+// fixed point operations under test overflow; wrapping is outside of what is being verified.
+#define COEFFICIENT_RANGE (4 * 0x10000)
+#define TRANSLATION_RANGE (1024 * 0x10000)
+#define POINT_RANGE 512
+
+#define NUM_RANDOM_MATRICES 10000
+
+//////////////////////////////////////
+/// Double precision reference
+//////////////////////////////////////
+typedef struct RefTransform {
+  double a, b, c, d, tx, ty;
+} RefTransform;
+
+static RefTransform prv_ref_from_transform(const GTransform *t) {
+  return (RefTransform) {
+    unit_number(t->a), unit_number(t->b), unit_number(t->c),
+    unit_number(t->d), unit_number(t->tx), unit_number(t->ty),
+  };
+}
+
+static RefTransform prv_ref_concat(RefTransform t1, RefTransform t2) {
+  return (RefTransform) {
+    .a = t1.a * t2.a + t1.b * t2.c,
+    .b = t1.a * t2.b + t1.b * t2.d,
+    .c = t1.c * t2.a + t1.d * t2.c,
+    .d = t1.c * t2.b + t1.d * t2.d,
+    .tx = t1.tx * t2.a + t1.ty * t2.c + t2.tx,
+    .ty = t1.tx * t2.b + t1.ty * t2.d + t2.ty,
+  };
+}
+
+// Tolerance is given in units of the last place of GTransformNumber
+static void prv_check_transform_near(const GTransform *t, RefTransform ref, double ulps) {
+  const double tolerance = ulps / GTransformNumberOne.raw_value;
+  unit_check_near(unit_number(t->a), ref.a, tolerance);
+  unit_check_near(unit_number(t->b), ref.b, tolerance);
+  unit_check_near(unit_number(t->c), ref.c, tolerance);
+  unit_check_near(unit_number(t->d), ref.d, tolerance);
+  unit_check_near(unit_number(t->tx), ref.tx, tolerance);
+  unit_check_near(unit_number(t->ty), ref.ty, tolerance);
+}
+
+//////////////////////////////////////
+/// Evaluating Transforms
+//////////////////////////////////////
+static void test_classification(void) {
+  GTransform t = GTransformIdentity();
+  unit_check(gtransform_is_identity(&t));
+  unit_check(gtransform_is_only_scale(&t));
+  unit_check(gtransform_is_only_translation(&t));
+  unit_check(gtransform_is_only_scale_or_translation(&t));
+
+  t = GTransformScaleFromNumber(2, 3);
+  unit_check(!gtransform_is_identity(&t));
+  unit_check(gtransform_is_only_scale(&t));
+  unit_check(!gtransform_is_only_translation(&t));
+  unit_check(gtransform_is_only_scale_or_translation(&t));
+
+  t = GTransformTranslationFromNumber(5, -7);
+  unit_check(!gtransform_is_only_scale(&t));
+  unit_check(gtransform_is_only_translation(&t));
+  unit_check(gtransform_is_only_scale_or_translation(&t));
+
+  t = GTransformRotation(TRIG_MAX_ANGLE / 8);
+  unit_check(!gtransform_is_only_scale(&t));
+  unit_check(!gtransform_is_only_translation(&t));
+  unit_check(!gtransform_is_only_scale_or_translation(&t));
+
+  unit_check(!gtransform_is_identity(NULL));
+  unit_check(!gtransform_is_equal(&t, NULL));
+}
+
+//////////////////////////////////////
+/// Modifying Transforms
+//////////////////////////////////////
+static void test_concat(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t1 = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    GTransform t2 = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    RefTransform ref = prv_ref_concat(prv_ref_from_transform(&t1), prv_ref_from_transform(&t2));
+
+    GTransform t_new;
+    gtransform_concat(&t_new, &t1, &t2);
+    // Each coefficient is the sum of two truncated products (plus an exact translation)
+    prv_check_transform_near(&t_new, ref, 2);
+
+    // In place concatenation must give the same result for either operand
+    GTransform t_in_place = t1;
+    gtransform_concat(&t_in_place, &t_in_place, &t2);
+    unit_check(gtransform_is_equal(&t_in_place, &t_new));
+    t_in_place = t2;
+    gtransform_concat(&t_in_place, &t1, &t_in_place);
+    unit_check(gtransform_is_equal(&t_in_place, &t_new));
+  }
+}
+
+static void test_scale(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    GTransformNumber sx = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    GTransformNumber sy = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    RefTransform t_scale = { unit_number(sx), 0, 0, unit_number(sy), 0, 0 };
+    RefTransform ref = prv_ref_concat(t_scale, prv_ref_from_transform(&t));
+
+    GTransform t_new;
+    gtransform_scale(&t_new, &t, sx, sy);
+    prv_check_transform_near(&t_new, ref, 1);
+  }
+}
+
+static void test_translate(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    GTransformNumber tx = Fixed_S32_16(unit_random(-TRANSLATION_RANGE, TRANSLATION_RANGE));
+    GTransformNumber ty = Fixed_S32_16(unit_random(-TRANSLATION_RANGE, TRANSLATION_RANGE));
+    RefTransform t_translation = { 1, 0, 0, 1, unit_number(tx), unit_number(ty) };
+    RefTransform ref = prv_ref_concat(t_translation, prv_ref_from_transform(&t));
+
+    GTransform t_new;
+    gtransform_translate(&t_new, &t, tx, ty);
+    prv_check_transform_near(&t_new, ref, 2);
+  }
+}
+
+static void test_rotation(void) {
+  for (int32_t angle = 0; angle < TRIG_MAX_ANGLE; angle++) {
+    const double radians = angle * (2 * M_PI) / TRIG_MAX_ANGLE;
+    RefTransform ref = { cos(radians), -sin(radians), sin(radians), cos(radians), 0, 0 };
+    GTransform t = GTransformRotation(angle);
+    // One unit of TRIG_MAX_RATIO from the lookup table plus truncation of the division
+    prv_check_transform_near(&t, ref, 3);
+  }
+}
+
+static void test_rotation_cached(void) {
+  const int32_t table_step = TRIG_MAX_ANGLE >> GTRANSFORM_ROTATION_TABLE_BITS;
+  for (int32_t angle = -TRIG_MAX_ANGLE; angle < 2 * TRIG_MAX_ANGLE; angle++) {
+    GTransform t = GTransformRotation(angle);
+    GTransform t_cached = GTransformRotationCached(angle);
+    RefTransform ref = prv_ref_from_transform(&t);
+    if (angle % table_step == 0) {
+      unit_check(gtransform_is_equal(&t_cached, &t));
+    } else {
+      prv_check_transform_near(&t_cached, ref, 2);
+    }
+  }
+
+  GTransform t = GTransformScaleFromNumber(2, 0.5);
+  GTransform t_rotated;
+  GTransform t_rotated_cached;
+  gtransform_rotate(&t_rotated, &t, TRIG_MAX_ANGLE / 4);
+  gtransform_rotate_cached(&t_rotated_cached, &t, TRIG_MAX_ANGLE / 4);
+  unit_check(gtransform_is_equal(&t_rotated, &t_rotated_cached));
+}
+
+static void test_rotate(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    int32_t angle = unit_random(0, TRIG_MAX_ANGLE - 1);
+    GTransform t_rotation = GTransformRotation(angle);
+    RefTransform ref = prv_ref_concat(prv_ref_from_transform(&t_rotation),
+                                      prv_ref_from_transform(&t));
+
+    GTransform t_new;
+    gtransform_rotate(&t_new, &t, angle);
+    prv_check_transform_near(&t_new, ref, 2);
+  }
+}
+
+static void test_trs(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransformNumber sx = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    GTransformNumber sy = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    GTransformNumber tx = Fixed_S32_16(unit_random(-TRANSLATION_RANGE, TRANSLATION_RANGE));
+    GTransformNumber ty = Fixed_S32_16(unit_random(-TRANSLATION_RANGE, TRANSLATION_RANGE));
+    int32_t angle = unit_random(0, TRIG_MAX_ANGLE - 1);
+
+    // The closed form must match the chain of concatenations it replaces bit for bit
+    GTransform t_scale = GTransformScale(sx, sy);
+    GTransform t_rotation = GTransformRotationCached(angle);
+    GTransform t_translation = GTransformTranslation(tx, ty);
+    GTransform expected;
+    gtransform_concat(&expected, &t_scale, &t_rotation);
+    gtransform_concat(&expected, &expected, &t_translation);
+
+    GTransform t = GTransformTRS(sx, sy, angle, tx, ty);
+    unit_check(gtransform_is_equal(&t, &expected));
+  }
+}
+
+// Checks that the pivot is a fixed point of the transform, allowing for the three truncated
+// terms of gpoint_transform
+static void prv_check_pivot_fixed(const GTransform *t, GPoint pivot) {
+  GPointPrecise pointP = gpoint_transform(pivot, t);
+  GPointPrecise expected = GPointPreciseFromGPoint(pivot);
+  unit_check_near(pointP.x.raw_value, expected.x.raw_value, 3);
+  unit_check_near(pointP.y.raw_value, expected.y.raw_value, 3);
+}
+
+static void test_about_point(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GPoint pivot = GPoint(unit_random(-POINT_RANGE, POINT_RANGE),
+                          unit_random(-POINT_RANGE, POINT_RANGE));
+    int32_t angle = unit_random(0, TRIG_MAX_ANGLE - 1);
+    GTransformNumber sx = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    GTransformNumber sy = Fixed_S32_16(unit_random(-COEFFICIENT_RANGE, COEFFICIENT_RANGE));
+    GTransformNumber p_x = GTransformNumberFromNumber(pivot.x);
+    GTransformNumber p_y = GTransformNumberFromNumber(pivot.y);
+    GTransformNumber p_x_neg = GTransformNumberFromNumber(-pivot.x);
+    GTransformNumber p_y_neg = GTransformNumberFromNumber(-pivot.y);
+
+    GTransform t = GTransformIdentity();
+    gtransform_rotate_about_point(&t, &t, angle, pivot);
+    prv_check_pivot_fixed(&t, pivot);
+
+    // Compare against translating to the origin, rotating and translating back
+    GTransform expected = GTransformTranslation(p_x_neg, p_y_neg);
+    GTransform t_rotation = GTransformRotationCached(angle);
+    GTransform t_translation = GTransformTranslation(p_x, p_y);
+    gtransform_concat(&expected, &expected, &t_rotation);
+    gtransform_concat(&expected, &expected, &t_translation);
+    prv_check_transform_near(&t, prv_ref_from_transform(&expected), 2);
+
+    t = GTransformIdentity();
+    gtransform_scale_about_point(&t, &t, sx, sy, pivot);
+    prv_check_pivot_fixed(&t, pivot);
+
+    expected = GTransformTranslation(p_x_neg, p_y_neg);
+    GTransform t_scale = GTransformScale(sx, sy);
+    gtransform_concat(&expected, &expected, &t_scale);
+    gtransform_concat(&expected, &expected, &t_translation);
+    prv_check_transform_near(&t, prv_ref_from_transform(&expected), 0);
+  }
+}
+
+static void test_invert(void) {
+  int num_inverted = 0;
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    RefTransform r = prv_ref_from_transform(&t);
+    const double det = r.a * r.d - r.b * r.c;
+
+    GTransform t_inv;
+    if (!gtransform_invert(&t_inv, &t)) {
+      // Only matrices whose inverse does not fit in 16.16 may be rejected. With the ranges
+      // used here the inverted translation can reach 2^15 only once |det| drops below
+      // 2 * 4 * 1024 / 2^15.
+      unit_check(fabs(det) < 0.25);
+      continue;
+    }
+    num_inverted++;
+
+    RefTransform ref = {
+      r.d / det, -r.b / det, -r.c / det, r.a / det,
+      (r.c * r.ty - r.d * r.tx) / det, (r.b * r.tx - r.a * r.ty) / det,
+    };
+    // Correctly rounded; the extra margin only absorbs error in the double reference itself
+    prv_check_transform_near(&t_inv, ref, 0.5 + 1e-6);
+  }
+  unit_check(num_inverted > NUM_RANDOM_MATRICES * 9 / 10);
+
+  GTransform t = GTransformScaleFromNumber(0, 1);
+  GTransform t_inv;
+  unit_check(!gtransform_invert(&t_inv, &t));
+  unit_check(gtransform_is_equal(&t_inv, &t));
+
+  t = GTransformScale(Fixed_S32_16(1), Fixed_S32_16(1));
+  unit_check(!gtransform_invert(&t_inv, &t));
+
+  t = GTransformScaleFromNumber(2, 4);
+  gtransform_translate_number(&t, &t, 10, -20);
+  unit_check(gtransform_invert(&t, &t));
+  GTransform expected = GTransformFromNumbers(0.5, 0, 0, 0.25, -10, 20);
+  unit_check(gtransform_is_equal(&t, &expected));
+
+  // Mapping a point back is the same as applying the inverse matrix
+  const GPointPrecise pointP = GPointPrecise(-93, 1234);
+  GPointPrecise mapped = GPointPrecise(0, 0);
+  t = GTransformScaleFromNumber(2, 4);
+  gtransform_translate_number(&t, &t, 10, -20);
+  gtransform_invert(&t_inv, &t);
+  const GPointPrecise inverted = gpointprecise_transform(pointP, &t_inv);
+  unit_check(gpointprecise_inverse_transform(&mapped, pointP, &t));
+  unit_check((mapped.x.raw_value == inverted.x.raw_value) &&
+             (mapped.y.raw_value == inverted.y.raw_value));
+
+  // A prepared inverse maps the point back the same way
+  GTransformInverse inverse;
+  unit_check(gtransform_prepare_inverse(&inverse, &t));
+  mapped = GPointPrecise(0, 0);
+  unit_check(gpointprecise_inverse_transform_prepared(&mapped, pointP, &inverse));
+  unit_check((mapped.x.raw_value == inverted.x.raw_value) &&
+             (mapped.y.raw_value == inverted.y.raw_value));
+
+  t = GTransformScaleFromNumber(0, 1);
+  unit_check(!gpointprecise_inverse_transform(&mapped, pointP, &t));
+  unit_check((mapped.x.raw_value == inverted.x.raw_value) &&
+             (mapped.y.raw_value == inverted.y.raw_value));
+  unit_check(!gtransform_prepare_inverse(&inverse, &t));
+  unit_check(!gpointprecise_inverse_transform_prepared(&mapped, pointP, &inverse));
+  unit_check((mapped.x.raw_value == inverted.x.raw_value) &&
+             (mapped.y.raw_value == inverted.y.raw_value));
+}
+
+//////////////////////////////////////
+/// Applying Transformations
+//////////////////////////////////////
+// Each of the three terms of a coordinate is truncated towards negative infinity, so the
+// result is never above the exact value and is less than three units of 1/8 px below it.
+static void prv_check_point_transform(const GTransform *t, const RefTransform *r) {
+  for (int y = -POINT_RANGE; y < POINT_RANGE; y++) {
+    for (int x = -POINT_RANGE; x < POINT_RANGE; x++) {
+      GPointPrecise pointP = gpoint_transform(GPoint(x, y), t);
+      const double scale = 1 << GPOINT_PRECISE_PRECISION;
+      const double ref_x = (x * r->a + y * r->c + r->tx) * scale;
+      const double ref_y = (x * r->b + y * r->d + r->ty) * scale;
+      unit_check((pointP.x.raw_value <= ref_x) && (ref_x - pointP.x.raw_value < 3));
+      unit_check((pointP.y.raw_value <= ref_y) && (ref_y - pointP.y.raw_value < 3));
+    }
+  }
+}
+
+static void test_point_transform(void) {
+  GTransform t = GTransformIdentity();
+  RefTransform r = prv_ref_from_transform(&t);
+  prv_check_point_transform(&t, &r);
+
+  t = GTransformScaleFromNumber(1.5, 0.25);
+  r = prv_ref_from_transform(&t);
+  prv_check_point_transform(&t, &r);
+
+  t = GTransformTranslationFromNumber(-100.5, 33.125);
+  r = prv_ref_from_transform(&t);
+  prv_check_point_transform(&t, &r);
+
+  for (int32_t angle = 0; angle < TRIG_MAX_ANGLE; angle += TRIG_MAX_ANGLE / 16) {
+    t = GTransformRotation(angle);
+    gtransform_translate_number(&t, &t, 72, 84);
+    r = prv_ref_from_transform(&t);
+    prv_check_point_transform(&t, &r);
+  }
+
+  GPoint point = GPoint(-12, 34);
+  GPointPrecise pointP = gpoint_transform(point, NULL);
+  GPointPrecise expected = GPointPreciseFromGPoint(point);
+  unit_check(gpointprecise_equal(&pointP, &expected));
+}
+
+static void test_vector_transform(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    GVector vector = GVector(unit_random(-POINT_RANGE, POINT_RANGE),
+                             unit_random(-POINT_RANGE, POINT_RANGE));
+    GPointPrecise pointP = gpoint_transform(GPoint(vector.dx, vector.dy), &t);
+    GVectorPrecise vectorP = gvector_transform(vector, &t);
+    unit_check(vectorP.dx.raw_value == pointP.x.raw_value);
+    unit_check(vectorP.dy.raw_value == pointP.y.raw_value);
+  }
+}
+
+static void test_point_transform_array(void) {
+  enum { NUM_POINTS = 64 };
+  GPoint points[NUM_POINTS];
+  GVector vectors[NUM_POINTS];
+  GPointPrecise points_out[NUM_POINTS];
+  GVectorPrecise vectors_out[NUM_POINTS];
+
+  for (int i = 0; i < NUM_RANDOM_MATRICES / 10; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    // Exercise each of the specialized kernels as well as the general one
+    switch (i % 5) {
+      case 0: t = GTransformIdentity(); break;
+      case 1: t.a = t.d = GTransformNumberOne; // fallthrough
+      case 2: t.b = t.c = GTransformNumberZero; break;
+      case 3: t.b = t.c = t.tx = t.ty = GTransformNumberZero; break;
+      default: break;
+    }
+
+    for (int j = 0; j < NUM_POINTS; j++) {
+      points[j] = GPoint(unit_random(-POINT_RANGE, POINT_RANGE),
+                         unit_random(-POINT_RANGE, POINT_RANGE));
+      vectors[j] = GVector(points[j].x, points[j].y);
+    }
+
+    // Vary the count so that vectorized kernels also see a scalar tail
+    const int num_points = NUM_POINTS - (i % 7);
+    gpoint_transform_array(points, points_out, num_points, &t);
+    gvector_transform_array(vectors, vectors_out, num_points, &t);
+    GTransformPrepared prepared;
+    gtransform_prepare(&prepared, &t);
+
+    for (int j = 0; j < num_points; j++) {
+      GPointPrecise expected = gpoint_transform(points[j], &t);
+      GPointPrecise prepared_out = gpoint_transform_prepared(points[j], &prepared);
+      GVectorPrecise expected_vector = gvector_transform(vectors[j], &t);
+      unit_check(gpointprecise_equal(&points_out[j], &expected));
+      unit_check(gpointprecise_equal(&prepared_out, &expected));
+      unit_check(gvectorprecise_equal(&vectors_out[j], &expected_vector));
+    }
+  }
+}
+
+static void test_path_transform(void) {
+  enum { MAX_POINTS = 40 };
+  GPoint points[MAX_POINTS];
+  GPoint points_out[MAX_POINTS];
+  GPointPrecise points_precise_out[MAX_POINTS];
+
+  for (int i = 0; i < NUM_RANDOM_MATRICES / 10; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    GPathInfo info = { .num_points = unit_random(1, MAX_POINTS), .points = points };
+    for (uint32_t j = 0; j < info.num_points; j++) {
+      points[j] = GPoint(unit_random(-POINT_RANGE, POINT_RANGE),
+                         unit_random(-POINT_RANGE, POINT_RANGE));
+    }
+
+    GRect bounds;
+    GRect bounds_precise;
+    gpath_info_transform(&info, &t, points_out, &bounds);
+    gpath_info_transform_precise(&info, &t, points_precise_out, &bounds_precise);
+    unit_check(memcmp(&bounds, &bounds_precise, sizeof(GRect)) == 0);
+
+    int16_t min_x = INT16_MAX, min_y = INT16_MAX, max_x = INT16_MIN, max_y = INT16_MIN;
+    for (uint32_t j = 0; j < info.num_points; j++) {
+      GPointPrecise expected = gpoint_transform(points[j], &t);
+      unit_check(gpointprecise_equal(&points_precise_out[j], &expected));
+      GPoint expected_point = GPointFromGPointPrecise(expected);
+      unit_check((points_out[j].x == expected_point.x) && (points_out[j].y == expected_point.y));
+      if (expected_point.x < min_x) { min_x = expected_point.x; }
+      if (expected_point.y < min_y) { min_y = expected_point.y; }
+      if (expected_point.x > max_x) { max_x = expected_point.x; }
+      if (expected_point.y > max_y) { max_y = expected_point.y; }
+    }
+    unit_check((bounds.origin.x == min_x) && (bounds.origin.y == min_y));
+    unit_check((bounds.size.w == max_x - min_x + 1) && (bounds.size.h == max_y - min_y + 1));
+  }
+
+  GPathInfo empty = { .num_points = 0, .points = points };
+  GRect bounds = GRect(1, 2, 3, 4);
+  gpath_info_transform(&empty, NULL, points_out, &bounds);
+  unit_check((bounds.origin.x == 0) && (bounds.size.w == 0) && (bounds.size.h == 0));
+}
+
+static bool prv_grect_contains_precise(const GRect *rect, double x, double y) {
+  return ((x >= rect->origin.x) && (x <= rect->origin.x + rect->size.w) &&
+          (y >= rect->origin.y) && (y <= rect->origin.y + rect->size.h));
+}
+
+static void test_rect_transform_bounds(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    RefTransform r = prv_ref_from_transform(&t);
+    // Corners stay within 320 px so that gpoint_transform does not wrap
+    GRect rect = GRect(unit_random(-POINT_RANGE / 2, POINT_RANGE / 2),
+                       unit_random(-POINT_RANGE / 2, POINT_RANGE / 2),
+                       unit_random(-POINT_RANGE / 8, POINT_RANGE / 8),
+                       unit_random(-POINT_RANGE / 8, POINT_RANGE / 8));
+    GRect bounds = grect_transform_bounds(rect, &t);
+    if ((rect.size.w == 0) || (rect.size.h == 0)) {
+      unit_check((bounds.size.w == 0) && (bounds.size.h == 0));
+      continue;
+    }
+
+    double min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+    for (int corner = 0; corner < 4; corner++) {
+      const int16_t x = rect.origin.x + ((corner & 1) ? rect.size.w : 0);
+      const int16_t y = rect.origin.y + ((corner & 2) ? rect.size.h : 0);
+      const double ref_x = x * r.a + y * r.c + r.tx;
+      const double ref_y = x * r.b + y * r.d + r.ty;
+      GPointPrecise pointP = gpoint_transform(GPoint(x, y), &t);
+      unit_check(prv_grect_contains_precise(&bounds, ref_x, ref_y));
+      unit_check(prv_grect_contains_precise(&bounds, pointP.x.raw_value / 8.0,
+                                            pointP.y.raw_value / 8.0));
+      min_x = fmin(min_x, ref_x);
+      min_y = fmin(min_y, ref_y);
+      max_x = fmax(max_x, ref_x);
+      max_y = fmax(max_y, ref_y);
+    }
+
+    // The bounds are at most one pixel larger than the exact box on each side
+    unit_check(bounds.origin.x > min_x - 2);
+    unit_check(bounds.origin.y > min_y - 2);
+    unit_check(bounds.origin.x + bounds.size.w < max_x + 1);
+    unit_check(bounds.origin.y + bounds.size.h < max_y + 1);
+  }
+
+  GRect rect = GRect(10, 20, -5, 6);
+  GRect bounds = grect_transform_bounds(rect, NULL);
+  unit_check((bounds.origin.x == 5) && (bounds.size.w == 5));
+
+  // Matrices that gpoint_transform applies exactly are not widened, so NULL and the identity agree
+  GTransform t = GTransformIdentity();
+  bounds = grect_transform_bounds(rect, &t);
+  unit_check((bounds.origin.x == 5) && (bounds.origin.y == 20) &&
+             (bounds.size.w == 5) && (bounds.size.h == 6));
+  t = GTransformTranslationFromNumber(-7, 3);
+  bounds = grect_transform_bounds(rect, &t);
+  unit_check((bounds.origin.x == -2) && (bounds.origin.y == 23) &&
+             (bounds.size.w == 5) && (bounds.size.h == 6));
+  t = GTransformFromNumbers(2, 0, 0, 0.5, 0.5, 0);
+  bounds = grect_transform_bounds(rect, &t);
+  unit_check((bounds.origin.x == 10) && (bounds.origin.y == 10) &&
+             (bounds.size.w == 11) && (bounds.size.h == 3));
+}
+
+static void test_rect_cull(void) {
+  enum { NUM_RECTS = 200 };
+  GRect rects[NUM_RECTS];
+  uint8_t visible[(NUM_RECTS + 7) / 8];
+  const GRect clip = GRect(0, 0, 144, 168);
+
+  for (int i = 0; i < NUM_RANDOM_MATRICES / 100; i++) {
+    GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    for (int j = 0; j < NUM_RECTS; j++) {
+      rects[j] = GRect(unit_random(-POINT_RANGE, POINT_RANGE),
+                       unit_random(-POINT_RANGE, POINT_RANGE),
+                       unit_random(0, 40), unit_random(0, 40));
+    }
+
+    size_t num_visible = grect_cull_against(rects, NUM_RECTS, &t, clip, visible);
+    size_t expected_visible = 0;
+    for (int j = 0; j < NUM_RECTS; j++) {
+      GRect bounds = grect_transform_bounds(rects[j], &t);
+      const bool expected = (bounds.size.w > 0) && (bounds.size.h > 0) &&
+                            (bounds.origin.x < clip.size.w) &&
+                            (bounds.origin.x + bounds.size.w > 0) &&
+                            (bounds.origin.y < clip.size.h) &&
+                            (bounds.origin.y + bounds.size.h > 0);
+      unit_check(expected == !!(visible[j / 8] & (1 << (j % 8))));
+      expected_visible += expected;
+    }
+    unit_check(num_visible == expected_visible);
+  }
+}
+
+//////////////////////////////////////
+/// Scanline Iteration
+//////////////////////////////////////
+// Every pixel the iterator reaches has the exact 16.16 coordinates, however long the walk, and
+// rounding them down to 1/8 px gives at most 2/8 px more than gpoint_transform
+static void test_iterator(void) {
+  enum { ROW_LENGTH = 160, NUM_ROWS = 8 };
+  for (int i = 0; i < NUM_RANDOM_MATRICES / 10; i++) {
+    const GTransform t = unit_random_transform(COEFFICIENT_RANGE, TRANSLATION_RANGE);
+    const int16_t x0 = unit_random(-POINT_RANGE / 2, 0);
+    const int16_t y0 = unit_random(-POINT_RANGE / 2, POINT_RANGE / 2 - NUM_ROWS);
+
+    GTransformIterator iter;
+    gtransform_iter_begin(&iter, &t, x0, y0);
+    for (int y = y0; y < y0 + NUM_ROWS; y++, gtransform_iter_next_row(&iter)) {
+      for (int x = x0; x < x0 + ROW_LENGTH; x++, gtransform_iter_next(&iter)) {
+        const int64_t exact_x = (int64_t)x * t.a.raw_value + (int64_t)y * t.c.raw_value +
+                                t.tx.raw_value;
+        const int64_t exact_y = (int64_t)x * t.b.raw_value + (int64_t)y * t.d.raw_value +
+                                t.ty.raw_value;
+        unit_check((iter.x.raw_value == exact_x) && (iter.y.raw_value == exact_y));
+
+        const GPointPrecise pointP = gtransform_iter_get_point(&iter);
+        const GPointPrecise expected = gpoint_transform(GPoint(x, y), &t);
+        unit_check((pointP.x.raw_value - expected.x.raw_value >= 0) &&
+                   (pointP.x.raw_value - expected.x.raw_value <= 2));
+        unit_check((pointP.y.raw_value - expected.y.raw_value >= 0) &&
+                   (pointP.y.raw_value - expected.y.raw_value <= 2));
+
+        const GPoint point = gtransform_iter_get_gpoint(&iter);
+        unit_check((point.x == (exact_x >> 16)) && (point.y == (exact_y >> 16)));
+      }
+    }
+  }
+
+  // A start with a fraction is rounded down once and then carried along unchanged
+  const GTransform t = GTransformRotation(TRIG_MAX_ANGLE / 7);
+  const GPointPrecise startP = GPointPrecise(8 * 10 + 3, 8 * -4 + 5);
+  GTransformIterator iter;
+  gtransform_iter_begin_precise(&iter, &t, startP);
+  const int64_t start_x = (((int64_t)startP.x.raw_value * t.a.raw_value +
+                            (int64_t)startP.y.raw_value * t.c.raw_value) >> 3) + t.tx.raw_value;
+  unit_check(iter.x.raw_value == start_x);
+  for (int x = 0; x < 1000; x++) {
+    gtransform_iter_next(&iter);
+  }
+  unit_check(iter.x.raw_value == start_x + 1000 * (int64_t)t.a.raw_value);
+
+  // Skipping is the same as stepping, in both directions
+  GTransformIterator stepped = iter;
+  gtransform_iter_skip(&iter, 37);
+  for (int x = 0; x < 37; x++) {
+    gtransform_iter_next(&stepped);
+  }
+  unit_check(memcmp(&iter, &stepped, sizeof(iter)) == 0);
+  gtransform_iter_skip(&iter, -1037);
+  unit_check(iter.x.raw_value == start_x);
+  gtransform_iter_next_row(&iter);
+  unit_check(iter.x.raw_value == start_x + t.c.raw_value);
+
+  // Without a matrix the pixels are only converted
+  gtransform_iter_begin(&iter, NULL, -3, 7);
+  gtransform_iter_next(&iter);
+  gtransform_iter_next_row(&iter);
+  const GPoint point = gtransform_iter_get_gpoint(&iter);
+  unit_check((point.x == -3) && (point.y == 8));
+
+  // Stepping past 32768 px wraps the same way as skipping there at once
+  const GTransform t_wide = GTransformScaleFromNumber(1000, 1000);
+  GTransformIterator skipped;
+  gtransform_iter_begin(&iter, &t_wide, 30, 30);
+  gtransform_iter_begin(&skipped, &t_wide, 30, 30);
+  for (int i = 0; i < 5; i++) {
+    gtransform_iter_next(&iter);
+  }
+  gtransform_iter_skip(&skipped, 5);
+  unit_check((iter.x.raw_value == skipped.x.raw_value) &&
+             (iter.y.raw_value == skipped.y.raw_value));
+  unit_check(gtransform_iter_get_gpoint(&iter).x == (int16_t)(35 * 1000));
+  for (int i = 0; i < 5; i++) {
+    gtransform_iter_next_row(&iter);
+  }
+  unit_check(gtransform_iter_get_gpoint(&iter).y == (int16_t)(35 * 1000));
+}
+
+int main(void) {
+  unit_run(test_classification);
+  unit_run(test_concat);
+  unit_run(test_scale);
+  unit_run(test_translate);
+  unit_run(test_rotation);
+  unit_run(test_rotation_cached);
+  unit_run(test_rotate);
+  unit_run(test_trs);
+  unit_run(test_about_point);
+  unit_run(test_invert);
+  unit_run(test_point_transform);
+  unit_run(test_vector_transform);
+  unit_run(test_point_transform_array);
+  unit_run(test_path_transform);
+  unit_run(test_rect_transform_bounds);
+  unit_run(test_rect_cull);
+  unit_run(test_iterator);
+  return unit_report();
+}
@@ -0,0 +1,220 @@
+#include <pebble.h>
+
+#include "gpoint_buffer.h"
+#include "gtransform.h"
+#include "gtransform_checked.h"
+#include "unit.h"
+
+#define NUM_RANDOM_POINTS 20000
+
+#if defined(GTRANSFORM_CHECKED)
+
+static const GTransformCheckedCounters *prv_counters(GTransformCheckedFunction function) {
+  return &gtransform_checked_get_stats()->functions[function];
+}
+
+// Reference for one axis, computed in 64 bits like the fast path on values that fit
+static int16_t prv_transform_axis(int16_t x, int16_t y, Fixed_S32_16 kx, Fixed_S32_16 ky,
+                                  Fixed_S32_16 offset) {
+  return (int16_t)((((int64_t)x * 8 * kx.raw_value) >> 16) +
+                   (((int64_t)y * 8 * ky.raw_value) >> 16) +
+                   ((8 * (int64_t)offset.raw_value) >> 16));
+}
+
+static void test_in_range_matches_fast_path(void) {
+  // Small matrices and points never overflow, so the checked results are the exact ones
+  gtransform_checked_reset_stats();
+  for (int i = 0; i < NUM_RANDOM_POINTS; i++) {
+    const GTransform t = unit_random_transform(2 * 0x10000, 500 * 0x10000);
+    const GPoint p = GPoint(unit_random(-500, 500), unit_random(-500, 500));
+
+    const GPointPrecise expected = GPointPrecise(
+        prv_transform_axis(p.x, p.y, t.a, t.c, t.tx), prv_transform_axis(p.x, p.y, t.b, t.d, t.ty));
+    const GPointPrecise actual = gpoint_transform(p, &t);
+    unit_check(actual.x.raw_value == expected.x.raw_value);
+    unit_check(actual.y.raw_value == expected.y.raw_value);
+  }
+
+  const GTransformCheckedCounters *counters =
+      prv_counters(GTransformCheckedFunctionPointTransform);
+  unit_check(counters->overflows == 0);
+  unit_check(counters->saturations == 0);
+  unit_check(counters->truncations > 0);
+}
+
+static void test_point_saturation(void) {
+  gtransform_checked_reset_stats();
+
+  // The fast path wraps 5000 px to a negative coordinate; checked mode clamps it
+  const GTransform identity = GTransformIdentity();
+  const GPointPrecise pointP = gpoint_transform(GPoint(5000, -5000), &identity);
+  unit_check(pointP.x.raw_value == INT16_MAX);
+  unit_check(pointP.y.raw_value == INT16_MIN);
+
+  const GTransformCheckedCounters *counters =
+      prv_counters(GTransformCheckedFunctionPointTransform);
+  unit_check(counters->saturations == 2);
+  unit_check(counters->overflows == 0);
+}
+
+static void test_point_overflow(void) {
+  gtransform_checked_reset_stats();
+
+  // 3000 px scaled by 4 is far outside of the precise range; one product overflows per axis
+  const GTransform t = GTransformScaleFromNumber(4, -4);
+  const GPointPrecise pointP = gpoint_transform(GPoint(3000, 3000), &t);
+  unit_check(pointP.x.raw_value == INT16_MAX);
+  unit_check(pointP.y.raw_value == INT16_MIN);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransform)->overflows == 2);
+
+  // The array functions count separately and clamp the same way
+  const GPoint in[] = { GPoint(3000, 3000), GPoint(1, 1) };
+  GPointPrecise out[2];
+  gpoint_transform_array(in, out, 2, &t);
+  unit_check(out[0].x.raw_value == INT16_MAX);
+  unit_check(out[0].y.raw_value == INT16_MIN);
+  unit_check(out[1].x.raw_value == 4 * 8);
+  unit_check(out[1].y.raw_value == -4 * 8);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransformArray)->overflows == 2);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransform)->overflows == 2);
+}
+
+static void test_point_buffer(void) {
+  gtransform_checked_reset_stats();
+
+  // The vectorized axis kernels would wrap 8000 px; checked mode clamps like the array functions
+  const GPoint in[] = { GPoint(1000, -1000), GPoint(1, 2) };
+  GPointBufferSoA *buffer = gpoint_buffer_create(2);
+  unit_check(gpoint_buffer_set_points(buffer, in, 2));
+  GTransform t = GTransformScaleFromNumber(8, 8);
+  unit_check(gpoint_buffer_transform(buffer, buffer, &t));
+  GPointPrecise out[2];
+  unit_check(gpoint_buffer_get_points_precise(buffer, out, 2) == 2);
+  unit_check(out[0].x.raw_value == INT16_MAX);
+  unit_check(out[0].y.raw_value == INT16_MIN);
+  unit_check(out[1].x.raw_value == 8 * 8);
+  unit_check(out[1].y.raw_value == 16 * 8);
+  unit_check(prv_counters(GTransformCheckedFunctionPointBufferTransform)->overflows == 2);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransformArray)->overflows == 0);
+
+  // In range, every point matches gpoint_transform and nothing is counted but truncations
+  gtransform_checked_reset_stats();
+  t = unit_random_transform(2 * 0x10000, 500 * 0x10000);
+  unit_check(gpoint_buffer_set_points(buffer, in + 1, 1));
+  unit_check(gpoint_buffer_transform(buffer, buffer, &t));
+  unit_check(gpoint_buffer_get_points_precise(buffer, out, 1) == 1);
+  const GPointPrecise expected = gpoint_transform(in[1], &t);
+  unit_check(out[0].x.raw_value == expected.x.raw_value);
+  unit_check(out[0].y.raw_value == expected.y.raw_value);
+  const GTransformCheckedCounters *counters =
+      prv_counters(GTransformCheckedFunctionPointBufferTransform);
+  unit_check((counters->overflows == 0) && (counters->saturations == 0));
+  gpoint_buffer_destroy(buffer);
+}
+
+static void test_vector_saturation(void) {
+  gtransform_checked_reset_stats();
+
+  const GTransform t = GTransformIdentity();
+  const GVectorPrecise vectorP = gvector_transform(GVector(-6000, 10), &t);
+  unit_check(vectorP.dx.raw_value == INT16_MIN);
+  unit_check(vectorP.dy.raw_value == 10 * 8);
+  unit_check(prv_counters(GTransformCheckedFunctionVectorTransform)->saturations == 1);
+
+  const GVector in[] = { GVector(10, 6000) };
+  GVectorPrecise out[1];
+  gvector_transform_array(in, out, 1, &t);
+  unit_check(out[0].dy.raw_value == INT16_MAX);
+  unit_check(prv_counters(GTransformCheckedFunctionVectorTransformArray)->saturations == 1);
+}
+
+static void test_matrix_overflow(void) {
+  gtransform_checked_reset_stats();
+
+  // 30000 * 30000 does not fit in 16.16
+  const GTransform big = GTransformScaleFromNumber(30000, 30000);
+  GTransform t;
+  gtransform_concat(&t, &big, &big);
+  unit_check(t.a.raw_value == INT32_MAX);
+  unit_check(t.d.raw_value == INT32_MAX);
+  unit_check(prv_counters(GTransformCheckedFunctionConcat)->overflows == 2);
+
+  gtransform_scale(&t, (GTransform *)&big, GTransformNumberFromNumber(-30000),
+                   GTransformNumberFromNumber(2));
+  unit_check(t.a.raw_value == INT32_MIN);
+  unit_check(t.d.raw_value == INT32_MAX);
+  unit_check(prv_counters(GTransformCheckedFunctionScale)->overflows == 2);
+
+  gtransform_translate(&t, (GTransform *)&big, GTransformNumberFromNumber(30000),
+                       GTransformNumberFromNumber(0));
+  unit_check(t.tx.raw_value == INT32_MAX);
+  unit_check(t.ty.raw_value == 0);
+  unit_check(prv_counters(GTransformCheckedFunctionTranslate)->overflows == 1);
+}
+
+static void test_truncation(void) {
+  gtransform_checked_reset_stats();
+
+  // Multiplying by a half drops the lowest bit of odd values only
+  const GTransform half = GTransformScale(GTransformNumberFromNumber(0.5),
+                                          GTransformNumberFromNumber(0.5));
+  gpointprecise_transform(GPointPrecise(2, 4), &half);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransform)->truncations == 0);
+  gpointprecise_transform(GPointPrecise(3, 4), &half);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransform)->truncations == 1);
+}
+
+static void test_reset(void) {
+  const GTransform identity = GTransformIdentity();
+  gpoint_transform(GPoint(5000, 0), &identity);
+  unit_check(prv_counters(GTransformCheckedFunctionPointTransform)->saturations > 0);
+
+  gtransform_checked_reset_stats();
+  const GTransformCheckedStats *stats = gtransform_checked_get_stats();
+  for (int i = 0; i < GTransformCheckedFunctionCount; i++) {
+    unit_check(stats->functions[i].overflows == 0);
+    unit_check(stats->functions[i].saturations == 0);
+    unit_check(stats->functions[i].truncations == 0);
+  }
+}
+
+#else
+
+static void test_fast_path_wraps(void) {
+  // Without GTRANSFORM_CHECKED coordinates outside of the precise range wrap silently
+  const GTransform identity = GTransformIdentity();
+  const GPointPrecise pointP = gpoint_transform(GPoint(5000, 0), &identity);
+  unit_check(pointP.x.raw_value == (int16_t)(5000 * 8));
+
+  const GTransform t = GTransformScaleFromNumber(4, 4);
+  const GPointPrecise scaled = gpoint_transform(GPoint(3000, 0), &t);
+  unit_check(scaled.x.raw_value == (int16_t)(3000 * 8 * 4));
+
+  // In range, both builds agree
+  for (int i = 0; i < NUM_RANDOM_POINTS; i++) {
+    const GTransform r = unit_random_transform(2 * 0x10000, 500 * 0x10000);
+    const GPoint p = GPoint(unit_random(-500, 500), unit_random(-500, 500));
+    const GPointPrecise expected = gpointprecise_transform(GPointPreciseFromGPoint(p), &r);
+    const GPointPrecise actual = gpoint_transform(p, &r);
+    unit_check(actual.x.raw_value == expected.x.raw_value);
+    unit_check(actual.y.raw_value == expected.y.raw_value);
+  }
+}
+
+#endif
+
+int main(void) {
+#if defined(GTRANSFORM_CHECKED)
+  unit_run(test_in_range_matches_fast_path);
+  unit_run(test_point_saturation);
+  unit_run(test_point_overflow);
+  unit_run(test_point_buffer);
+  unit_run(test_vector_saturation);
+  unit_run(test_matrix_overflow);
+  unit_run(test_truncation);
+  unit_run(test_reset);
+#else
+  unit_run(test_fast_path_wraps);
+#endif
+  return unit_report();
+}
@@ -0,0 +1,134 @@
+#include "gtransform.hpp"
+#include "unit.h"
+
+#include <utility>
+
+// Everything below is evaluated by the compiler; a builder that cannot be would fail to compile
+static constexpr GTransform s_identity = gtransform::identity();
+static constexpr GTransform s_half = GTRANSFORM_SCALE(0.5, 0.5);
+static constexpr GTransform s_offset = gtransform::translation(10, -20);
+static constexpr GTransform s_layout =
+    gtransform::concat(GTRANSFORM_SCALE(2.0, 3.0), gtransform::rotation(TRIG_MAX_ANGLE / 8),
+                       gtransform::translation(72, 84));
+
+static_assert(gtransform::equal(gtransform::concat(s_identity, s_offset), s_offset),
+              "identity is neutral");
+static_assert(s_half.a.raw_value == 0x8000, "0.5 in 16.16");
+static_assert(gtransform::rotation(TRIG_MAX_ANGLE / 4).b.raw_value == -0x10000,
+              "quarter turn is exact");
+static_assert(gtransform::rotation(TRIG_MAX_ANGLE / 2).a.raw_value == -0x10000,
+              "half turn is exact");
+
+// Before C++20 the builders must not take a double at all, as nothing would stop them from
+// converting it at runtime. With C++20 they are consteval, which rejects runtime calls itself.
+template <typename T, typename = void>
+struct CanScale : std::false_type {};
+template <typename T>
+struct CanScale<T, decltype((void)gtransform::scale(std::declval<T>(), std::declval<T>()))>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct CanTranslate : std::false_type {};
+template <typename T>
+struct CanTranslate<T, decltype((void)gtransform::translation(std::declval<T>(),
+                                                              std::declval<T>()))>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct CanConvert : std::false_type {};
+template <typename T>
+struct CanConvert<T, decltype((void)gtransform::number(std::declval<T>()))> : std::true_type {};
+
+static_assert(CanTranslate<int>::value && CanConvert<int>::value, "integers work at runtime");
+#if !defined(__cpp_consteval)
+static_assert(!CanScale<double>::value && !CanScale<float>::value, "no runtime double scale");
+static_assert(!CanTranslate<double>::value, "no runtime double translation");
+static_assert(!CanConvert<double>::value && !CanConvert<float>::value,
+              "no runtime double conversion");
+#endif
+
+static void test_numbers(void) {
+  const GTransformNumber c_values[] = {
+    GTransformNumberFromNumber(0.5), GTransformNumberFromNumber(-1.25),
+    GTransformNumberFromNumber(0.05), GTransformNumberFromNumber(-0.3),
+    GTransformNumberFromNumber(7), GTransformNumberFromNumber(-100),
+  };
+  constexpr GTransformNumber cpp_values[] = {
+    GTRANSFORM_NUMBER(0.5), GTRANSFORM_NUMBER(-1.25), GTRANSFORM_NUMBER(0.05),
+    GTRANSFORM_NUMBER(-0.3), GTRANSFORM_NUMBER(7), GTRANSFORM_NUMBER(-100),
+  };
+  for (size_t i = 0; i < sizeof(c_values) / sizeof(c_values[0]); i++) {
+    unit_check(c_values[i].raw_value == cpp_values[i].raw_value);
+  }
+
+  // The macros also work in runtime code, where they still convert at compile time
+  const GTransform translation = GTRANSFORM_TRANSLATION(1.5, -0.25);
+  unit_check((translation.tx.raw_value == 0x18000) && (translation.ty.raw_value == -0x4000));
+
+#if defined(__cpp_consteval)
+  // With C++20 the builders take constant doubles directly
+  unit_check(gtransform::number(1.5).raw_value == 0x18000);
+  unit_check(gtransform::equal(gtransform::scale(0.5, 0.5), s_half));
+#endif
+
+  // Integer conversions are allowed at runtime
+  for (int i = -1000; i <= 1000; i++) {
+    unit_check(gtransform::number(i).raw_value == GTransformNumberFromNumber(i).raw_value);
+  }
+}
+
+static void test_builders_match_macros(void) {
+  GTransform t = GTransformIdentity();
+  unit_check(gtransform_is_equal(&s_identity, &t));
+  t = GTransformScaleFromNumber(0.5, 0.5);
+  unit_check(gtransform_is_equal(&s_half, &t));
+  t = GTransformTranslationFromNumber(10, -20);
+  unit_check(gtransform_is_equal(&s_offset, &t));
+}
+
+static void test_rotation(void) {
+  for (int32_t angle = -TRIG_MAX_ANGLE; angle <= 2 * TRIG_MAX_ANGLE; angle += 7) {
+    const GTransform expected = gtransform_init_rotation(angle);
+    const GTransform actual = gtransform::rotation(angle);
+    unit_check_near(actual.a.raw_value, expected.a.raw_value, 1);
+    unit_check_near(actual.b.raw_value, expected.b.raw_value, 1);
+    unit_check_near(actual.c.raw_value, expected.c.raw_value, 1);
+    unit_check_near(actual.d.raw_value, expected.d.raw_value, 1);
+  }
+}
+
+static void test_concat(void) {
+  GTransform expected = GTransformScaleFromNumber(2, 3);
+  GTransform rotation = gtransform_init_rotation(TRIG_MAX_ANGLE / 8);
+  GTransform translation = GTransformTranslationFromNumber(72, 84);
+  gtransform_concat(&expected, &expected, &rotation);
+  gtransform_concat(&expected, &expected, &translation);
+  unit_check_near(s_layout.a.raw_value, expected.a.raw_value, 2);
+  unit_check_near(s_layout.b.raw_value, expected.b.raw_value, 2);
+  unit_check_near(s_layout.c.raw_value, expected.c.raw_value, 2);
+  unit_check_near(s_layout.d.raw_value, expected.d.raw_value, 2);
+  unit_check(s_layout.tx.raw_value == expected.tx.raw_value);
+  unit_check(s_layout.ty.raw_value == expected.ty.raw_value);
+
+  // With the same inputs the result is bit-identical to gtransform_concat
+  for (int i = 0; i < 10000; i++) {
+    const GTransform t1 = unit_random_transform(4 * 0x10000, 1000 * 0x10000);
+    const GTransform t2 = gtransform::trs(Fixed_S32_16(unit_random(0x8000, 0x20000)),
+                                          Fixed_S32_16(unit_random(0x8000, 0x20000)),
+                                          unit_random(0, TRIG_MAX_ANGLE - 1),
+                                          gtransform::number(unit_random(-100, 100)),
+                                          gtransform::number(unit_random(-100, 100)));
+    GTransform t_c;
+    gtransform_concat(&t_c, &t1, &t2);
+    const GTransform t_cpp = gtransform::concat(t1, t2);
+    unit_check(gtransform::equal(t_c, t_cpp));
+  }
+}
+
+int main(void) {
+  unit_run(test_numbers);
+  unit_run(test_builders_match_macros);
+  unit_run(test_rotation);
+  unit_run(test_concat);
+  return unit_report();
+}
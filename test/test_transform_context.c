@@ -0,0 +1,179 @@
+#include <pebble.h>
+
+#include "gtransform_context.h"
+#include "unit.h"
+
+static GContext *s_ctx;
+
+static const HostDrawCall *prv_single_call(void) {
+  const HostDrawCall *calls;
+  const size_t num_calls = graphics_context_get_draw_calls(s_ctx, &calls);
+  unit_check(num_calls == 1);
+  graphics_context_clear_draw_calls(s_ctx);
+  return (num_calls == 1) ? calls : NULL;
+}
+
+static bool prv_point_equal(GPoint p1, GPoint p2) {
+  return (p1.x == p2.x) && (p1.y == p2.y);
+}
+
+static bool prv_rect_equal(GRect r1, GRect r2) {
+  return prv_point_equal(r1.origin, r2.origin) && (r1.size.w == r2.size.w) &&
+         (r1.size.h == r2.size.h);
+}
+
+static void test_stack(void) {
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, s_ctx);
+  unit_check(gtransform_is_identity(gtransform_context_get(&tctx)));
+  unit_check(!gtransform_context_pop(&tctx));
+
+  // Every push up to the capacity succeeds and each pop restores the matrix before its push
+  for (int i = 1; i < GTRANSFORM_CONTEXT_STACK_SIZE; i++) {
+    unit_check(gtransform_context_push(&tctx));
+    gtransform_context_translate(&tctx, GTransformNumberFromNumber(i), GTransformNumberZero);
+  }
+  unit_check(!gtransform_context_push(&tctx));
+  unit_check(gtransform_context_get(&tctx)->tx.raw_value ==
+             GTransformNumberFromNumber(28).raw_value);
+
+  for (int i = GTRANSFORM_CONTEXT_STACK_SIZE - 1; i > 0; i--) {
+    unit_check(gtransform_context_pop(&tctx));
+    unit_check(gtransform_context_get(&tctx)->tx.raw_value ==
+               GTransformNumberFromNumber((i - 1) * i / 2).raw_value);
+  }
+  unit_check(!gtransform_context_pop(&tctx));
+
+  // Modifiers apply in front of the current matrix, like the gtransform functions
+  const GTransform t = GTransformRotation(TRIG_MAX_ANGLE / 8);
+  GTransform expected = GTransformTranslationFromNumber(10, 20);
+  gtransform_context_set(&tctx, &expected);
+  gtransform_context_concat(&tctx, &t);
+  gtransform_concat(&expected, &t, &expected);
+  unit_check(gtransform_is_equal(gtransform_context_get(&tctx), &expected));
+
+  gtransform_context_set(&tctx, NULL);
+  unit_check(gtransform_is_identity(gtransform_context_get(&tctx)));
+}
+
+static void test_line(void) {
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, s_ctx);
+  gtransform_context_translate(&tctx, GTransformNumberFromNumber(72),
+                               GTransformNumberFromNumber(84));
+  gtransform_context_rotate(&tctx, TRIG_MAX_ANGLE / 5);
+
+  const GPoint p0 = GPoint(3, -7);
+  const GPoint p1 = GPoint(40, 25);
+  gtransform_context_draw_line(&tctx, p0, p1);
+
+  // Same points as converting the transformed points to the nearest pixels
+  const HostDrawCall *call = prv_single_call();
+  const GTransform *t = gtransform_context_get(&tctx);
+  unit_check(call && (call->op == HostDrawOpLine));
+  unit_check(call && prv_point_equal(call->p0,
+                                     GPointFromGPointPreciseRounded(gpoint_transform(p0, t))));
+  unit_check(call && prv_point_equal(call->p1,
+                                     GPointFromGPointPreciseRounded(gpoint_transform(p1, t))));
+}
+
+static void test_rect(void) {
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, s_ctx);
+
+  // Scaling and mirroring keep rectangles axis aligned
+  gtransform_context_translate(&tctx, GTransformNumberFromNumber(100), GTransformNumberZero);
+  gtransform_context_scale(&tctx, GTransformNumberFromNumber(-2), GTransformNumberFromNumber(3));
+  gtransform_context_fill_rect(&tctx, GRect(10, 5, 20, 10));
+  const HostDrawCall *call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpFillRect));
+  unit_check(call && prv_rect_equal(call->rect, GRect(40, 15, 40, 30)));
+
+  gtransform_context_draw_rect(&tctx, GRect(0, 0, 1, 1));
+  call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpRect));
+  unit_check(call && prv_rect_equal(call->rect, GRect(98, 0, 2, 3)));
+
+  // A rotated rectangle becomes a path through its four transformed corners
+  gtransform_context_set(&tctx, NULL);
+  gtransform_context_rotate(&tctx, TRIG_MAX_ANGLE / 4);
+  gtransform_context_fill_rect(&tctx, GRect(0, 0, 10, 20));
+  call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpPathFilled));
+  unit_check(call && (call->num_points == 4));
+  const GTransform *t = gtransform_context_get(&tctx);
+  unit_check(call && prv_point_equal(call->points[2], GPointFromGPointPreciseRounded(
+      gpoint_transform(GPoint(10, 20), t))));
+}
+
+static void test_circle(void) {
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, s_ctx);
+
+  // Rotation and uniform scale keep circles circles, with the radius scaled and rounded
+  gtransform_context_translate(&tctx, GTransformNumberFromNumber(72),
+                               GTransformNumberFromNumber(84));
+  gtransform_context_rotate(&tctx, TRIG_MAX_ANGLE / 7);
+  gtransform_context_scale(&tctx, GTransformNumberFromNumber(1.5), GTransformNumberFromNumber(1.5));
+  gtransform_context_fill_circle(&tctx, GPoint(0, -20), 10);
+  const HostDrawCall *call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpFillCircle));
+  unit_check(call && (call->radius == 15));
+  unit_check(call && prv_point_equal(call->p0, GPointFromGPointPreciseRounded(
+      gpoint_transform(GPoint(0, -20), gtransform_context_get(&tctx)))));
+
+  // Mirroring too
+  gtransform_context_push(&tctx);
+  gtransform_context_scale(&tctx, GTransformNumberFromNumber(-1), GTransformNumberOne);
+  gtransform_context_draw_circle(&tctx, GPoint(0, 0), 7);
+  call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpCircle));
+  unit_check(call && ((call->radius == 10) || (call->radius == 11)));
+  gtransform_context_pop(&tctx);
+
+  // Stretched, a circle becomes an ellipse whose points lie on the transformed circle
+  gtransform_context_set(&tctx, NULL);
+  gtransform_context_scale(&tctx, GTransformNumberFromNumber(2), GTransformNumberOne);
+  gtransform_context_draw_circle(&tctx, GPoint(50, 50), 10);
+  call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpPathOutline));
+  unit_check(call && (call->num_points == GTRANSFORM_CONTEXT_ELLIPSE_POINTS));
+  for (uint32_t i = 0; call && (i < call->num_points); i++) {
+    const double dx = (call->points[i].x - 100) / 20.0;
+    const double dy = (call->points[i].y - 50) / 10.0;
+    unit_check_near(dx * dx + dy * dy, 1.0, 0.25);
+  }
+}
+
+static void test_path(void) {
+  GTransformContext tctx;
+  gtransform_context_init(&tctx, s_ctx);
+  gtransform_context_translate(&tctx, GTransformNumberFromNumber(5), GTransformNumberFromNumber(6));
+
+  GPoint points[] = { GPoint(0, 0), GPoint(10, 0), GPoint(5, 8) };
+  const GPathInfo info = { .num_points = ARRAY_LENGTH(points), .points = points };
+  unit_check(gtransform_context_fill_path(&tctx, &info));
+  const HostDrawCall *call = prv_single_call();
+  unit_check(call && (call->op == HostDrawOpPathFilled));
+  unit_check(call && (call->num_points == 3));
+  unit_check(call && prv_point_equal(call->points[2], GPoint(10, 14)));
+
+  GPoint many[GTRANSFORM_CONTEXT_MAX_PATH_POINTS + 1] = { { 0, 0 } };
+  const GPathInfo too_long = { .num_points = ARRAY_LENGTH(many), .points = many };
+  unit_check(!gtransform_context_draw_path(&tctx, &too_long));
+  unit_check(!gtransform_context_draw_path(&tctx, NULL));
+  unit_check(graphics_context_get_draw_calls(s_ctx, NULL) == 0);
+}
+
+int main(void) {
+  s_ctx = graphics_context_create_for_bitmap(NULL);
+
+  unit_run(test_stack);
+  unit_run(test_line);
+  unit_run(test_rect);
+  unit_run(test_circle);
+  unit_run(test_path);
+
+  graphics_context_destroy(s_ctx);
+  return unit_report();
+}
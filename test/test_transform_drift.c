@@ -0,0 +1,162 @@
+#include <pebble.h>
+
+#include "gtransform.h"
+#include "unit.h"
+
+#include <stdlib.h>
+
+#define NUM_RANDOM_MATRICES 20000
+#define NUM_DRIFT_UPDATES 1000000
+// Orthonormalizing once every this many frames is enough to keep rounded chains in check
+#define ORTHONORMALIZE_INTERVAL 64
+
+// Largest deviation of the row lengths from one, in GTransformNumber steps
+static double prv_scale_error(const GTransform *t) {
+  const double x_length = hypot(unit_number(t->a), unit_number(t->b));
+  const double y_length = hypot(unit_number(t->c), unit_number(t->d));
+  return fmax(fabs(x_length - 1.0), fabs(y_length - 1.0)) * GTransformNumberOne.raw_value;
+}
+
+// Dot product of the rows, in GTransformNumber steps
+static double prv_orthogonality_error(const GTransform *t) {
+  return fabs(unit_number(t->a) * unit_number(t->c) + unit_number(t->b) * unit_number(t->d)) *
+         GTransformNumberOne.raw_value;
+}
+
+static void test_mul_round(void) {
+  const Fixed_S32_16 half = Fixed_S32_16(0x8000);
+  unit_check(Fixed_S32_16_mul(Fixed_S32_16(3), half).raw_value == 1);
+  unit_check(Fixed_S32_16_mul_round(Fixed_S32_16(3), half).raw_value == 2);
+  unit_check(Fixed_S32_16_mul_round(Fixed_S32_16(-3), half).raw_value == -1);
+  unit_check(Fixed_S32_16_mul_round(Fixed_S32_16(2), half).raw_value == 1);
+  unit_check(Fixed_S16_3_S32_16_mul_round(Fixed_S16_3(3), half).raw_value == 2);
+  unit_check(Fixed_S16_3_S32_16_mul_round(Fixed_S16_3(-4), half).raw_value == -2);
+
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const Fixed_S32_16 a = Fixed_S32_16(unit_random(-8 * 0x10000, 8 * 0x10000));
+    const Fixed_S32_16 b = Fixed_S32_16(unit_random(-8 * 0x10000, 8 * 0x10000));
+    const double expected = (double)a.raw_value * b.raw_value / 0x10000;
+    unit_check_near(Fixed_S32_16_mul_round(a, b).raw_value, expected, 0.5);
+  }
+}
+
+static void test_concat_rounded(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform t1 = unit_random_transform(4 * 0x10000, 100 * 0x10000);
+    const GTransform t2 = unit_random_transform(4 * 0x10000, 100 * 0x10000);
+
+    GTransform t;
+    gtransform_concat_rounded(&t, &t1, &t2);
+
+    // Every coefficient is the exact result rounded to the nearest step
+    const double one = GTransformNumberOne.raw_value;
+    unit_check_near(t.a.raw_value, (unit_number(t1.a) * unit_number(t2.a) +
+                                    unit_number(t1.b) * unit_number(t2.c)) * one, 0.5);
+    unit_check_near(t.d.raw_value, (unit_number(t1.c) * unit_number(t2.b) +
+                                    unit_number(t1.d) * unit_number(t2.d)) * one, 0.5);
+    unit_check_near(t.tx.raw_value, (unit_number(t1.tx) * unit_number(t2.a) +
+                                     unit_number(t1.ty) * unit_number(t2.c) +
+                                     unit_number(t2.tx)) * one, 0.5);
+
+    // In place gives the same result
+    GTransform t_alias = t1;
+    gtransform_concat_rounded(&t_alias, &t_alias, &t2);
+    unit_check(gtransform_is_equal(&t_alias, &t));
+  }
+}
+
+static void test_orthonormalize(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform t = unit_random_transform(4 * 0x10000, 100 * 0x10000);
+    GTransform t_unit;
+    if (!gtransform_orthonormalize(&t_unit, &t)) {
+      unit_check((t.a.raw_value == 0) && (t.b.raw_value == 0));
+      continue;
+    }
+
+    unit_check(prv_scale_error(&t_unit) <= 1.0);
+    unit_check(prv_orthogonality_error(&t_unit) <= 1.0);
+
+    // The x-axis keeps its direction, mirroring is kept and the translation is untouched
+    unit_check_near(atan2(unit_number(t_unit.b), unit_number(t_unit.a)),
+                    atan2(unit_number(t.b), unit_number(t.a)), 1e-3);
+    const int64_t det = (int64_t)t.a.raw_value * t.d.raw_value -
+                        (int64_t)t.b.raw_value * t.c.raw_value;
+    const int64_t det_unit = (int64_t)t_unit.a.raw_value * t_unit.d.raw_value -
+                             (int64_t)t_unit.b.raw_value * t_unit.c.raw_value;
+    unit_check((det < 0) == (det_unit < 0));
+    unit_check(t_unit.tx.raw_value == t.tx.raw_value);
+    unit_check(t_unit.ty.raw_value == t.ty.raw_value);
+  }
+
+  // A rotation comes back unchanged to within a step
+  const GTransform r = GTransformRotation(TRIG_MAX_ANGLE / 7);
+  GTransform r_unit = r;
+  unit_check(gtransform_orthonormalize(&r_unit, &r_unit));
+  unit_check(abs(r_unit.a.raw_value - r.a.raw_value) <= 1);
+  unit_check(abs(r_unit.c.raw_value - r.c.raw_value) <= 1);
+
+  // A collapsed x-axis cannot be normalized and is copied
+  const GTransform degenerate = GTransformScaleFromNumber(0, 2);
+  GTransform t_new = GTransformIdentity();
+  unit_check(!gtransform_orthonormalize(&t_new, &degenerate));
+  unit_check(gtransform_is_equal(&t_new, &degenerate));
+  unit_check(!gtransform_orthonormalize(NULL, &degenerate));
+}
+
+// Rotates one matrix by a small step a million times, as an animation that never rebuilds its
+// matrix would. Left alone, truncated and rounded chains both drift far from a rotation; only
+// orthonormalizing from time to time bounds the error, to a few dozen steps for a rounded chain.
+static void test_drift(void) {
+  const int32_t step = TRIG_MAX_ANGLE / 360 + 7;
+
+  GTransform truncated = GTransformIdentity();
+  GTransform rounded = GTransformIdentity();
+  GTransform truncated_corrected = GTransformIdentity();
+  GTransform corrected = GTransformIdentity();
+  double max_truncated_scale_error = 0.0;
+  double max_corrected_scale_error = 0.0;
+  double max_corrected_orthogonality_error = 0.0;
+
+  for (int i = 1; i <= NUM_DRIFT_UPDATES; i++) {
+    gtransform_rotate(&truncated, &truncated, step);
+    gtransform_rotate_rounded(&rounded, &rounded, step);
+    gtransform_rotate(&truncated_corrected, &truncated_corrected, step);
+    gtransform_rotate_rounded(&corrected, &corrected, step);
+    if ((i % ORTHONORMALIZE_INTERVAL) == 0) {
+      gtransform_orthonormalize(&truncated_corrected, &truncated_corrected);
+      gtransform_orthonormalize(&corrected, &corrected);
+    }
+
+    max_truncated_scale_error = fmax(max_truncated_scale_error,
+                                     prv_scale_error(&truncated_corrected));
+    max_corrected_scale_error = fmax(max_corrected_scale_error, prv_scale_error(&corrected));
+    max_corrected_orthogonality_error = fmax(max_corrected_orthogonality_error,
+                                             prv_orthogonality_error(&corrected));
+  }
+
+  printf("scale drift after %d rotations, in steps of 1/65536: truncated %.0f, rounded %.0f; "
+         "orthonormalized every %d frames, at most: truncated %.2f, rounded %.2f "
+         "(orthogonality %.2f)\n", NUM_DRIFT_UPDATES, prv_scale_error(&truncated),
+         prv_scale_error(&rounded), ORTHONORMALIZE_INTERVAL, max_truncated_scale_error,
+         max_corrected_scale_error, max_corrected_orthogonality_error);
+
+  // Left alone, both chains end up far from a rotation
+  unit_check(prv_scale_error(&truncated) > 0.5 * GTransformNumberOne.raw_value);
+  unit_check(prv_scale_error(&rounded) > 1000.0);
+
+  // Orthonormalized, the rounded chain never strays far from a rotation between corrections,
+  // while the truncating one loses several times more in the same number of frames
+  unit_check(max_corrected_scale_error < 32.0);
+  unit_check(max_corrected_orthogonality_error < 4.0);
+  unit_check(max_corrected_scale_error * 4 < max_truncated_scale_error);
+  unit_check(prv_scale_error(&corrected) <= 1.0);
+}
+
+int main(void) {
+  unit_run(test_mul_round);
+  unit_run(test_concat_rounded);
+  unit_run(test_orthonormalize);
+  unit_run(test_drift);
+  return unit_report();
+}
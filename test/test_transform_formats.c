@@ -0,0 +1,127 @@
+#include <pebble.h>
+
+#include "gtransform_formats.h"
+#include "unit.h"
+
+#define NUM_RANDOM_MATRICES 20000
+
+static double prv_number(int32_t raw_value, int bits) {
+  return (double)raw_value / (1 << bits);
+}
+
+static void test_fixed_ops(void) {
+  const Fixed_S16_8 half = Fixed_S16_8_wrap(0x80);
+  const Fixed_S16_8 big = Fixed_S16_8_from_int(100);
+  unit_check(Fixed_S16_8_from_int(-3).raw_value == -3 * 256);
+  unit_check(Fixed_S16_8_to_int(Fixed_S16_8_wrap(-0x80)) == -1);
+  unit_check(Fixed_S16_8_mul(big, half).raw_value == 50 * 256);
+  unit_check(Fixed_S16_8_sub(half, big).raw_value == 0x80 - 100 * 256);
+
+  // 100 + 100 and 100 * 100 do not fit in Q8.8
+  unit_check(Fixed_S16_8_add_sat(big, big).raw_value == INT16_MAX);
+  unit_check(Fixed_S16_8_sub_sat(Fixed_S16_8_sub(Fixed_S16_8_from_int(0), big), big).raw_value ==
+             INT16_MIN);
+  unit_check(Fixed_S16_8_mul_sat(big, big).raw_value == INT16_MAX);
+  unit_check(Fixed_S16_8_mul_sat(big, Fixed_S16_8_from_int(-100)).raw_value == INT16_MIN);
+  unit_check(Fixed_S16_8_mul_wide(big, big) == 10000 * 256);
+
+  // The built-in formats gained the same operations
+  unit_check(Fixed_S32_16_mul_wide(Fixed_S32_16_from_int(30000), Fixed_S32_16_from_int(30000)) ==
+             (int64_t)900000000 << 16);
+  unit_check(Fixed_S32_16_mul_sat(Fixed_S32_16_from_int(30000),
+                                  Fixed_S32_16_from_int(30000)).raw_value == INT32_MAX);
+  unit_check(Fixed_S16_3_add_sat(Fixed_S16_3_from_int(4000),
+                                 Fixed_S16_3_from_int(4000)).raw_value == INT16_MAX);
+  unit_check(Fixed_S32_8_to_int(Fixed_S32_8_from_int(-5000000)) == -5000000);
+
+  unit_check(fixed_rescale(0x18000, 16, 8) == 0x180);
+  unit_check(fixed_rescale(-0x180, 8, 16) == -0x18000);
+}
+
+static void test_q16_16(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform t = unit_random_transform(2 * 0x10000, 500 * 0x10000);
+    const GTransformQ16_16 tq = gtransform_q16_16_from_gtransform(&t);
+    const GPoint p = GPoint(unit_random(-500, 500), unit_random(-500, 500));
+
+    // Same result as gpoint_transform, which truncates each of its three terms to 1/8 px
+    const GPointPrecise expected = gpoint_transform(p, &t);
+    const GPointQ16_16 actual = gtransform_q16_16_point_transform(
+        gtransform_q16_16_point_from_gpoint(p), &tq);
+    unit_check_near(prv_number(actual.x.raw_value, 16), prv_number(expected.x.raw_value, 3), 0.4);
+    unit_check_near(prv_number(actual.y.raw_value, 16), prv_number(expected.y.raw_value, 3), 0.4);
+
+    // Concatenation is bit-identical to gtransform_concat
+    const GTransform t2 = unit_random_transform(4 * 0x10000, 1000 * 0x10000);
+    const GTransformQ16_16 t2q = gtransform_q16_16_from_gtransform(&t2);
+    GTransform t_c;
+    GTransformQ16_16 t_q;
+    gtransform_concat(&t_c, &t, &t2);
+    gtransform_q16_16_concat(&t_q, &tq, &t2q);
+    unit_check((t_q.a.raw_value == t_c.a.raw_value) && (t_q.b.raw_value == t_c.b.raw_value) &&
+               (t_q.c.raw_value == t_c.c.raw_value) && (t_q.d.raw_value == t_c.d.raw_value) &&
+               (t_q.tx.raw_value == t_c.tx.raw_value) && (t_q.ty.raw_value == t_c.ty.raw_value));
+  }
+}
+
+static void test_q24_8(void) {
+  // Map coordinates far outside of what GPointPrecise can hold
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform t = unit_random_transform(2 * 0x10000, 1000 * 0x10000);
+    const GTransformQ24_8 tq = gtransform_q24_8_from_gtransform(&t);
+    const GPoint p = GPoint(unit_random(-30000, 30000), unit_random(-30000, 30000));
+    GPointQ24_8 pq = gtransform_q24_8_point_from_gpoint(p);
+    // Move the point a million pixels away
+    pq.x.raw_value += unit_random(-1000000, 1000000) * 256;
+
+    const double x = prv_number(pq.x.raw_value, 8);
+    const double y = prv_number(pq.y.raw_value, 8);
+    const double expected_x = x * unit_number(t.a) + y * unit_number(t.c) + unit_number(t.tx);
+    const double expected_y = x * unit_number(t.b) + y * unit_number(t.d) + unit_number(t.ty);
+    const GPointQ24_8 actual = gtransform_q24_8_point_transform(pq, &tq);
+    unit_check_near(prv_number(actual.x.raw_value, 8), expected_x, 0.02);
+    unit_check_near(prv_number(actual.y.raw_value, 8), expected_y, 0.02);
+  }
+}
+
+static void test_q8_8(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform t = unit_random_transform(0x10000, 16 * 0x10000);
+    const GTransformQ8_8 tq = gtransform_q8_8_from_gtransform(&t);
+    const GPoint p = GPoint(unit_random(-40, 40), unit_random(-40, 40));
+
+    const double expected_x = p.x * prv_number(tq.a.raw_value, 8) +
+                              p.y * prv_number(tq.c.raw_value, 8) +
+                              prv_number(tq.tx.raw_value, 8);
+    const double expected_y = p.x * prv_number(tq.b.raw_value, 8) +
+                              p.y * prv_number(tq.d.raw_value, 8) +
+                              prv_number(tq.ty.raw_value, 8);
+    const GPointQ8_8 actual = gtransform_q8_8_point_transform(
+        gtransform_q8_8_point_from_gpoint(p), &tq);
+    unit_check_near(prv_number(actual.x.raw_value, 8), expected_x, 0.01);
+    unit_check_near(prv_number(actual.y.raw_value, 8), expected_y, 0.01);
+  }
+
+  // Results beyond ±128 wrap with the plain transform and clamp with the saturating one
+  const GTransform t = GTransformScaleFromNumber(4, -4);
+  const GTransformQ8_8 tq = gtransform_q8_8_from_gtransform(&t);
+  const GPointQ8_8 p = gtransform_q8_8_point_from_gpoint(GPoint(100, 100));
+  const GPointQ8_8 saturated = gtransform_q8_8_point_transform_saturating(p, &tq);
+  unit_check(saturated.x.raw_value == INT16_MAX);
+  unit_check(saturated.y.raw_value == INT16_MIN);
+  const GPointQ8_8 wrapped = gtransform_q8_8_point_transform(p, &tq);
+  unit_check(wrapped.x.raw_value == (int16_t)(400 * 256));
+
+  const GTransformQ8_8 identity = gtransform_q8_8_identity();
+  const GPointQ8_8 same = gtransform_q8_8_point_transform(p, &identity);
+  const GPoint back = gtransform_q8_8_point_to_gpoint(same);
+  unit_check((back.x == 100) && (back.y == 100));
+}
+
+int main(void) {
+  unit_run(test_fixed_ops);
+  unit_run(test_q16_16);
+  unit_run(test_q24_8);
+  unit_run(test_q8_8);
+  return unit_report();
+}
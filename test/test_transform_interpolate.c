@@ -0,0 +1,174 @@
+#include <pebble.h>
+
+#include "gtransform_interpolate.h"
+#include "unit.h"
+
+#include <stdlib.h>
+
+#define NUM_RANDOM_MATRICES 2000
+
+// Tolerance for a coefficient of a recomposed matrix: a few units of rounding plus the error of
+// the rotation table and of atan2_lookup, relative to the scale
+static double prv_tolerance(const GTransform *t) {
+  const double scale = abs(t->a.raw_value) + abs(t->b.raw_value) + abs(t->c.raw_value) +
+                       abs(t->d.raw_value);
+  return 4 + scale * 0.0005;
+}
+
+static void prv_check_near(const GTransform *actual, const GTransform *expected) {
+  const double tolerance = prv_tolerance(expected);
+  unit_check_near(actual->a.raw_value, expected->a.raw_value, tolerance);
+  unit_check_near(actual->b.raw_value, expected->b.raw_value, tolerance);
+  unit_check_near(actual->c.raw_value, expected->c.raw_value, tolerance);
+  unit_check_near(actual->d.raw_value, expected->d.raw_value, tolerance);
+  unit_check_near(actual->tx.raw_value, expected->tx.raw_value, 1);
+  unit_check_near(actual->ty.raw_value, expected->ty.raw_value, 1);
+}
+
+static void test_decompose(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    GTransform t = unit_random_trs(0x4000, 0x40000, 200 * 0x10000);
+    // Also cover shear and mirroring
+    if (i % 3 == 1) {
+      t.c.raw_value += unit_random(-0x8000, 0x8000);
+    } else if (i % 3 == 2) {
+      t.c.raw_value = -t.c.raw_value;
+      t.d.raw_value = -t.d.raw_value;
+    }
+
+    GTransformDecomposition parts;
+    unit_check(gtransform_decompose(&parts, &t));
+    unit_check((parts.angle >= 0) && (parts.angle < TRIG_MAX_ANGLE));
+    if (i % 3 == 0) {
+      unit_check(parts.sy.raw_value > 0);
+    } else if (i % 3 == 2) {
+      unit_check(parts.sy.raw_value < 0);
+    }
+
+    GTransform recomposed;
+    gtransform_recompose(&recomposed, &parts);
+    prv_check_near(&recomposed, &t);
+  }
+
+  // A matrix whose first row is zero has no rotation to extract
+  GTransform t = GTransformScaleFromNumber(0, 1);
+  GTransformDecomposition parts;
+  unit_check(!gtransform_decompose(&parts, &t));
+  unit_check(!gtransform_decompose(NULL, &t));
+}
+
+static void test_interpolate_linear(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransform from = unit_random_trs(0x4000, 0x40000, 200 * 0x10000);
+    const GTransform to = unit_random_trs(0x4000, 0x40000, 200 * 0x10000);
+    GTransform t;
+
+    gtransform_interpolate(&t, &from, &to, ANIMATION_NORMALIZED_MIN,
+                           GTransformInterpolationLinear);
+    unit_check(gtransform_is_equal(&t, &from));
+    gtransform_interpolate(&t, &from, &to, ANIMATION_NORMALIZED_MAX,
+                           GTransformInterpolationLinear);
+    unit_check(gtransform_is_equal(&t, &to));
+
+    const AnimationProgress progress = unit_random(-ANIMATION_NORMALIZED_MAX / 4,
+                                                   ANIMATION_NORMALIZED_MAX * 5 / 4);
+    gtransform_interpolate(&t, &from, &to, progress, GTransformInterpolationLinear);
+    const double p = (double)progress / ANIMATION_NORMALIZED_MAX;
+    unit_check_near(t.a.raw_value, from.a.raw_value + (to.a.raw_value - from.a.raw_value) * p, 1);
+    unit_check_near(t.ty.raw_value,
+                    from.ty.raw_value + ((double)to.ty.raw_value - from.ty.raw_value) * p, 1);
+
+    // The output may alias an input
+    GTransform aliased = from;
+    gtransform_interpolate(&aliased, &aliased, &to, progress, GTransformInterpolationLinear);
+    unit_check(gtransform_is_equal(&aliased, &t));
+  }
+}
+
+static void test_interpolate_decomposed(void) {
+  for (int i = 0; i < NUM_RANDOM_MATRICES; i++) {
+    const GTransformNumber sx[2] = { Fixed_S32_16(unit_random(0x4000, 0x40000)),
+                                     Fixed_S32_16(unit_random(0x4000, 0x40000)) };
+    const int32_t angle[2] = { unit_random(0, TRIG_MAX_ANGLE - 1),
+                               unit_random(0, TRIG_MAX_ANGLE - 1) };
+    const GTransformNumber tx[2] = { Fixed_S32_16(unit_random(-200 * 0x10000, 200 * 0x10000)),
+                                     Fixed_S32_16(unit_random(-200 * 0x10000, 200 * 0x10000)) };
+    const GTransform from = GTransformTRS(sx[0], sx[0], angle[0], tx[0], tx[1]);
+    const GTransform to = GTransformTRS(sx[1], sx[1], angle[1], tx[1], tx[0]);
+    const AnimationProgress progress = unit_random(1, ANIMATION_NORMALIZED_MAX - 1);
+
+    // Each component moves on its own, with the rotation taking the shorter arc
+    int32_t delta_angle = (angle[1] - angle[0]) & (TRIG_MAX_ANGLE - 1);
+    if (delta_angle >= TRIG_MAX_ANGLE / 2) {
+      delta_angle -= TRIG_MAX_ANGLE;
+    }
+    const double p = (double)progress / ANIMATION_NORMALIZED_MAX;
+    const GTransformNumber s = Fixed_S32_16(
+        (int32_t)(sx[0].raw_value + (sx[1].raw_value - sx[0].raw_value) * p));
+    const GTransform expected = GTransformTRS(
+        s, s, (int32_t)lround(angle[0] + delta_angle * p),
+        Fixed_S32_16((int32_t)(tx[0].raw_value + ((double)tx[1].raw_value - tx[0].raw_value) * p)),
+        Fixed_S32_16((int32_t)(tx[1].raw_value + ((double)tx[0].raw_value - tx[1].raw_value) * p)));
+
+    GTransform t;
+    gtransform_interpolate(&t, &from, &to, progress, GTransformInterpolationDecomposed);
+    prv_check_near(&t, &expected);
+  }
+
+  // Halfway through a half turn a linear blend collapses while a decomposed one keeps its size
+  const GTransform from = GTransformIdentity();
+  const GTransform to = GTransformRotation(TRIG_MAX_ANGLE / 2 - 2);
+  GTransform linear;
+  GTransform decomposed;
+  gtransform_interpolate(&linear, &from, &to, ANIMATION_NORMALIZED_MAX / 2,
+                         GTransformInterpolationLinear);
+  gtransform_interpolate(&decomposed, &from, &to, ANIMATION_NORMALIZED_MAX / 2,
+                         GTransformInterpolationDecomposed);
+  unit_check(abs(linear.a.raw_value) < 0x100);
+  GTransformDecomposition parts;
+  unit_check(gtransform_decompose(&parts, &decomposed));
+  unit_check_near(parts.sx.raw_value, 0x10000, 16);
+  unit_check_near(parts.angle, TRIG_MAX_ANGLE / 4 - 1, 2);
+}
+
+static void test_tweens(void) {
+  enum { NUM_TWEENS = 50 };
+  GTransformTween tweens[NUM_TWEENS];
+  AnimationProgress progress[NUM_TWEENS];
+  GTransform out[NUM_TWEENS];
+
+  for (int i = 0; i < NUM_TWEENS; i++) {
+    const GTransform from = unit_random_trs(0x4000, 0x40000, 200 * 0x10000);
+    const GTransform to = unit_random_trs(0x4000, 0x40000, 200 * 0x10000);
+    gtransform_tween_init(&tweens[i], &from, &to,
+                          (i % 2) ? GTransformInterpolationDecomposed :
+                                    GTransformInterpolationLinear);
+    progress[i] = unit_random(ANIMATION_NORMALIZED_MIN, ANIMATION_NORMALIZED_MAX);
+  }
+  progress[0] = ANIMATION_NORMALIZED_MIN;
+  progress[1] = ANIMATION_NORMALIZED_MAX;
+
+  gtransform_tween_evaluate_array(tweens, progress, out, NUM_TWEENS);
+  for (int i = 0; i < NUM_TWEENS; i++) {
+    GTransform expected;
+    gtransform_interpolate(&expected, &tweens[i].from, &tweens[i].to, progress[i],
+                           tweens[i].mode);
+    unit_check(gtransform_is_equal(&out[i], &expected));
+  }
+  unit_check(gtransform_is_equal(&out[0], &tweens[0].from));
+  unit_check(gtransform_is_equal(&out[1], &tweens[1].to));
+
+  // A matrix that cannot be decomposed makes the tween fall back to linear interpolation
+  const GTransform degenerate = GTransformScaleFromNumber(0, 0);
+  gtransform_tween_init(&tweens[0], &degenerate, &tweens[1].to,
+                        GTransformInterpolationDecomposed);
+  unit_check(tweens[0].mode == GTransformInterpolationLinear);
+}
+
+int main(void) {
+  unit_run(test_decompose);
+  unit_run(test_interpolate_linear);
+  unit_run(test_interpolate_decomposed);
+  unit_run(test_tweens);
+  return unit_report();
+}
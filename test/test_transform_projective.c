@@ -0,0 +1,297 @@
+#include <pebble.h>
+
+#include "gtransform_projective.h"
+#include "unit.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_RANDOM_POINTS 20000
+
+//////////////////////////////////////
+/// Double precision reference
+//////////////////////////////////////
+typedef struct RefProjective {
+  double m[3][3];
+} RefProjective;
+
+static RefProjective prv_ref_from_projective(const GTransformProjective *t) {
+  const double s = 1 << FIXED_S32_16_PRECISION;
+  const double p = 1 << FIXED_S32_24_PRECISION;
+  return (RefProjective) { {
+    { t->a.raw_value / s, t->b.raw_value / s, t->p.raw_value / p },
+    { t->c.raw_value / s, t->d.raw_value / s, t->q.raw_value / p },
+    { t->tx.raw_value / s, t->ty.raw_value / s, t->w.raw_value / p },
+  } };
+}
+
+static RefProjective prv_ref_concat(const RefProjective *t1, const RefProjective *t2) {
+  RefProjective t;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      t.m[i][j] = 0;
+      for (int k = 0; k < 3; k++) {
+        t.m[i][j] += t1->m[i][k] * t2->m[k][j];
+      }
+    }
+  }
+  return t;
+}
+
+// Returns false if the point is at or behind the eye
+static bool prv_ref_apply(const RefProjective *t, double x, double y, double *x_out,
+                          double *y_out) {
+  const double w = x * t->m[0][2] + y * t->m[1][2] + t->m[2][2];
+  *x_out = (x * t->m[0][0] + y * t->m[1][0] + t->m[2][0]) / w;
+  *y_out = (x * t->m[0][1] + y * t->m[1][1] + t->m[2][1]) / w;
+  return w > 0;
+}
+
+// Results are rounded down to 1/8 px, and the reciprocal may be one unit off on top of that
+static void prv_check_point(const GTransformProjective *t, GPointPrecise pointP) {
+  const RefProjective ref = prv_ref_from_projective(t);
+  double x;
+  double y;
+  const bool ref_in_front = prv_ref_apply(&ref, pointP.x.raw_value / 8.0,
+                                          pointP.y.raw_value / 8.0, &x, &y);
+  if (!ref_in_front || (fabs(x) > 4000) || (fabs(y) > 4000)) {
+    return;
+  }
+
+  GPointPrecise result;
+  unit_check(gpointprecise_transform_projective(&result, pointP, t));
+  unit_check((x * 8 - result.x.raw_value > -1.01) && (x * 8 - result.x.raw_value < 2.01));
+  unit_check((y * 8 - result.y.raw_value > -1.01) && (y * 8 - result.y.raw_value < 2.01));
+}
+
+static GTransformProjective prv_card(int32_t angle_x, int32_t angle_y, int distance) {
+  GTransformProjective tilt;
+  unit_check(gtransform_projective_init_tilt(&tilt, angle_x, angle_y,
+                                             GTransformNumberFromNumber(distance)));
+  const GTransform to_center = GTransformTranslationFromNumber(-72, -84);
+  const GTransform to_screen = GTransformTranslationFromNumber(72, 84);
+  GTransformProjective t;
+  gtransform_projective_compose(&t, &to_center, &tilt, &to_screen);
+  return t;
+}
+
+//////////////////////////////////////
+/// Tests
+//////////////////////////////////////
+static void test_affine(void) {
+  // Without a perspective column, points land where gpoint_transform puts them
+  for (int32_t angle = 0; angle < TRIG_MAX_ANGLE; angle += TRIG_MAX_ANGLE / 12) {
+    GTransform affine = GTransformRotation(angle);
+    gtransform_scale_number(&affine, &affine, 2, 1);
+    gtransform_translate_number(&affine, &affine, 72, 84);
+    GTransformProjective t;
+    gtransform_projective_from_gtransform(&t, &affine);
+
+    for (int i = 0; i < NUM_RANDOM_POINTS / 10; i++) {
+      const GPoint point = GPoint(unit_random(-300, 300), unit_random(-300, 300));
+      GPointPrecise result;
+      unit_check(gpoint_transform_projective(&result, point, &t));
+      const GPointPrecise expected = gpoint_transform(point, &affine);
+      unit_check(abs(result.x.raw_value - expected.x.raw_value) <= 2);
+      unit_check(abs(result.y.raw_value - expected.y.raw_value) <= 2);
+    }
+  }
+
+  GTransformProjective identity;
+  gtransform_projective_init_identity(&identity);
+  GPointPrecise result;
+  unit_check(gpoint_transform_projective(&result, GPoint(-17, 4000), &identity));
+  unit_check((result.x.raw_value == -17 * 8) && (result.y.raw_value == 4000 * 8));
+  unit_check(gpoint_transform_projective(&result, GPoint(5, 6), NULL));
+  unit_check((result.x.raw_value == 5 * 8) && (result.y.raw_value == 6 * 8));
+  unit_check(!gpoint_transform_projective(NULL, GPoint(5, 6), &identity));
+}
+
+static void test_reciprocal(void) {
+  // W from far below 1 to far above it, so every entry of the table and many exponents are hit
+  for (int i = 0; i < NUM_RANDOM_POINTS; i++) {
+    GTransformProjective t;
+    gtransform_projective_init_identity(&t);
+    t.w.raw_value = unit_random(1 << 18, 100 << FIXED_S32_24_PRECISION);
+    t.p.raw_value = unit_random(-(1 << 14), 1 << 14);
+    prv_check_point(&t, GPointPrecise(unit_random(-8000, 8000), unit_random(-8000, 8000)));
+  }
+}
+
+static void test_tilt(void) {
+  // Same as turning the plane in 3D and projecting it from the viewer's distance
+  const int32_t angles[][2] = {
+    { 0, 0 }, { 0, TRIG_MAX_ANGLE / 6 }, { TRIG_MAX_ANGLE / 8, 0 },
+    { -TRIG_MAX_ANGLE / 10, TRIG_MAX_ANGLE / 5 }, { TRIG_MAX_ANGLE / 3, -TRIG_MAX_ANGLE / 7 },
+  };
+  const double distance = 200;
+  for (size_t i = 0; i < ARRAY_LENGTH(angles); i++) {
+    GTransformProjective t;
+    unit_check(gtransform_projective_init_tilt(&t, angles[i][0], angles[i][1],
+                                               GTransformNumberFromNumber(distance)));
+    const double phi = angles[i][0] * 2 * M_PI / TRIG_MAX_ANGLE;
+    const double theta = angles[i][1] * 2 * M_PI / TRIG_MAX_ANGLE;
+
+    for (int y = -80; y <= 80; y += 8) {
+      for (int x = -70; x <= 70; x += 7) {
+        const double z1 = x * sin(theta);
+        const double x3 = x * cos(theta);
+        const double y3 = y * cos(phi) - z1 * sin(phi);
+        const double z3 = y * sin(phi) + z1 * cos(phi);
+        const double scale = distance / (distance + z3);
+
+        GPointPrecise result;
+        unit_check(gpoint_transform_projective(&result, GPoint(x, y), &t));
+        unit_check_near(result.x.raw_value / 8.0, x3 * scale, 0.3);
+        unit_check_near(result.y.raw_value / 8.0, y3 * scale, 0.3);
+      }
+    }
+
+    for (int j = 0; j < NUM_RANDOM_POINTS / 10; j++) {
+      prv_check_point(&t, GPointPrecise(unit_random(-1200, 1200), unit_random(-1200, 1200)));
+    }
+  }
+
+  GTransformProjective t;
+  unit_check(!gtransform_projective_init_tilt(&t, 0, 0, GTransformNumberZero));
+  unit_check(!gtransform_projective_init_tilt(NULL, 0, 0, GTransformNumberOne));
+}
+
+static void test_concat(void) {
+  const GTransformProjective card = prv_card(TRIG_MAX_ANGLE / 9, TRIG_MAX_ANGLE / 7, 150);
+  GTransformProjective tilt;
+  gtransform_projective_init_tilt(&tilt, -TRIG_MAX_ANGLE / 12, TRIG_MAX_ANGLE / 5,
+                                  GTransformNumberFromNumber(300));
+
+  GTransformProjective t;
+  gtransform_projective_concat(&t, &card, &tilt);
+  const RefProjective ref_card = prv_ref_from_projective(&card);
+  const RefProjective ref_tilt = prv_ref_from_projective(&tilt);
+  const RefProjective expected = prv_ref_concat(&ref_card, &ref_tilt);
+  const RefProjective actual = prv_ref_from_projective(&t);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      unit_check_near(actual.m[i][j], expected.m[i][j], 1e-4);
+    }
+  }
+
+  // Applying the concatenation is the same as applying both in turn
+  for (int i = 0; i < NUM_RANDOM_POINTS / 10; i++) {
+    const GPoint point = GPoint(unit_random(0, 144), unit_random(0, 168));
+    GPointPrecise once;
+    GPointPrecise twice;
+    gpoint_transform_projective(&once, point, &t);
+    gpoint_transform_projective(&twice, point, &card);
+    gpointprecise_transform_projective(&twice, twice, &tilt);
+    unit_check(abs(once.x.raw_value - twice.x.raw_value) <= 3);
+    unit_check(abs(once.y.raw_value - twice.y.raw_value) <= 3);
+  }
+
+  // t_new may alias either input
+  GTransformProjective aliased = card;
+  gtransform_projective_concat(&aliased, &aliased, &tilt);
+  unit_check(memcmp(&aliased, &t, sizeof(t)) == 0);
+  aliased = tilt;
+  gtransform_projective_concat(&aliased, &card, &aliased);
+  unit_check(memcmp(&aliased, &t, sizeof(t)) == 0);
+}
+
+static void test_compose(void) {
+  // Tilting around the center of the screen keeps the center in place and keeps the vertical
+  // axis of a card that turns around it, up to the rounding of the concatenation
+  const GTransformProjective t = prv_card(0, TRIG_MAX_ANGLE / 6, 200);
+  GPointPrecise result;
+  unit_check(gpoint_transform_projective(&result, GPoint(72, 84), &t));
+  unit_check((abs(result.x.raw_value - 72 * 8) <= 1) && (abs(result.y.raw_value - 84 * 8) <= 1));
+  unit_check(gpoint_transform_projective(&result, GPoint(72, 10), &t));
+  unit_check((abs(result.x.raw_value - 72 * 8) <= 1) && (abs(result.y.raw_value - 10 * 8) <= 1));
+
+  // The side that turns away gets shorter and the side that turns closer longer
+  GPointPrecise far_top;
+  GPointPrecise far_bottom;
+  GPointPrecise near_top;
+  GPointPrecise near_bottom;
+  gpoint_transform_projective(&far_top, GPoint(140, 20), &t);
+  gpoint_transform_projective(&far_bottom, GPoint(140, 148), &t);
+  gpoint_transform_projective(&near_top, GPoint(4, 20), &t);
+  gpoint_transform_projective(&near_bottom, GPoint(4, 148), &t);
+  unit_check(far_bottom.y.raw_value - far_top.y.raw_value < 128 * 8);
+  unit_check(near_bottom.y.raw_value - near_top.y.raw_value > 128 * 8);
+
+  // Without affine parts the projective matrix is copied
+  GTransformProjective copy;
+  gtransform_projective_compose(&copy, NULL, &t, NULL);
+  unit_check(memcmp(&copy, &t, sizeof(t)) == 0);
+}
+
+static void test_behind(void) {
+  // Turned by 80 degrees and seen from 50 px, points left of x = -50.8 are behind the eye
+  GTransformProjective t;
+  gtransform_projective_init_tilt(&t, 0, TRIG_MAX_ANGLE * 80 / 360,
+                                  GTransformNumberFromNumber(50));
+  GPointPrecise result;
+  unit_check(gpoint_transform_projective(&result, GPoint(-50, 10), &t));
+  unit_check(!gpoint_transform_projective(&result, GPoint(-52, 10), &t));
+  unit_check((result.x.raw_value == INT16_MIN) && (result.y.raw_value == INT16_MAX));
+
+  // Close to the eye, points run off to the edge of the range
+  unit_check(gpointprecise_transform_projective(&result, GPointPrecise(-406, -80), &t));
+  unit_check((result.x.raw_value == INT16_MIN) && (result.y.raw_value < -100 * 8));
+
+  GPoint points[] = { GPoint(-60, 0), GPoint(0, 0), GPoint(30, 5), GPoint(-51, 3) };
+  GPointPrecise out[ARRAY_LENGTH(points)];
+  unit_check(gpoint_transform_projective_array(points, out, ARRAY_LENGTH(points), &t) == 2);
+  for (size_t i = 0; i < ARRAY_LENGTH(points); i++) {
+    GPointPrecise expected;
+    gpoint_transform_projective(&expected, points[i], &t);
+    unit_check(gpointprecise_equal(&out[i], &expected));
+  }
+  unit_check(gpoint_transform_projective_array(points, out, ARRAY_LENGTH(points), NULL) ==
+             ARRAY_LENGTH(points));
+  unit_check((out[2].x.raw_value == 30 * 8) && (out[2].y.raw_value == 5 * 8));
+}
+
+static void test_iterator(void) {
+  // Pixel centers of every row of the screen under a turned card: exact every span and within
+  // three quarters of a pixel in between, the most being at the corners
+  const GTransformProjective t = prv_card(TRIG_MAX_ANGLE / 12, TRIG_MAX_ANGLE / 6, 200);
+  double max_error = 0;
+  for (int y = 0; y < 168; y++) {
+    const GPointPrecise start = GPointPrecise(4, y * 8 + 4);
+    GTransformProjectiveIterator iter;
+    gtransform_projective_iter_begin(&iter, &t, start);
+
+    for (int x = 0; x < 144; x++, gtransform_projective_iter_next(&iter)) {
+      const GPointPrecise pointP = gtransform_projective_iter_get_point(&iter);
+      GPointPrecise exact;
+      gpointprecise_transform_projective(&exact, GPointPrecise(x * 8 + 4, y * 8 + 4), &t);
+      if ((x % GTRANSFORM_PROJECTIVE_SPAN) == 0) {
+        unit_check(gpointprecise_equal(&pointP, &exact));
+      }
+      const double error = fmax(abs(pointP.x.raw_value - exact.x.raw_value),
+                                abs(pointP.y.raw_value - exact.y.raw_value)) / 8.0;
+      max_error = fmax(max_error, error);
+    }
+  }
+  unit_check(max_error < 0.75);
+
+  // Without a matrix the pixels are only stepped through
+  GTransformProjectiveIterator iter;
+  gtransform_projective_iter_begin(&iter, NULL, GPointPrecise(-24, 80));
+  for (int x = 0; x < 40; x++) {
+    gtransform_projective_iter_next(&iter);
+  }
+  const GPointPrecise pointP = gtransform_projective_iter_get_point(&iter);
+  unit_check((pointP.x.raw_value == -24 + 40 * 8) && (pointP.y.raw_value == 80));
+}
+
+int main(void) {
+  unit_run(test_affine);
+  unit_run(test_reciprocal);
+  unit_run(test_tilt);
+  unit_run(test_concat);
+  unit_run(test_compose);
+  unit_run(test_behind);
+  unit_run(test_iterator);
+  return unit_report();
+}
@@ -0,0 +1,242 @@
+#include <pebble.h>
+
+#include "gtransform_timeline.h"
+#include "unit.h"
+
+#define NUM_RANDOM_KEYS 200
+#define NUM_TRACKS 300
+
+static GTransformKeyframe s_random_keys[NUM_RANDOM_KEYS];
+
+static GTransformKeyframe prv_key(uint32_t time, int32_t scale, int32_t angle, int32_t tx,
+                                  int32_t ty, GTransformEasing easing) {
+  return (GTransformKeyframe) {
+    .time = time,
+    .sx = Fixed_S32_16(scale * 0x10000),
+    .sy = Fixed_S32_16(scale * 0x10000),
+    .angle = angle,
+    .tx = Fixed_S32_16(tx * 0x10000),
+    .ty = Fixed_S32_16(ty * 0x10000),
+    .easing = easing,
+  };
+}
+
+static GTransform prv_key_transform(const GTransformKeyframe *key) {
+  return GTransformTRS(key->sx, key->sy, key->angle, key->tx, key->ty);
+}
+
+// Keys at random intervals, some of them at the same time
+static void prv_init_random_keys(void) {
+  uint32_t time = 100;
+  for (int i = 0; i < NUM_RANDOM_KEYS; i++) {
+    s_random_keys[i] = (GTransformKeyframe) {
+      .time = time,
+      .sx = Fixed_S32_16(unit_random(0x4000, 0x40000)),
+      .sy = Fixed_S32_16(unit_random(0x4000, 0x40000)),
+      .angle = unit_random(-2 * TRIG_MAX_ANGLE, 2 * TRIG_MAX_ANGLE),
+      .tx = Fixed_S32_16(unit_random(-200 * 0x10000, 200 * 0x10000)),
+      .ty = Fixed_S32_16(unit_random(-200 * 0x10000, 200 * 0x10000)),
+      .easing = unit_random(GTransformEasingHold, GTransformEasingEaseInOut),
+    };
+    time += (i % 10 == 5) ? 0 : unit_random(1, 500);
+  }
+}
+
+//////////////////////////////////////
+/// Tests
+//////////////////////////////////////
+static void test_init(void) {
+  const GTransformKeyframe keys[] = {
+    prv_key(0, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(100, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(100, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(50, 1, 0, 0, 0, GTransformEasingLinear),
+  };
+  GTransformTrack track;
+  unit_check(gtransform_track_init(&track, keys, 3, false));
+  unit_check((track.num_keys == 3) && (track.cursor == 0) && !track.loop);
+
+  // Keys must be sorted and there must be at least one
+  unit_check(!gtransform_track_init(&track, keys, 4, false));
+  unit_check(!gtransform_track_init(&track, keys, 0, false));
+  unit_check(!gtransform_track_init(&track, NULL, 3, false));
+  unit_check(!gtransform_track_init(NULL, keys, 3, false));
+}
+
+static void test_keys(void) {
+  const GTransformKeyframe keys[] = {
+    prv_key(1000, 1, 0, 10, 20, GTransformEasingLinear),
+    prv_key(2000, 2, TRIG_MAX_ANGLE / 4, -30, 40, GTransformEasingEaseIn),
+    prv_key(3000, 3, TRIG_MAX_ANGLE / 2, 50, -60, GTransformEasingLinear),
+  };
+  GTransformTrack track;
+  gtransform_track_init(&track, keys, ARRAY_LENGTH(keys), false);
+
+  // Keys are reached exactly, and the track holds its ends outside of them
+  GTransform t;
+  for (size_t i = 0; i < ARRAY_LENGTH(keys); i++) {
+    const GTransform expected = prv_key_transform(&keys[i]);
+    gtransform_track_evaluate(&track, keys[i].time, &t);
+    unit_check(gtransform_is_equal(&t, &expected));
+  }
+  const GTransform first = prv_key_transform(&keys[0]);
+  const GTransform last = prv_key_transform(&keys[2]);
+  gtransform_track_evaluate(&track, 0, &t);
+  unit_check(gtransform_is_equal(&t, &first));
+  gtransform_track_evaluate(&track, 100000, &t);
+  unit_check(gtransform_is_equal(&t, &last));
+
+  // Halfway along a linear segment every component is halfway
+  gtransform_track_evaluate(&track, 1500, &t);
+  const GTransform halfway = GTransformTRS(Fixed_S32_16(0x18000), Fixed_S32_16(0x18000),
+                                           TRIG_MAX_ANGLE / 8, Fixed_S32_16(-10 * 0x10000),
+                                           Fixed_S32_16(30 * 0x10000));
+  unit_check_near(t.a.raw_value / 65536.0, halfway.a.raw_value / 65536.0, 0.001);
+  unit_check_near(t.b.raw_value / 65536.0, halfway.b.raw_value / 65536.0, 0.001);
+  unit_check_near(t.tx.raw_value / 65536.0, -10, 0.0001);
+  unit_check_near(t.ty.raw_value / 65536.0, 30, 0.0001);
+
+  // A track of one key always returns that key
+  gtransform_track_init(&track, keys, 1, true);
+  gtransform_track_evaluate(&track, 123456, &t);
+  unit_check(gtransform_is_equal(&t, &first));
+}
+
+static void test_easing(void) {
+  GTransformKeyframe keys[] = {
+    prv_key(0, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(1000, 1, 0, 1000, 0, GTransformEasingLinear),
+  };
+  GTransformTrack track;
+  gtransform_track_init(&track, keys, ARRAY_LENGTH(keys), false);
+
+  // Translation along x follows the curve, as 1000 px over 1000 ms
+  const struct {
+    GTransformEasing easing;
+    double expected[3];
+  } cases[] = {
+    { GTransformEasingHold, { 0, 0, 0 } },
+    { GTransformEasingLinear, { 250, 500, 750 } },
+    { GTransformEasingEaseIn, { 62.5, 250, 562.5 } },
+    { GTransformEasingEaseOut, { 437.5, 750, 937.5 } },
+    { GTransformEasingEaseInOut, { 156.25, 500, 843.75 } },
+  };
+  for (size_t i = 0; i < ARRAY_LENGTH(cases); i++) {
+    keys[0].easing = cases[i].easing;
+    GTransform t;
+    for (int q = 1; q <= 3; q++) {
+      gtransform_track_evaluate(&track, q * 250, &t);
+      unit_check_near(t.tx.raw_value / 65536.0, cases[i].expected[q - 1], 0.001);
+    }
+    gtransform_track_evaluate(&track, 1000, &t);
+    unit_check(t.tx.raw_value == 1000 * 0x10000);
+  }
+}
+
+static void test_cursor(void) {
+  prv_init_random_keys();
+  const uint32_t end = s_random_keys[NUM_RANDOM_KEYS - 1].time;
+
+  // Playing forward and seeking at random give the same results as a fresh track
+  GTransformTrack forward;
+  GTransformTrack seeking;
+  GTransformTrack fresh;
+  gtransform_track_init(&forward, s_random_keys, NUM_RANDOM_KEYS, false);
+  gtransform_track_init(&seeking, s_random_keys, NUM_RANDOM_KEYS, false);
+  for (uint32_t time = 0; time < end + 100; time += 7) {
+    const uint32_t seek = unit_random(0, end + 100);
+    GTransform expected;
+    GTransform t;
+
+    gtransform_track_init(&fresh, s_random_keys, NUM_RANDOM_KEYS, false);
+    gtransform_track_evaluate(&fresh, time, &expected);
+    gtransform_track_evaluate(&forward, time, &t);
+    unit_check(gtransform_is_equal(&t, &expected));
+
+    gtransform_track_init(&fresh, s_random_keys, NUM_RANDOM_KEYS, false);
+    gtransform_track_evaluate(&fresh, seek, &expected);
+    gtransform_track_evaluate(&seeking, seek, &t);
+    unit_check(gtransform_is_equal(&t, &expected));
+  }
+
+  // The cursor is on the last key at or before the time, the later one of keys at the same time
+  gtransform_track_evaluate(&forward, s_random_keys[5].time, &(GTransform) { 0 });
+  unit_check(forward.cursor == 6);
+  gtransform_track_evaluate(&forward, s_random_keys[7].time + 1, &(GTransform) { 0 });
+  unit_check(forward.cursor == 7);
+}
+
+static void test_jump(void) {
+  // Two keys at the same time make the track jump
+  const GTransformKeyframe keys[] = {
+    prv_key(0, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(100, 1, 0, 100, 0, GTransformEasingLinear),
+    prv_key(100, 1, 0, -100, 0, GTransformEasingLinear),
+    prv_key(200, 1, 0, 0, 0, GTransformEasingLinear),
+  };
+  GTransformTrack track;
+  gtransform_track_init(&track, keys, ARRAY_LENGTH(keys), false);
+
+  GTransform t;
+  gtransform_track_evaluate(&track, 99, &t);
+  unit_check_near(t.tx.raw_value / 65536.0, 99, 0.01);
+  gtransform_track_evaluate(&track, 100, &t);
+  unit_check(t.tx.raw_value == -100 * 0x10000);
+  gtransform_track_evaluate(&track, 150, &t);
+  unit_check_near(t.tx.raw_value / 65536.0, -50, 0.01);
+}
+
+static void test_loop(void) {
+  // A full turn every second; the last key matches the first, so the loop is seamless
+  const GTransformKeyframe keys[] = {
+    prv_key(0, 1, 0, 0, 0, GTransformEasingLinear),
+    prv_key(1000, 1, TRIG_MAX_ANGLE, 0, 0, GTransformEasingLinear),
+  };
+  GTransformTrack track;
+  gtransform_track_init(&track, keys, ARRAY_LENGTH(keys), true);
+
+  for (uint32_t time = 0; time < 5000; time += 13) {
+    GTransform t;
+    gtransform_track_evaluate(&track, time, &t);
+    const GTransform expected = GTransformRotationCached((time % 1000) * TRIG_MAX_ANGLE / 1000);
+    unit_check_near(t.a.raw_value, expected.a.raw_value, 8);
+    unit_check_near(t.b.raw_value, expected.b.raw_value, 8);
+  }
+}
+
+static void test_array(void) {
+  prv_init_random_keys();
+
+  // Every track plays its own window of the random keys
+  static GTransformTrack tracks[NUM_TRACKS];
+  static GTransform t_out[NUM_TRACKS];
+  for (int i = 0; i < NUM_TRACKS; i++) {
+    const int first = i % (NUM_RANDOM_KEYS - 10);
+    gtransform_track_init(&tracks[i], &s_random_keys[first], 10, (i % 2) == 0);
+  }
+
+  for (uint32_t time = 0; time < 5000; time += 33) {
+    gtransform_track_evaluate_array(tracks, time, t_out, NUM_TRACKS);
+    for (int i = 0; i < NUM_TRACKS; i += 17) {
+      GTransformTrack fresh;
+      GTransform expected;
+      gtransform_track_init(&fresh, tracks[i].keys, tracks[i].num_keys, tracks[i].loop);
+      gtransform_track_evaluate(&fresh, time, &expected);
+      unit_check(gtransform_is_equal(&t_out[i], &expected));
+    }
+  }
+
+  gtransform_track_evaluate_array(NULL, 0, t_out, NUM_TRACKS);
+  gtransform_track_evaluate_array(tracks, 0, NULL, NUM_TRACKS);
+}
+
+int main(void) {
+  unit_run(test_init);
+  unit_run(test_keys);
+  unit_run(test_easing);
+  unit_run(test_cursor);
+  unit_run(test_jump);
+  unit_run(test_loop);
+  unit_run(test_array);
+  return unit_report();
+}
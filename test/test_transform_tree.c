@@ -0,0 +1,109 @@
+#include <pebble.h>
+
+#include "gtransform_tree.h"
+#include "unit.h"
+
+#define NUM_NODES 32
+
+static GTransformNode s_nodes[NUM_NODES];
+
+// Recomputes the world matrix of a node from scratch by recursing up to the root
+static GTransform prv_world_from_scratch(const GTransformTree *tree, int16_t node) {
+  GTransform world = tree->nodes[node].local;
+  if (tree->nodes[node].parent != GTRANSFORM_TREE_NO_PARENT) {
+    GTransform parent_world = prv_world_from_scratch(tree, tree->nodes[node].parent);
+    gtransform_concat(&world, &world, &parent_world);
+  }
+  return world;
+}
+
+static void test_add_node(void) {
+  GTransformTree tree;
+  gtransform_tree_init(&tree, s_nodes, 2);
+
+  GTransform t = GTransformTranslationFromNumber(1, 2);
+  int16_t root = gtransform_tree_add_node(&tree, GTRANSFORM_TREE_NO_PARENT, &t);
+  unit_check(root == 0);
+  // Parents must already exist
+  unit_check(gtransform_tree_add_node(&tree, 5, NULL) == GTRANSFORM_TREE_NO_PARENT);
+  int16_t child = gtransform_tree_add_node(&tree, root, NULL);
+  unit_check(child == 1);
+  // Capacity is respected
+  unit_check(gtransform_tree_add_node(&tree, root, NULL) == GTRANSFORM_TREE_NO_PARENT);
+
+  unit_check(gtransform_tree_get_world(&tree, 2) == NULL);
+  unit_check(gtransform_tree_edit_local(&tree, -1) == NULL);
+
+  gtransform_tree_update(&tree);
+  unit_check(gtransform_is_equal(gtransform_tree_get_world(&tree, root), &t));
+  unit_check(gtransform_is_equal(gtransform_tree_get_world(&tree, child), &t));
+}
+
+static void test_update_matches_scratch(void) {
+  GTransformTree tree;
+  gtransform_tree_init(&tree, s_nodes, NUM_NODES);
+
+  for (int i = 0; i < NUM_NODES; i++) {
+    int16_t parent = (i == 0) ? GTRANSFORM_TREE_NO_PARENT : unit_random(-1, i - 1);
+    GTransform t = unit_random_trs(0x8000, 0x18000, 100 * 0x10000);
+    unit_check(gtransform_tree_add_node(&tree, parent, &t) == i);
+  }
+
+  // Update more than 256 times so that the update counter wraps around
+  for (int frame = 0; frame < 300; frame++) {
+    const int num_changes = unit_random(0, 3);
+    for (int i = 0; i < num_changes; i++) {
+      GTransform t = unit_random_trs(0x8000, 0x18000, 100 * 0x10000);
+      int16_t node = unit_random(0, NUM_NODES - 1);
+      if (i % 2) {
+        gtransform_tree_set_local(&tree, node, &t);
+      } else {
+        *gtransform_tree_edit_local(&tree, node) = t;
+      }
+    }
+
+    gtransform_tree_update(&tree);
+
+    for (int16_t node = 0; node < NUM_NODES; node++) {
+      GTransform expected = prv_world_from_scratch(&tree, node);
+      unit_check(gtransform_is_equal(gtransform_tree_get_world(&tree, node), &expected));
+      unit_check(!tree.nodes[node].dirty);
+    }
+  }
+}
+
+static void test_only_dirty_subtrees_update(void) {
+  GTransformTree tree;
+  gtransform_tree_init(&tree, s_nodes, NUM_NODES);
+
+  GTransform t = GTransformTranslationFromNumber(10, 0);
+  int16_t root = gtransform_tree_add_node(&tree, GTRANSFORM_TREE_NO_PARENT, &t);
+  int16_t left = gtransform_tree_add_node(&tree, root, &t);
+  int16_t right = gtransform_tree_add_node(&tree, root, &t);
+  int16_t left_child = gtransform_tree_add_node(&tree, left, &t);
+  gtransform_tree_update(&tree);
+
+  // Setting an unchanged matrix does not cause any work
+  gtransform_tree_set_local(&tree, left, &t);
+  unit_check(!tree.nodes[left].dirty);
+
+  t = GTransformTranslationFromNumber(0, 5);
+  gtransform_tree_set_local(&tree, left, &t);
+  const uint8_t update = tree.update_count + 1;
+  gtransform_tree_update(&tree);
+
+  unit_check(tree.nodes[root].world_update != update);
+  unit_check(tree.nodes[left].world_update == update);
+  unit_check(tree.nodes[right].world_update != update);
+  unit_check(tree.nodes[left_child].world_update == update);
+
+  GTransform expected = GTransformTranslationFromNumber(20, 5);
+  unit_check(gtransform_is_equal(gtransform_tree_get_world(&tree, left_child), &expected));
+}
+
+int main(void) {
+  unit_run(test_add_node);
+  unit_run(test_update_matches_scratch);
+  unit_run(test_only_dirty_subtrees_update);
+  return unit_report();
+}
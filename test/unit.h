@@ -0,0 +1,109 @@
+#pragma once
+
+//! Minimal assertion and random input helpers shared by the host test programs. Each test
+//! program includes this header once, runs its tests with unit_run and returns unit_report()
+//! from main.
+
+#include <pebble.h>
+
+#include "gbitmap_pixel.h"
+#include "gtransform.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Only the first few failures of a check are printed so an exhaustive loop cannot flood the log
+#define UNIT_MAX_REPORTED_FAILURES 10
+
+static int s_unit_checks;
+static int s_unit_failures;
+
+#define unit_check(cond)                                                                 \
+  do {                                                                                   \
+    s_unit_checks++;                                                                     \
+    if (!(cond)) {                                                                       \
+      if (s_unit_failures++ < UNIT_MAX_REPORTED_FAILURES) {                              \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+      }                                                                                  \
+    }                                                                                    \
+  } while (0)
+
+#define unit_check_near(actual, expected, tolerance)                                     \
+  do {                                                                                   \
+    const double unit_actual_ = (double)(actual);                                        \
+    const double unit_expected_ = (double)(expected);                                    \
+    s_unit_checks++;                                                                     \
+    if (fabs(unit_actual_ - unit_expected_) > (tolerance)) {                             \
+      if (s_unit_failures++ < UNIT_MAX_REPORTED_FAILURES) {                              \
+        fprintf(stderr, "%s:%d: %s = %f, expected %f (tolerance %f)\n", __FILE__, __LINE__, \
+                #actual, unit_actual_, unit_expected_, (double)(tolerance));             \
+      }                                                                                  \
+    }                                                                                    \
+  } while (0)
+
+#define unit_run(test)                                                                   \
+  do {                                                                                   \
+    const int unit_failures_before_ = s_unit_failures;                                   \
+    test();                                                                              \
+    printf("%s %s\n", (s_unit_failures == unit_failures_before_) ? "PASS" : "FAIL", #test); \
+  } while (0)
+
+static __inline__ int unit_report(void) {
+  printf("%d checks, %d failures\n", s_unit_checks, s_unit_failures);
+  return (s_unit_failures == 0) ? 0 : 1;
+}
+
+//! Deterministic pseudo random generator so that results do not depend on the host libc
+static uint32_t s_unit_seed = 0x12345678;
+
+static __inline__ int32_t unit_random(int32_t min, int32_t max) {
+  s_unit_seed = s_unit_seed * 1664525 + 1013904223;
+  return min + (int32_t)((s_unit_seed >> 8) % (uint32_t)(max - min + 1));
+}
+
+//! Returns a matrix with every coefficient of the 2x2 part in [-coefficient_range,
+//! coefficient_range] and every translation in [-translation_range, translation_range], both
+//! in raw GTransformNumber units
+static __inline__ GTransform unit_random_transform(int32_t coefficient_range,
+                                                   int32_t translation_range) {
+  GTransform t;
+  t.a = Fixed_S32_16(unit_random(-coefficient_range, coefficient_range));
+  t.b = Fixed_S32_16(unit_random(-coefficient_range, coefficient_range));
+  t.c = Fixed_S32_16(unit_random(-coefficient_range, coefficient_range));
+  t.d = Fixed_S32_16(unit_random(-coefficient_range, coefficient_range));
+  t.tx = Fixed_S32_16(unit_random(-translation_range, translation_range));
+  t.ty = Fixed_S32_16(unit_random(-translation_range, translation_range));
+  return t;
+}
+
+//! Returns a scale, rotation and translation matrix with both scales in [min_scale, max_scale]
+//! and both translations in [-translation_range, translation_range], in raw GTransformNumber
+//! units
+static __inline__ GTransform unit_random_trs(int32_t min_scale, int32_t max_scale,
+                                             int32_t translation_range) {
+  const GTransformNumber sx = Fixed_S32_16(unit_random(min_scale, max_scale));
+  const GTransformNumber sy = Fixed_S32_16(unit_random(min_scale, max_scale));
+  const int32_t angle = unit_random(0, TRIG_MAX_ANGLE - 1);
+  const GTransformNumber tx = Fixed_S32_16(unit_random(-translation_range, translation_range));
+  const GTransformNumber ty = Fixed_S32_16(unit_random(-translation_range, translation_range));
+  return GTransformTRS(sx, sy, angle, tx, ty);
+}
+
+//! Converts a GTransformNumber to a double for comparisons against reference math
+static __inline__ double unit_number(GTransformNumber n) {
+  return (double)n.raw_value / GTransformNumberOne.raw_value;
+}
+
+//! Reads pixel (x, y) of a 1-bit or 8-bit bitmap
+static __inline__ uint8_t unit_get_pixel(const GBitmap *bitmap, int x, int y) {
+  const uint8_t *row = gbitmap_get_data(bitmap) + y * gbitmap_get_bytes_per_row(bitmap);
+  if (gbitmap_get_format(bitmap) == GBitmapFormat1Bit) {
+    return gbitmap_pixel_get_1bit(row, x);
+  }
+  return row[x];
+}